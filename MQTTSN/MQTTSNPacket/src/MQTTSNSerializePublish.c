@@ -39,20 +39,21 @@ int MQTTSNSerialize_publishLength(int payloadlen, MQTTSN_topicid topic, int qos)
 
 
 /**
-  * Serializes the supplied publish data into the supplied buffer, ready for sending
-  * @param buf the buffer into which the packet will be serialized
+  * Serializes the header of a publish packet, that is everything but the payload, into the supplied buffer.
+  * The payload is expected to follow the header directly, so it can be written by the caller straight
+  * into its own transmit buffer without being copied into buf first.
+  * @param buf the buffer into which the packet header will be serialized
   * @param buflen the length in bytes of the supplied buffer
   * @param dup integer - the MQTT dup flag
   * @param qos integer - the MQTT QoS value
   * @param retained integer - the MQTT retained flag
   * @param packetid integer - the MQTT packet identifier
   * @param topic MQTTSN_topicid - the MQTT topic in the publish
-  * @param payload byte buffer - the MQTT publish payload
-  * @param payloadlen integer - the length of the MQTT payload
-  * @return the length of the serialized data.  <= 0 indicates error
+  * @param payloadlen integer - the length of the MQTT payload that will follow the header
+  * @return the length of the serialized header.  <= 0 indicates error
   */
-int MQTTSNSerialize_publish(unsigned char* buf, int buflen, unsigned char dup, int qos, unsigned char retained, unsigned short packetid,
-		MQTTSN_topicid topic, unsigned char* payload, int payloadlen)
+int MQTTSNSerialize_publishHeader(unsigned char* buf, int buflen, unsigned char dup, int qos, unsigned char retained,
+		unsigned short packetid, MQTTSN_topicid topic, int payloadlen)
 {
 	unsigned char *ptr = buf;
 	MQTTSNFlags flags;
@@ -60,7 +61,7 @@ int MQTTSNSerialize_publish(unsigned char* buf, int buflen, unsigned char dup, i
 	int rc = 0;
 
 	FUNC_ENTRY;
-	if ((len = MQTTSNPacket_len(MQTTSNSerialize_publishLength(payloadlen, topic, qos))) > buflen)
+	if ((len = MQTTSNPacket_len(MQTTSNSerialize_publishLength(payloadlen, topic, qos))) - payloadlen > buflen)
 	{
 		rc = MQTTSNPACKET_BUFFER_TOO_SHORT;
 		goto exit;
@@ -93,6 +94,40 @@ int MQTTSNSerialize_publish(unsigned char* buf, int buflen, unsigned char dup, i
 		memcpy(ptr, topic.data.long_.name, topic.data.long_.len);
 		ptr += topic.data.long_.len;
 	}
+
+	rc = ptr - buf;
+exit:
+	FUNC_EXIT_RC(rc);
+	return rc;
+}
+
+
+/**
+  * Serializes the supplied publish data into the supplied buffer, ready for sending
+  * @param buf the buffer into which the packet will be serialized
+  * @param buflen the length in bytes of the supplied buffer
+  * @param dup integer - the MQTT dup flag
+  * @param qos integer - the MQTT QoS value
+  * @param retained integer - the MQTT retained flag
+  * @param packetid integer - the MQTT packet identifier
+  * @param topic MQTTSN_topicid - the MQTT topic in the publish
+  * @param payload byte buffer - the MQTT publish payload
+  * @param payloadlen integer - the length of the MQTT payload
+  * @return the length of the serialized data.  <= 0 indicates error
+  */
+int MQTTSNSerialize_publish(unsigned char* buf, int buflen, unsigned char dup, int qos, unsigned char retained, unsigned short packetid,
+		MQTTSN_topicid topic, unsigned char* payload, int payloadlen)
+{
+	unsigned char *ptr = buf;
+	int rc = 0;
+
+	FUNC_ENTRY;
+	if (MQTTSNPacket_len(MQTTSNSerialize_publishLength(payloadlen, topic, qos)) > buflen)
+	{
+		rc = MQTTSNPACKET_BUFFER_TOO_SHORT;
+		goto exit;
+	}
+	ptr += MQTTSNSerialize_publishHeader(ptr, buflen, dup, qos, retained, packetid, topic, payloadlen);
 	memcpy(ptr, payload, payloadlen);
 	ptr += payloadlen;
 
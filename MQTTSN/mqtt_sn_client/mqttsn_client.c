@@ -46,32 +46,16 @@
 #include "nrf_assert.h"
 #include "nrf_error.h"
 #include "nrf_log.h"
+#include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
 
-/**@brief Stores whether a gateway discovery procedure has started. */
-static bool m_gateway_discovery_started;
-
 #define NULL_PARAM_CHECK(PARAM)                                                                    \
     if ((PARAM) == NULL)                                                                           \
     {                                                                                              \
         return (NRF_ERROR_NULL);                                                                   \
     }
 
-/**@brief Checks if timer has already passed a scheduled event timeout.  
- *
- * @param[in]    timeout     Scheduled event timeout.
- * @param[in]    now         Current timer value.
- *
- * @retval       true        If the scheduled event timeout has passed.
- * @retval       false       Otherwise.
- */
-static inline bool is_earlier(uint32_t timeout, uint32_t now)
-{
-    return ((timeout & mqttsn_platform_timer_resolution_get()) <=
-            (now & mqttsn_platform_timer_resolution_get()));
-}
-
 /**@brief Checks if MQTT-SN client has been initialized. 
  *
  * @param[in]    p_client    Pointer to MQTT-SN client instance.
@@ -174,13 +158,12 @@ static void message_retransmission_attempt(mqttsn_client_t * p_client, uint8_t i
         memset(&evt, 0, sizeof(mqttsn_event_t)); 
         evt.event_id                  = MQTTSN_EVENT_TIMEOUT;
         evt.event_data.error.error    = MQTTSN_ERROR_TIMEOUT;
-        evt.event_data.error.msg_type =
-            mqttsn_packet_msgtype_error_get(p_client->packet_queue.packet[index].p_data);
+        evt.event_data.error.msg_type = mqttsn_packet_error_get(&(p_client->packet_queue.packet[index]));
         evt.event_data.error.msg_id   = p_client->packet_queue.packet[index].id;
 
         uint32_t err_code = NRF_SUCCESS;
 
-        switch (mqttsn_packet_msgtype_error_get(p_client->packet_queue.packet[index].p_data))
+        switch (evt.event_data.error.msg_type)
         {
             case MQTTSN_PACKET_CONNACK:
                 err_code = mqttsn_packet_fifo_elem_dequeue(p_client,
@@ -223,12 +206,12 @@ static void message_retransmission_attempt(mqttsn_client_t * p_client, uint8_t i
     else
     {
         --(p_client->packet_queue.packet[index].retransmission_cnt);
-        p_client->packet_queue.packet[index].timeout =
-            mqttsn_platform_timer_set_in_ms(MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS);
+        p_client->packet_queue.packet[index].timeout = mqttsn_platform_timer_set_in_ms(
+            mqttsn_rtt_retransmission_time_get(p_client, p_client->packet_queue.packet[index].retransmission_cnt));
+        mqttsn_timer_queue_set(p_client, index, p_client->packet_queue.packet[index].timeout);
         uint32_t err_code = mqttsn_packet_sender_retransmit(p_client,
                                                             &(p_client->gateway_info.addr),
-                                                            p_client->packet_queue.packet[index].p_data,
-                                                            p_client->packet_queue.packet[index].len);
+                                                            &(p_client->packet_queue.packet[index]));
         if (err_code != NRF_SUCCESS)
         {
             NRF_LOG_ERROR("Retransmission attempt failed. Error code: 0x%x\r\n", err_code);
@@ -269,11 +252,16 @@ static void keep_alive_transmission_attempt(mqttsn_client_t * p_client)
         }
 
         --(p_client->keep_alive.message.retransmission_cnt);
-        p_client->keep_alive.timeout = mqttsn_platform_timer_set_in_ms(MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS);
+        if (p_client->keep_alive.message.retransmission_cnt == MQTTSN_DEFAULT_RETRANSMISSION_CNT)
+        {
+            p_client->keep_alive.message.sent = mqttsn_platform_timer_cnt_get();
+        }
+        p_client->keep_alive.timeout = mqttsn_platform_timer_set_in_ms(
+            mqttsn_rtt_retransmission_time_get(p_client, p_client->keep_alive.message.retransmission_cnt));
+        mqttsn_timer_queue_set(p_client, MQTTSN_TIMER_KEEP_ALIVE, p_client->keep_alive.timeout);
         uint32_t err_code = mqttsn_packet_sender_retransmit(p_client,
                                                             &(p_client->gateway_info.addr),
-                                                            p_client->keep_alive.message.p_data,
-                                                            p_client->keep_alive.message.len);
+                                                            &(p_client->keep_alive.message));
         if (err_code != NRF_SUCCESS)
         {
             NRF_LOG_ERROR("Retransmission attempt failed. Error code: 0x%x\r\n", err_code);
@@ -432,6 +420,40 @@ void mqttsn_client_state_update(mqttsn_client_t * p_client, client_state_fsm_eve
             }
         }
     }
+
+    mqttsn_client_poll_period_update(p_client);
+}
+
+void mqttsn_client_poll_period_update(mqttsn_client_t * p_client)
+{
+    uint32_t poll_period;
+
+    switch (p_client->client_state)
+    {
+        case MQTTSN_CLIENT_ASLEEP:
+            /* Messages sent while asleep are acknowledged like buffered ones: poll until they are. */
+            poll_period = ((p_client->packet_queue.num_of_elements > 0) ||
+                           (p_client->packet_queue.backlog_count > 0)) ?
+                          MQTTSN_FAST_POLL_PERIOD_IN_MS : p_client->keep_alive.duration;
+            break;
+
+        case MQTTSN_CLIENT_AWAKE:
+        case MQTTSN_CLIENT_WAITING_FOR_SLEEP:
+            poll_period = MQTTSN_FAST_POLL_PERIOD_IN_MS;
+            break;
+
+        default:
+            poll_period = 0;
+            break;
+    }
+
+    if (poll_period != p_client->poll_period)
+    {
+        if (mqttsn_transport_poll_period_set(p_client, poll_period) == NRF_SUCCESS)
+        {
+            p_client->poll_period = poll_period;
+        }
+    }
 }
 
 mqttsn_client_state_t mqttsn_client_state_get(mqttsn_client_t * p_client)
@@ -450,6 +472,12 @@ uint32_t mqttsn_client_init(mqttsn_client_t           * p_client,
 
     uint32_t err_code = NRF_SUCCESS;
     mqttsn_packet_fifo_init(p_client);
+    mqttsn_timer_queue_init(p_client);
+    mqttsn_rtt_init(p_client);
+    memset(&p_client->batch, 0, sizeof(mqttsn_batch_t));
+    memset(&p_client->qos2_received, 0, sizeof(mqttsn_qos2_received_t));
+    mqttsn_topic_registry_init(p_client);
+    p_client->poll_period = 0;
 
     if (nrf_mem_init()!= NRF_SUCCESS)
     {
@@ -463,9 +491,10 @@ uint32_t mqttsn_client_init(mqttsn_client_t           * p_client,
         return NRF_ERROR_INTERNAL;
     }
 
-    if (mqttsn_platform_init() != NRF_SUCCESS)
+    if (mqttsn_platform_init(p_client) != NRF_SUCCESS)
     {
         NRF_LOG_ERROR("Platform failed to initialize\r\n");
+        (void)mqttsn_transport_uninit(p_client);
         return NRF_ERROR_INTERNAL;
     }
 
@@ -504,6 +533,19 @@ uint32_t mqttsn_client_connect(mqttsn_client_t      * p_client,
         return NRF_ERROR_INVALID_STATE;
     }
 
+    /* Round-trip time measured for another gateway does not apply. */
+    if ((p_client->gateway_info.id != gateway_id) ||
+        (memcmp(&(p_client->gateway_info.addr), p_remote, sizeof(p_client->gateway_info.addr)) != 0))
+    {
+        mqttsn_rtt_init(p_client);
+    }
+
+    /* Topic IDs are assigned by the gateway; gateway ID 0 marks a registry that has not been loaded. */
+    if (p_client->topic_registry.gateway_id != gateway_id)
+    {
+        mqttsn_topic_registry_load(p_client, gateway_id);
+    }
+
     memset(&(p_client->gateway_info.addr), 0, sizeof(p_client->gateway_info.addr));
     memcpy(&(p_client->gateway_info.addr), p_remote, sizeof(p_client->gateway_info.addr));
 
@@ -556,11 +598,94 @@ uint32_t mqttsn_client_sleep(mqttsn_client_t * p_client, uint16_t polling_time)
     return err_code;
 }
 
+/**@brief Publishes data to given topic with QoS 1 or 2.
+ *
+ * @param[inout] p_client    Pointer to initialized and connected client.
+ * @param[in]    topic_id    Value of previously registered topic ID.
+ * @param[in]    qos         QoS level.
+ * @param[in]    p_payload   Data to be published.
+ * @param[in]    payload_len Length of data to be published.
+ * @param[out]   p_msg_id    (optional) Pointer to message ID assigned to the message by client.
+ */
+static uint32_t publish(mqttsn_client_t * p_client,
+                        uint16_t          topic_id,
+                        uint8_t           qos,
+                        const uint8_t   * p_payload,
+                        uint16_t          payload_len,
+                        uint16_t        * p_msg_id)
+{
+    NULL_PARAM_CHECK(p_client);
+    NULL_PARAM_CHECK(p_payload);
+
+    if(topic_id == 0 || payload_len == 0)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!is_connected(p_client) && !is_asleep(p_client))
+    {
+        return NRF_ERROR_FORBIDDEN;
+    }
+
+    mqttsn_topic_t topic = { .topic_id = topic_id };
+
+    uint32_t err_code = mqttsn_packet_sender_publish(p_client, &topic, qos, p_payload, payload_len);
+    if (p_msg_id)
+    {
+        *p_msg_id = p_client->message_id;
+    }
+
+    return err_code;
+}
+
 uint32_t mqttsn_client_publish(mqttsn_client_t * p_client,
                                uint16_t          topic_id,
                                const uint8_t   * p_payload,
                                uint16_t          payload_len,
                                uint16_t        * p_msg_id)
+{
+    return publish(p_client, topic_id, 1, p_payload, payload_len, p_msg_id);
+}
+
+uint32_t mqttsn_client_qos2_publish(mqttsn_client_t * p_client,
+                                    uint16_t          topic_id,
+                                    const uint8_t   * p_payload,
+                                    uint16_t          payload_len,
+                                    uint16_t        * p_msg_id)
+{
+    return publish(p_client, topic_id, 2, p_payload, payload_len, p_msg_id);
+}
+
+uint32_t mqttsn_client_qos_negative_one_publish(mqttsn_client_t       * p_client,
+                                                const mqttsn_remote_t * p_remote,
+                                                uint16_t                topic_id,
+                                                const uint8_t         * p_payload,
+                                                uint16_t                payload_len)
+{
+    NULL_PARAM_CHECK(p_client);
+    NULL_PARAM_CHECK(p_remote);
+    NULL_PARAM_CHECK(p_payload);
+
+    if (topic_id == 0 || payload_len == 0)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (!is_initialized(p_client))
+    {
+        return NRF_ERROR_FORBIDDEN;
+    }
+
+    mqttsn_topic_t topic = { .topic_id = topic_id };
+
+    return mqttsn_packet_sender_qos_negative_one_publish(p_client, p_remote, &topic, p_payload, payload_len);
+}
+
+uint32_t mqttsn_client_batch_publish(mqttsn_client_t * p_client,
+                                     uint16_t          topic_id,
+                                     const uint8_t   * p_payload,
+                                     uint16_t          payload_len,
+                                     uint16_t        * p_msg_id)
 {
     NULL_PARAM_CHECK(p_client);
     NULL_PARAM_CHECK(p_payload);
@@ -577,7 +702,7 @@ uint32_t mqttsn_client_publish(mqttsn_client_t * p_client,
 
     mqttsn_topic_t topic = { .topic_id = topic_id };
 
-    uint32_t err_code = mqttsn_packet_sender_publish(p_client, &topic, p_payload, payload_len);
+    uint32_t err_code = mqttsn_packet_sender_batch_publish(p_client, &topic, p_payload, payload_len);
     if (p_msg_id)
     {
         *p_msg_id = p_client->message_id;
@@ -586,6 +711,18 @@ uint32_t mqttsn_client_publish(mqttsn_client_t * p_client,
     return err_code;
 }
 
+uint32_t mqttsn_client_batch_flush(mqttsn_client_t * p_client)
+{
+    NULL_PARAM_CHECK(p_client);
+
+    if (!is_connected(p_client) && !is_asleep(p_client))
+    {
+        return NRF_ERROR_FORBIDDEN;
+    }
+
+    return mqttsn_packet_sender_batch_flush(p_client);
+}
+
 uint32_t mqttsn_client_topic_register(mqttsn_client_t * p_client,
                                       const uint8_t   * p_topic_name,
                                       uint16_t          topic_name_len,
@@ -604,7 +741,32 @@ uint32_t mqttsn_client_topic_register(mqttsn_client_t * p_client,
     }
 
     mqttsn_topic_t topic = { .p_topic_name = p_topic_name };
-    
+
+    /* The registry copy of the name outlives the caller's buffer, so REGACK can update the entry. */
+    uint32_t index = mqttsn_topic_registry_add(p_client, p_topic_name, topic_name_len);
+    if (index != MQTTSN_TOPIC_REGISTRY_MAX_LENGTH)
+    {
+        topic.p_topic_name = p_client->topic_registry.name[index];
+        topic.topic_id     = p_client->topic_registry.topic_id[index];
+    }
+
+    if (topic.topic_id != 0)
+    {
+        if (p_msg_id)
+        {
+            *p_msg_id = 0;
+        }
+
+        mqttsn_event_t evt;
+        memset(&evt, 0, sizeof(mqttsn_event_t));
+        evt.event_id                           = MQTTSN_EVENT_REGISTERED;
+        evt.event_data.registered.packet.topic = topic;
+
+        p_client->evt_handler(p_client, &evt);
+
+        return NRF_SUCCESS;
+    }
+
     uint32_t err_code = mqttsn_packet_sender_register(p_client, &topic, topic_name_len);
     if (p_msg_id)
     {
@@ -614,6 +776,27 @@ uint32_t mqttsn_client_topic_register(mqttsn_client_t * p_client,
     return err_code;
 }
 
+uint32_t mqttsn_client_topic_id_get(const mqttsn_client_t * p_client,
+                                    const uint8_t         * p_topic_name,
+                                    uint16_t                topic_name_len,
+                                    uint16_t              * p_topic_id)
+{
+    NULL_PARAM_CHECK(p_client);
+    NULL_PARAM_CHECK(p_topic_name);
+    NULL_PARAM_CHECK(p_topic_id);
+
+    uint32_t index = mqttsn_topic_registry_find(p_client, p_topic_name, topic_name_len);
+    if ((index == MQTTSN_TOPIC_REGISTRY_MAX_LENGTH) || (p_client->topic_registry.topic_id[index] == 0) ||
+        (p_client->topic_registry.gateway_id != p_client->gateway_info.id))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    *p_topic_id = p_client->topic_registry.topic_id[index];
+
+    return NRF_SUCCESS;
+}
+
 uint32_t mqttsn_client_subscribe(mqttsn_client_t * p_client,
                                  const uint8_t   * p_topic_name,
                                  uint16_t          topic_name_len,
@@ -730,55 +913,34 @@ uint32_t mqttsn_client_uninit(mqttsn_client_t * p_client)
         return NRF_ERROR_FORBIDDEN;
     }
 
+    if (p_client->batch.p_message != NULL)
+    {
+        mqttsn_transport_message_free(p_client->batch.p_message);
+    }
+    memset(&p_client->batch, 0, sizeof(mqttsn_batch_t));
+
     mqttsn_packet_fifo_uninit(p_client);
+    mqttsn_timer_queue_init(p_client);
+    mqttsn_platform_uninit(p_client);
     return mqttsn_transport_uninit(p_client) == 0 ? NRF_SUCCESS : NRF_ERROR_INTERNAL;
 }
 
 uint32_t mqttsn_client_timeout_schedule(mqttsn_client_t * p_client)
 {
-    uint32_t err_code     = NRF_SUCCESS;
-    uint32_t next_timeout = UINT32_MAX;
-    uint32_t timer_value  = mqttsn_platform_timer_cnt_get();
-
-    /* Gateway discovery procedure schedule. */
-    if (p_client->gateway_discovery.pending)
-    {
-        if ((!m_gateway_discovery_started) &&
-            (p_client->gateway_discovery.rnd_jitter_timeout - timer_value < next_timeout))
-        {
-            next_timeout = p_client->gateway_discovery.rnd_jitter_timeout - timer_value;
-        }
-        else if (m_gateway_discovery_started && 
-                 (p_client->gateway_discovery.search_gw_timeout - timer_value < next_timeout))
-        {
-            next_timeout = p_client->gateway_discovery.search_gw_timeout - timer_value;
-        }
-    }
-
-    /* Packet retransmission schedule. */
-    for (int i = 0; i < p_client->packet_queue.num_of_elements; i++)
-    {
-        if ((p_client->packet_queue.packet[i].timeout - timer_value) < next_timeout)
-        {
-            next_timeout = p_client->packet_queue.packet[i].timeout - timer_value;
-        }
-    }
-
-    /* Keep alive transmission schedule. */
-    if ((p_client->keep_alive.timeout - timer_value) < next_timeout)
-    {
-        next_timeout = p_client->keep_alive.timeout - timer_value;
-        p_client->keep_alive.response_arrived = 0;
-    }
+    uint32_t err_code    = NRF_SUCCESS;
+    uint32_t timer_value = mqttsn_platform_timer_cnt_get();
+    uint32_t deadline;
+    uint8_t  timer;
 
     /* Schedule the closest timeout. */
-    if (next_timeout != UINT32_MAX)
+    if (mqttsn_timer_queue_next_get(p_client, &timer, &deadline) == NRF_SUCCESS)
     {
-        next_timeout = next_timeout % mqttsn_platform_timer_resolution_get();
+        uint32_t next_timeout = mqttsn_timer_queue_is_expired(deadline, timer_value) ?
+                                0 : (deadline - timer_value);
 
         do
         {
-            err_code = mqttsn_platform_timer_stop();
+            err_code = mqttsn_platform_timer_stop(p_client);
             if (err_code != NRF_SUCCESS)
             {
                 NRF_LOG_ERROR("MQTT-SN platform timer failed to stop. "
@@ -797,47 +959,76 @@ uint32_t mqttsn_client_timeout_schedule(mqttsn_client_t * p_client)
         } while (0);
     }
 
+    /* Packets added to or removed from the in-flight window change the poll period of a sleeping client. */
+    mqttsn_client_poll_period_update(p_client);
+
     return err_code;
 }
 
 void mqttsn_client_timeout_handle(mqttsn_client_t * p_client)
 {
     uint32_t timer_value = mqttsn_platform_timer_cnt_get();
+    uint32_t deadline;
+    uint8_t  timer;
 
-    /* Gateway discovery procedure handler. */
-    if (p_client->gateway_discovery.pending)
+    /* Expire timers in deadline order. Handlers re-arm timers only in the future. */
+    while ((mqttsn_timer_queue_next_get(p_client, &timer, &deadline) == NRF_SUCCESS) &&
+           mqttsn_timer_queue_is_expired(deadline, timer_value))
     {
-        if (!m_gateway_discovery_started &&
-            is_earlier(p_client->gateway_discovery.rnd_jitter_timeout, timer_value))
-        {
-            m_gateway_discovery_started = true;
-            mqttsn_client_gateway_discovery_start(p_client);
-        }
-        else if (is_earlier(p_client->gateway_discovery.search_gw_timeout, timer_value))
-        {
-            m_gateway_discovery_started = false;
-            mqttsn_client_gateway_discovery_finish(p_client);
-        }
-    }
+        mqttsn_timer_queue_cancel(p_client, timer);
 
-    /* Packet retransmission handler. */
-    for (int i = 0; i < p_client->packet_queue.num_of_elements; i++)
-    {
-        if (is_earlier(p_client->packet_queue.packet[i].timeout, timer_value))
+        switch (timer)
         {
-            message_retransmission_attempt(p_client, i);
-        }
-    }
+            /* Gateway discovery procedure handler. */
+            case MQTTSN_TIMER_GATEWAY_DISCOVERY:
+                if (!p_client->gateway_discovery.pending)
+                {
+                    break;
+                }
+
+                if (!p_client->gateway_discovery.started)
+                {
+                    mqttsn_timer_queue_set(p_client,
+                                           MQTTSN_TIMER_GATEWAY_DISCOVERY,
+                                           p_client->gateway_discovery.search_gw_timeout);
+                    mqttsn_client_gateway_discovery_start(p_client);
+                }
+                else
+                {
+                    mqttsn_client_gateway_discovery_finish(p_client);
+                }
+                break;
 
-    /* Keep alive transmission handler. */
-    if (is_connected(p_client) || is_asleep(p_client))
-    {
-        if (is_earlier(p_client->keep_alive.timeout, timer_value))
-        {
-            keep_alive_transmission_attempt(p_client);
+            /* Batched PUBLISH messages handler. */
+            case MQTTSN_TIMER_BATCH:
+            {
+                uint32_t err_code = mqttsn_packet_sender_batch_flush(p_client);
+                if (err_code != NRF_SUCCESS)
+                {
+                    NRF_LOG_ERROR("Batch could not be sent. Error code: 0x%x\r\n", err_code);
+                }
+                break;
+            }
+
+            /* Keep alive transmission handler. */
+            case MQTTSN_TIMER_KEEP_ALIVE:
+                if (is_connected(p_client) || is_asleep(p_client))
+                {
+                    p_client->keep_alive.response_arrived = 0;
+                    keep_alive_transmission_attempt(p_client);
+                }
+                break;
+
+            /* Packet retransmission handler. */
+            default:
+                message_retransmission_attempt(p_client, timer);
+                break;
         }
     }
 
+    /* Packets that timed out free slots in the in-flight window. */
+    mqttsn_packet_sender_backlog_flush(p_client);
+
     /* Schedule the next timeout. */
     (void)mqttsn_client_timeout_schedule(p_client);
 }
@@ -52,8 +52,34 @@ extern "C" {
  * @section DEFINES
  **************************************************************************************************/
 
-/**@brief Default maximum number of elements in packet queue. */
-#define MQTTSN_PACKET_FIFO_MAX_LENGTH            4
+/**@brief Maximum number of packets awaiting acknowledgement (in-flight window). At most 255. */
+#ifndef MQTTSN_PACKET_FIFO_MAX_LENGTH
+#define MQTTSN_PACKET_FIFO_MAX_LENGTH            8
+#endif
+
+/**@brief Number of message ID hash buckets used to match acknowledgements to in-flight packets. */
+#ifndef MQTTSN_PACKET_FIFO_BUCKETS
+#define MQTTSN_PACKET_FIFO_BUCKETS               MQTTSN_PACKET_FIFO_MAX_LENGTH
+#endif
+
+/**@brief Maximum number of PUBLISH messages waiting for a free slot in the in-flight window. */
+#ifndef MQTTSN_PUBLISH_BACKLOG_MAX_LENGTH
+#define MQTTSN_PUBLISH_BACKLOG_MAX_LENGTH        8
+#endif
+
+/**@brief Maximum size of a datagram carrying batched PUBLISH messages in bytes.
+ *
+ * @details The default keeps a batch, with compressed IPv6 and UDP headers and link security,
+ *          within a single IEEE 802.15.4 frame, so it is never fragmented.
+ */
+#ifndef MQTTSN_BATCH_MAX_DATAGRAM_SIZE
+#define MQTTSN_BATCH_MAX_DATAGRAM_SIZE           80
+#endif
+
+/**@brief Time after which a batch is sent even if it is not full. */
+#ifndef MQTTSN_BATCH_WINDOW_MS
+#define MQTTSN_BATCH_WINDOW_MS                   1000
+#endif
 
 /**@brief Maximum length of Client ID according to the protocol spec in bytes. */
 #define MQTTSN_CLIENT_ID_MAX_LENGTH              23
@@ -64,6 +90,11 @@ extern "C" {
 /**@brief Default time in seconds for which MQTT-SN Client is considered asleep by the MQTT-SN Gateway. */
 #define MQTTSN_DEFAULT_SLEEP_DURATION            30
 
+/**@brief Data poll period of a sleeping client while it waits for the gateway, e.g. for PINGRESP. */
+#ifndef MQTTSN_FAST_POLL_PERIOD_IN_MS
+#define MQTTSN_FAST_POLL_PERIOD_IN_MS            188
+#endif
+
 /**@brief Default value of the clean session flag in CONNECT message. */
 #define MQTTSN_DEFAULT_CLEAN_SESSION_FLAG        1
 
@@ -73,12 +104,68 @@ extern "C" {
 /**@brief Default port MQTT-SN client binds to. */
 #define MQTTSN_DEFAULT_CLIENT_PORT               47193
 
-/**@brief Default retransmission time in milliseconds. */
+/**@brief Default retransmission time in milliseconds. Used until the gateway round-trip time is measured. */
 #define MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS 8000
 
+/**@brief Lower bound of the retransmission time computed from the measured round-trip time. */
+#ifndef MQTTSN_MIN_RETRANSMISSION_TIME_IN_MS
+#define MQTTSN_MIN_RETRANSMISSION_TIME_IN_MS     500
+#endif
+
+/**@brief Upper bound of the retransmission time, also after exponential backoff. */
+#ifndef MQTTSN_MAX_RETRANSMISSION_TIME_IN_MS
+#define MQTTSN_MAX_RETRANSMISSION_TIME_IN_MS     60000
+#endif
+
 /**@brief Default number of retransmission retries. */
 #define MQTTSN_DEFAULT_RETRANSMISSION_CNT        2
 
+/**@brief Maximum number of clients initialized at the same time. Each one has its own socket and timer. */
+#ifndef MQTTSN_CLIENT_MAX_COUNT
+#define MQTTSN_CLIENT_MAX_COUNT                  2
+#endif
+
+/**@brief QoS level requested in SUBSCRIBE messages. Set to 2 for exactly-once delivery, e.g. to actuators. */
+#ifndef MQTTSN_SUBSCRIBE_QOS
+#define MQTTSN_SUBSCRIBE_QOS                     1
+#endif
+
+/**@brief Maximum number of received QoS 2 PUBLISH messages awaiting PUBREL. Older ones may be delivered twice. */
+#ifndef MQTTSN_QOS2_RECEIVED_MAX_LENGTH
+#define MQTTSN_QOS2_RECEIVED_MAX_LENGTH          4
+#endif
+
+/**@brief Size of the buffer received datagrams are parsed from. Longer datagrams are dropped. */
+#ifndef MQTTSN_RX_BUFFER_SIZE
+#define MQTTSN_RX_BUFFER_SIZE                    256
+#endif
+
+/**@brief Size of the buffer control packets are serialized into. PUBLISH payloads never pass through it. */
+#ifndef MQTTSN_TX_BUFFER_SIZE
+#define MQTTSN_TX_BUFFER_SIZE                    128
+#endif
+
+/**@brief Maximum number of topic names whose topic IDs are cached by the client. */
+#ifndef MQTTSN_TOPIC_REGISTRY_MAX_LENGTH
+#define MQTTSN_TOPIC_REGISTRY_MAX_LENGTH         8
+#endif
+
+/**@brief Number of topic name hash buckets of the topic registry. */
+#ifndef MQTTSN_TOPIC_REGISTRY_BUCKETS
+#define MQTTSN_TOPIC_REGISTRY_BUCKETS            MQTTSN_TOPIC_REGISTRY_MAX_LENGTH
+#endif
+
+/**@brief Maximum length of a topic name cached by the client. Longer names are registered every time. */
+#ifndef MQTTSN_TOPIC_NAME_MAX_LENGTH
+#define MQTTSN_TOPIC_NAME_MAX_LENGTH             32
+#endif
+
+/**@brief Settings key the topic registry of the first client for gateway 0 is stored under. Gateway N
+ *        uses this key + N, and every further client the next block of 256 keys. */
+#ifndef MQTTSN_TOPIC_REGISTRY_SETTINGS_KEY
+#define MQTTSN_TOPIC_REGISTRY_SETTINGS_KEY       0x4d00
+#endif
+
 /**@brief Length of an IPv6 address in bytes. For internal use only */
 #define IPV6_ADDR_BYTE_LENGTH                    16
 
@@ -108,22 +195,46 @@ typedef struct mqttsn_topic_t
     uint16_t        topic_id;     /**< Topic ID. */
 } mqttsn_topic_t;
 
+/**@brief Transport layer message buffer. Its layout is private to the transport. */
+typedef struct mqttsn_message_t mqttsn_message_t;
+
+/**@brief Transport instance (socket) of a client. Its layout is private to the transport. */
+typedef struct mqttsn_transport_t mqttsn_transport_t;
+
+/**@brief Platform timer of a client. Its layout is private to the platform. */
+typedef struct mqttsn_platform_timer_t mqttsn_platform_timer_t;
+
 /**@brief Packet information. */
 typedef struct mqttsn_packet_t
 {
-    uint8_t        retransmission_cnt; /**< Number of retransmissions to attempt if necessary. */
-    uint8_t      * p_data;             /**< Message content. */
-    uint16_t       len;                /**< Length of the message. */
-    uint16_t       id;                 /**< Message ID. */
-    uint32_t       timeout;            /**< Time of the next retransmissions in ms (if necessary). */
-    mqttsn_topic_t topic;              /**< Topic of the message. */
+    uint8_t            retransmission_cnt; /**< Number of retransmissions to attempt if necessary. */
+    uint8_t            msg_type;           /**< MQTT-SN message type. */
+    uint8_t          * p_data;             /**< Message content. */
+    uint16_t           len;                /**< Length of the message. */
+    mqttsn_message_t * p_message;          /**< Transport message kept for retransmission. Used instead of p_data if set. */
+    uint16_t           id;                 /**< Message ID. */
+    uint8_t            qos;                /**< QoS level of a PUBLISH message. */
+    uint32_t           timeout;            /**< Time of the next retransmissions in ms (if necessary). */
+    uint32_t           sent;               /**< Time the message was first sent in ms. */
+    mqttsn_topic_t     topic;              /**< Topic of the message. */
 } mqttsn_packet_t;
 
-/**@brief Packet queueing data available for client. For internal use only */
+/**@brief Packet queueing data available for client. For internal use only
+ *
+ * @details Packets stay in their slot until acknowledged. Slots holding packets with the same
+ *          message ID hash are chained from a bucket, slots not in use are chained on a free list.
+ */
 typedef struct mqttsn_packet_queue_t
 {
-    mqttsn_packet_t packet[MQTTSN_PACKET_FIFO_MAX_LENGTH]; /**< Array of packets. */
-    uint8_t         num_of_elements;                       /**< Current number of elements in the queue. */
+    mqttsn_packet_t packet[MQTTSN_PACKET_FIFO_MAX_LENGTH];            /**< Packet slots. */
+    bool            in_use[MQTTSN_PACKET_FIFO_MAX_LENGTH];            /**< Stores whether a slot holds a packet. */
+    uint8_t         next[MQTTSN_PACKET_FIFO_MAX_LENGTH];              /**< Next slot in the same bucket or on the free list. */
+    uint8_t         bucket[MQTTSN_PACKET_FIFO_BUCKETS];               /**< First slot of every message ID bucket. */
+    uint8_t         free_slot;                                        /**< First slot on the free list. */
+    uint8_t         num_of_elements;                                  /**< Current number of elements in the queue. */
+    mqttsn_packet_t backlog[MQTTSN_PUBLISH_BACKLOG_MAX_LENGTH];       /**< PUBLISH messages waiting for a free slot. */
+    uint8_t         backlog_head;                                     /**< Index of the oldest backlog entry. */
+    uint8_t         backlog_count;                                    /**< Current number of backlog entries. */
 } mqttsn_packet_queue_t;
 
 /**@brief State of an MQTT-SN client. For internal use only */
@@ -151,6 +262,7 @@ typedef struct mqttsn_gateway_discovery_t
 {
     bool     found;              /**< Stores whether a client has found any gateways. */
     bool     pending;            /**< Stores whether a client is searching for gateway. */
+    bool     started;            /**< Stores whether SEARCH GATEWAY message has been sent. */
     uint32_t rnd_jitter_timeout; /**< Generated random delay of SEARCH GATEWAY message. [ms] */
     uint32_t search_gw_timeout;  /**< Gateway discovery procedure timeout. [ms] */
 } mqttsn_gateway_discovery_t;
@@ -194,7 +306,8 @@ typedef enum mqttsn_event_id_t
 typedef enum mqttsn_error_t
 {
     MQTTSN_ERROR_REJECTED_CONGESTION, /**< Message has been rejected due to network congestion. */
-    MQTTSN_ERROR_TIMEOUT              /**< Retransmission limit has been reached. */
+    MQTTSN_ERROR_TIMEOUT,             /**< Retransmission limit has been reached. */
+    MQTTSN_ERROR_REJECTED_TOPIC_ID    /**< Message has been rejected due to unknown topic ID. The topic is registered again. */
 } mqttsn_error_t;
 
 /**@brief MQTT-SN ACK message error. Is forwarded to the application when MQTTSN_EVENT_TIMEOUT occurs. */
@@ -208,6 +321,8 @@ typedef enum mqttsn_ack_error_t
     MQTTSN_PACKET_PINGREQ,      /**< PINGREQ message has not been received. */
     MQTTSN_PACKET_WILLTOPICUPD, /**< WILLTOPICUPD message has not been received. */
     MQTTSN_PACKET_WILLMSGUPD,   /**< WILLMSGUPD message has not been received. */
+    MQTTSN_PACKET_PUBREC,       /**< PUBREC message has not been received. */
+    MQTTSN_PACKET_PUBCOMP,      /**< PUBCOMP message has not been received. */
     MQTTSN_PACKET_INCORRECT     /**< Unknown error. */
 } mqttsn_ack_error_t;
 
@@ -253,7 +368,7 @@ typedef union mqttsn_event_data_t
 {
     mqttsn_event_gwinfo_t   connected;  /**< Data forwarded to the application when a gateway is found. */
     mqttsn_event_register_t registered; /**< Data forwarded to the application when a topic is registered. */
-    mqttsn_event_publish_t  published;  /**< Data forwarded to the application when PUBLISH message is received. */
+    mqttsn_event_publish_t  published;  /**< Data forwarded to the application when PUBLISH message is received, or acknowledged (no payload). */
     mqttsn_event_error_t    error;      /**< Data forwarded to the application when a retransmission error occurred. */
     mqttsn_event_searchgw_t discovery;  /**< Data forwarded to the applitcaion when SEARCH GATEWAY message fails. */
 } mqttsn_event_data_t;
@@ -272,8 +387,70 @@ typedef struct mqttsn_keep_alive_t
     uint32_t        duration;         /**< Keep alive duration in milliseconds. */
     uint8_t         response_arrived; /**< 1 when gateway has responded to previous keep alive, 0 otherwise. */
     mqttsn_packet_t message;          /**< Keep alive message (PINGREQ). */
+    uint8_t         pingreq[2 + MQTTSN_CLIENT_ID_MAX_LENGTH]; /**< Serialized PINGREQ message. */
 } mqttsn_keep_alive_t;
 
+/**@brief Round-trip time estimate of the gateway (RFC 6298). For internal use only */
+typedef struct mqttsn_rtt_t
+{
+    bool     measured; /**< Stores whether any round-trip time sample has been taken. */
+    uint32_t srtt;     /**< Smoothed round-trip time. [ms] */
+    uint32_t rttvar;   /**< Round-trip time variation. [ms] */
+    uint32_t rto;      /**< Retransmission time of the first transmission. [ms] */
+} mqttsn_rtt_t;
+
+/**@brief Received QoS 2 PUBLISH messages awaiting PUBREL. For internal use only */
+typedef struct mqttsn_qos2_received_t
+{
+    uint16_t id[MQTTSN_QOS2_RECEIVED_MAX_LENGTH]; /**< Message IDs, 0 if unused. */
+    uint8_t  next;                                /**< Entry overwritten by the next message. */
+} mqttsn_qos2_received_t;
+
+/**@brief Topic IDs assigned by the gateway to topic names. For internal use only
+ *
+ * @details Names are chained from a bucket selected by their hash. Entries are never removed, an
+ *          entry whose topic ID has been rejected by the gateway keeps its name with topic ID 0.
+ */
+typedef struct mqttsn_topic_registry_t
+{
+    uint8_t  name[MQTTSN_TOPIC_REGISTRY_MAX_LENGTH][MQTTSN_TOPIC_NAME_MAX_LENGTH]; /**< Topic names. */
+    uint8_t  name_len[MQTTSN_TOPIC_REGISTRY_MAX_LENGTH];                          /**< Topic name lengths. */
+    uint16_t topic_id[MQTTSN_TOPIC_REGISTRY_MAX_LENGTH];                          /**< Topic IDs, 0 if not registered. */
+    uint8_t  next[MQTTSN_TOPIC_REGISTRY_MAX_LENGTH];                              /**< Next entry in the same bucket. */
+    uint8_t  bucket[MQTTSN_TOPIC_REGISTRY_BUCKETS];                               /**< First entry of every bucket. */
+    uint8_t  count;                                                               /**< Number of entries. */
+    uint8_t  gateway_id;                                                          /**< Gateway the topic IDs were assigned by. */
+} mqttsn_topic_registry_t;
+
+/**@brief PUBLISH messages collected into one datagram. For internal use only */
+typedef struct mqttsn_batch_t
+{
+    mqttsn_message_t * p_message;                          /**< Datagram the PUBLISH messages are appended to. */
+    uint16_t           len;                                /**< Current length of the datagram. */
+    uint8_t            count;                              /**< Number of PUBLISH messages in the datagram. */
+    uint16_t           id[MQTTSN_PACKET_FIFO_MAX_LENGTH];  /**< Message IDs of the PUBLISH messages. */
+    uint32_t           timeout;                            /**< Time the datagram is sent at if it does not fill up before. [ms] */
+} mqttsn_batch_t;
+
+/**@brief Timers of an MQTT-SN client. Timers 0 .. MQTTSN_PACKET_FIFO_MAX_LENGTH - 1 belong to packet slots. */
+#define MQTTSN_TIMER_KEEP_ALIVE        (MQTTSN_PACKET_FIFO_MAX_LENGTH)
+#define MQTTSN_TIMER_GATEWAY_DISCOVERY (MQTTSN_PACKET_FIFO_MAX_LENGTH + 1)
+#define MQTTSN_TIMER_BATCH             (MQTTSN_PACKET_FIFO_MAX_LENGTH + 2)
+#define MQTTSN_TIMER_COUNT             (MQTTSN_PACKET_FIFO_MAX_LENGTH + 3)
+
+/**@brief Armed timers of a client ordered by deadline in a binary min-heap. For internal use only
+ *
+ * @details Deadlines are compared relative to each other, so the order survives the wrap-around
+ *          of the millisecond counter as long as armed deadlines are less than 2^31 ms apart.
+ */
+typedef struct mqttsn_timer_queue_t
+{
+    uint32_t deadline[MQTTSN_TIMER_COUNT]; /**< Deadline of every timer. [ms] */
+    uint8_t  heap[MQTTSN_TIMER_COUNT];     /**< Armed timers, the one with the earliest deadline first. */
+    uint8_t  position[MQTTSN_TIMER_COUNT]; /**< Heap position of every timer. */
+    uint8_t  size;                         /**< Number of armed timers. */
+} mqttsn_timer_queue_t;
+
 /**@brief Forward declaration of MQTT-SN client. */
 typedef struct mqttsn_client_t mqttsn_client_t;
 
@@ -295,8 +472,16 @@ struct mqttsn_client_t
     mqttsn_client_state_t       client_state;      /**< Current state of the client. */
     mqttsn_gateway_discovery_t  gateway_discovery; /**< Gateway discovery information. */
     mqttsn_gw_info_t            gateway_info;      /**< Gateway information. */
+    mqttsn_rtt_t                rtt;               /**< Round-trip time estimate of the gateway. */
     mqttsn_connect_opt_t        connect_info;      /**< Connect options. */
     mqttsn_packet_queue_t       packet_queue;      /**< Packet queue. */
+    mqttsn_batch_t              batch;             /**< PUBLISH messages waiting to be sent together. */
+    mqttsn_qos2_received_t      qos2_received;     /**< QoS 2 PUBLISH messages received and not released yet. */
+    mqttsn_topic_registry_t     topic_registry;    /**< Topic IDs registered with the gateway. */
+    mqttsn_timer_queue_t        timer_queue;       /**< Deadlines of retransmissions, keep alive, discovery and batch. */
+    mqttsn_transport_t        * p_transport;       /**< Transport instance the client sends and receives through. */
+    mqttsn_platform_timer_t   * p_timer;           /**< Platform timer the client schedules its timeouts on. */
+    uint32_t                    poll_period;       /**< Data poll period requested from the transport, 0 if none. [ms] */
     mqttsn_client_evt_handler_t evt_handler;       /**< Event handler. */
 };
 
@@ -338,7 +523,7 @@ uint32_t mqttsn_client_search_gateway(mqttsn_client_t * p_client, uint32_t timeo
  * @param[in]    gateway_id  Gateway ID as received from the gateway in GWINFO message.
  * @param[in]    p_options   Connect options.
  *
- * @return       NRF_SUCCESS if the connection request has been sent successfully.
+ * @return       NRF_SUCCESS if the connection request has been queued for (re)transmission.
  *               Otherwise error code is returned.
  */
 uint32_t mqttsn_client_connect(mqttsn_client_t      * p_client,
@@ -372,14 +557,18 @@ uint32_t mqttsn_client_sleep(mqttsn_client_t * p_client, uint16_t polling_time);
 
 /**@brief Registers topic.  
  *
- * @details Topic name with assigned topic ID can be accessed in MQTT-SN_EVENT_REGISTERED callback.  
+ * @details Topic name with assigned topic ID can be accessed in MQTT-SN_EVENT_REGISTERED callback.
+ *          Topic IDs are cached per gateway, also across reboots. If the topic ID of the name is
+ *          cached, no REGISTER message is sent and the callback is called before this function
+ *          returns, with message ID 0. The topic name passed to the callback points at the client's
+ *          copy of the name, or at p_topic_name if the name could not be cached.
  *
  * @param[inout] p_client       Pointer to initialized and connected client.
  * @param[in]    p_topic_name   String buffer containing the topic name.
  * @param[in]    topic_name_len Topic name length.
  * @param[out]   msg_id         (optional) Pointer to message ID assigned to the message by client. 
  *
- * @return       NRF_SUCCESS if the registration request has been sent successfully.
+ * @return       NRF_SUCCESS if the registration request has been queued for (re)transmission.
  *               Otherwise error code is returned.
  */
 uint32_t mqttsn_client_topic_register(mqttsn_client_t * p_client,
@@ -388,7 +577,31 @@ uint32_t mqttsn_client_topic_register(mqttsn_client_t * p_client,
                                       uint16_t        * msg_id);
 
 
+/**@brief Looks up the cached topic ID of a topic name.
+ *
+ * @details Allows publishing right after connecting to a gateway the topic has been registered with
+ *          before. If the gateway no longer knows the topic ID, the PUBLISH message is rejected
+ *          with MQTTSN_ERROR_REJECTED_TOPIC_ID and the topic is registered again.
+ *
+ * @param[in]    p_client       Pointer to initialized client.
+ * @param[in]    p_topic_name   String buffer containing the topic name.
+ * @param[in]    topic_name_len Topic name length.
+ * @param[out]   p_topic_id     Cached topic ID.
+ *
+ * @retval       NRF_SUCCESS         If the topic ID has been found.
+ * @retval       NRF_ERROR_NOT_FOUND If the topic has not been registered with the current gateway.
+ */
+uint32_t mqttsn_client_topic_id_get(const mqttsn_client_t * p_client,
+                                    const uint8_t         * p_topic_name,
+                                    uint16_t                topic_name_len,
+                                    uint16_t              * p_topic_id);
+
+
 /**@brief Publishes data to given topic.  
+ *
+ * @details When MQTTSN_PACKET_FIFO_MAX_LENGTH messages already await acknowledgement, the message
+ *          is kept in a backlog of up to MQTTSN_PUBLISH_BACKLOG_MAX_LENGTH messages and sent, in
+ *          order, as soon as acknowledgements or timeouts free the window.
  *
  * @param[inout] p_client       Pointer to initialized and connected client.
  * @param[in]    topic_id       Value of previously registered topic ID. 
@@ -396,8 +609,10 @@ uint32_t mqttsn_client_topic_register(mqttsn_client_t * p_client,
  * @param[in]    payload_len    Length of data to be published.
  * @param[out]   msg_id         (optional) Pointer to message ID assigned to the message by client. 
  *
- * @return       NRF_SUCCESS if the publish request has been sent successfully.
- *               Otherwise error code is returned.
+ * @retval       NRF_SUCCESS      If the publish request has been queued for (re)transmission or put in
+ *                                the backlog.
+ * @retval       NRF_ERROR_NO_MEM If both the in-flight window and the backlog are full.
+ * @return       Otherwise error code is returned.
  */
 uint32_t mqttsn_client_publish(mqttsn_client_t * p_client,
                                uint16_t          topic_id,
@@ -406,6 +621,87 @@ uint32_t mqttsn_client_publish(mqttsn_client_t * p_client,
                                uint16_t        * msg_id);
 
 
+/**@brief Publishes data to given topic with QoS 2.
+ *
+ * @details The message is retransmitted until PUBREC arrives, then PUBREL is retransmitted until
+ *          PUBCOMP arrives and MQTTSN_EVENT_PUBLISHED is raised. The gateway delivers the message
+ *          exactly once. The in-flight window and backlog are shared with @ref mqttsn_client_publish.
+ *
+ * @param[inout] p_client       Pointer to initialized and connected client.
+ * @param[in]    topic_id       Value of previously registered topic ID.
+ * @param[in]    p_payload      Data to be published.
+ * @param[in]    payload_len    Length of data to be published.
+ * @param[out]   msg_id         (optional) Pointer to message ID assigned to the message by client.
+ *
+ * @retval       NRF_SUCCESS      If the publish request has been queued for (re)transmission or put in
+ *                                the backlog.
+ * @retval       NRF_ERROR_NO_MEM If both the in-flight window and the backlog are full.
+ * @return       Otherwise error code is returned.
+ */
+uint32_t mqttsn_client_qos2_publish(mqttsn_client_t * p_client,
+                                    uint16_t          topic_id,
+                                    const uint8_t   * p_payload,
+                                    uint16_t          payload_len,
+                                    uint16_t        * msg_id);
+
+
+/**@brief Publishes data to a predefined topic with QoS -1.
+ *
+ * @details The message is sent once and never acknowledged. The client does not need to be
+ *          connected, so no CONNECT or keep-alive messages are exchanged with the gateway.
+ *
+ * @param[inout] p_client       Pointer to initialized client.
+ * @param[in]    p_remote       Pointer to address and port of the gateway.
+ * @param[in]    topic_id       Predefined topic ID known to the gateway.
+ * @param[in]    p_payload      Data to be published.
+ * @param[in]    payload_len    Length of data to be published.
+ *
+ * @return       NRF_SUCCESS if the message has been sent successfully.
+ *               Otherwise error code is returned.
+ */
+uint32_t mqttsn_client_qos_negative_one_publish(mqttsn_client_t       * p_client,
+                                                const mqttsn_remote_t * p_remote,
+                                                uint16_t                topic_id,
+                                                const uint8_t         * p_payload,
+                                                uint16_t                payload_len);
+
+
+/**@brief Adds data to the current batch of PUBLISH messages.
+ *
+ * @details PUBLISH messages are packed back to back into one datagram, which is sent when the next
+ *          message would not fit in MQTTSN_BATCH_MAX_DATAGRAM_SIZE bytes or MQTTSN_BATCH_WINDOW_MS
+ *          after its first message was added. Every message keeps its own message ID, is
+ *          acknowledged with its own PUBACK and, if needed, retransmitted on its own.
+ *
+ * @note The gateway must accept several MQTT-SN messages in one datagram. If the in-flight window
+ *       is full, the current batch is sent and the data is published as by @ref mqttsn_client_publish.
+ *
+ * @param[inout] p_client       Pointer to initialized and connected client.
+ * @param[in]    topic_id       Value of previously registered topic ID.
+ * @param[in]    p_payload      Data to be published.
+ * @param[in]    payload_len    Length of data to be published.
+ * @param[out]   msg_id         (optional) Pointer to message ID assigned to the message by client.
+ *
+ * @return       NRF_SUCCESS if the data has been added to the batch successfully.
+ *               Otherwise error code is returned.
+ */
+uint32_t mqttsn_client_batch_publish(mqttsn_client_t * p_client,
+                                     uint16_t          topic_id,
+                                     const uint8_t   * p_payload,
+                                     uint16_t          payload_len,
+                                     uint16_t        * msg_id);
+
+
+/**@brief Sends the current batch of PUBLISH messages without waiting for it to fill up.
+ *
+ * @param[inout] p_client       Pointer to initialized and connected client.
+ *
+ * @return       NRF_SUCCESS if the batch has been sent successfully or there was nothing to send.
+ *               Otherwise error code is returned.
+ */
+uint32_t mqttsn_client_batch_flush(mqttsn_client_t * p_client);
+
+
 /**@brief Subscribes to given topic.  
  *
  * @param[inout] p_client       Pointer to initialized and connected client.
@@ -413,7 +709,7 @@ uint32_t mqttsn_client_publish(mqttsn_client_t * p_client,
  * @param[in]    topic_name_len Topic name length.
  * @param[out]   msg_id         (optional) Pointer to message ID assigned to the message by client.
  *
- * @return       NRF_SUCCESS if the subscribe request has been sent successfully.
+ * @return       NRF_SUCCESS if the subscribe request has been queued for (re)transmission.
  *               Otherwise error code is returned.
  */
 uint32_t mqttsn_client_subscribe(mqttsn_client_t * p_client,
@@ -429,7 +725,7 @@ uint32_t mqttsn_client_subscribe(mqttsn_client_t * p_client,
  * @param[in]    topic_name_len Topic name length.
  * @param[out]   msg_id         (optional) Pointer to message ID assigned to the message by client.
  *
- * @return       NRF_SUCCESS if the subscribe request has been sent successfully.
+ * @return       NRF_SUCCESS if the unsubscribe request has been queued for (re)transmission.
  *               Otherwise error code is returned.
  */
 uint32_t mqttsn_client_unsubscribe(mqttsn_client_t * p_client,
@@ -447,7 +743,7 @@ uint32_t mqttsn_client_unsubscribe(mqttsn_client_t * p_client,
  * @param[in]    p_will_topic   String buffer containing the new will topic name.
  * @param[in]    will_topic_len Will topic name length.
  *
- * @return       NRF_SUCCESS if the update request has been sent successfully.
+ * @return       NRF_SUCCESS if the update request has been queued for (re)transmission.
  *               Otherwise error code is returned.
  */
 uint32_t mqttsn_client_willtopicupd(mqttsn_client_t * p_client,
@@ -464,7 +760,7 @@ uint32_t mqttsn_client_willtopicupd(mqttsn_client_t * p_client,
  * @param[in]    p_will_msg   String buffer containing the new will message name.
  * @param[in]    will_msg_len Will message name length.
  *
- * @return       NRF_SUCCESS if the update request has been sent successfully.
+ * @return       NRF_SUCCESS if the update request has been queued for (re)transmission.
  *               Otherwise error code is returned.
  */
 uint32_t mqttsn_client_willmsgupd(mqttsn_client_t * p_client,
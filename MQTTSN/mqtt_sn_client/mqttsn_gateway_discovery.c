@@ -44,17 +44,10 @@
 #include "nrf_error.h"
 #include "nrf_log.h"
 #include <stddef.h>
+#include <string.h>
 
 #define SEC_TO_MILLISEC(PARAM) (PARAM * 1000)
 
-typedef struct discovery_timeout_t
-{
-    bool rnd_jitter_timeout_reached;
-    bool search_gw_timeout_reached;
-} discovery_timeout_t;
-
-static discovery_timeout_t m_timeout;
-
 static void discovery_event_handle(mqttsn_client_t * p_client, mqttsn_event_searchgw_t discovery_event)
 {
     mqttsn_event_t evt;
@@ -86,13 +79,14 @@ uint32_t mqttsn_client_search_gateway(mqttsn_client_t * p_client, uint32_t timeo
     uint32_t rnd_jitter = mqttsn_platform_rand(MQTTSN_SEARCH_GATEWAY_MAX_DELAY_IN_MS);
     p_client->gateway_discovery.rnd_jitter_timeout = mqttsn_platform_timer_set_in_ms(rnd_jitter);
 
-    m_timeout.rnd_jitter_timeout_reached = false;
-    m_timeout.search_gw_timeout_reached  = false;
-    
+    p_client->gateway_discovery.started = false;
     p_client->gateway_discovery.found   = false;
     p_client->gateway_discovery.pending = true;
     p_client->gateway_discovery.search_gw_timeout = 
         mqttsn_platform_timer_set_in_ms(SEC_TO_MILLISEC(timeout_s));
+    mqttsn_timer_queue_set(p_client,
+                           MQTTSN_TIMER_GATEWAY_DISCOVERY,
+                           p_client->gateway_discovery.rnd_jitter_timeout);
 
     uint32_t err_code = mqttsn_client_timeout_schedule(p_client);
     if (err_code != NRF_SUCCESS)
@@ -109,9 +103,9 @@ uint32_t mqttsn_client_search_gateway(mqttsn_client_t * p_client, uint32_t timeo
 void mqttsn_client_gateway_discovery_start(mqttsn_client_t * p_client)
 {
     /* The random jitter has just passed. Send SEARCH GATEWAY message. */
-    if (!m_timeout.rnd_jitter_timeout_reached)
+    if (p_client->gateway_discovery.pending && !p_client->gateway_discovery.started)
     {
-        m_timeout.rnd_jitter_timeout_reached = true;
+        p_client->gateway_discovery.started = true;
 
         uint32_t err_code = mqttsn_packet_sender_searchgw(p_client);
         if (err_code != NRF_SUCCESS)
@@ -125,12 +119,11 @@ void mqttsn_client_gateway_discovery_start(mqttsn_client_t * p_client)
 void mqttsn_client_gateway_discovery_finish(mqttsn_client_t * p_client)
 {
     /* The gateway discovery timeout has passed. */
-    if (!m_timeout.search_gw_timeout_reached)
+    if (p_client->gateway_discovery.pending)
     {
-        m_timeout.search_gw_timeout_reached = true;
-
         /* Gateway discovery procedure is over. */
         p_client->gateway_discovery.pending = false;
+        p_client->gateway_discovery.started = false;
 
         /* No gateways have been found. Notify the application. */
         if (!p_client->gateway_discovery.found)
@@ -39,87 +39,180 @@
  */
 
 #include "mqttsn_packet_internal.h"
-#include "mem_manager.h"
+#include "mqttsn_transport.h"
 #include "nrf_error.h"
 #include "nrf_log.h"
+#include <string.h>
+
+/**@brief Marks the end of a bucket chain or of the free list. */
+#define SLOT_NONE 0xFF
+
+#if MQTTSN_PACKET_FIFO_MAX_LENGTH >= SLOT_NONE
+#error "MQTTSN_PACKET_FIFO_MAX_LENGTH must be smaller than 255."
+#endif
+
+/**@brief Returns the bucket a message ID hashes to.
+ *
+ * @note Packets without message ID (CONNECT, WILLTOPICUPD, WILLMSGUPD) are kept in bucket 0.
+ */
+static inline uint8_t * bucket_get(mqttsn_packet_queue_t * p_queue, uint16_t id)
+{
+    return &p_queue->bucket[id % MQTTSN_PACKET_FIFO_BUCKETS];
+}
+
+/**@brief Returns the link pointing at the slot that holds the given packet, or NULL if there is none. */
+static uint8_t * slot_link_find(mqttsn_packet_queue_t   * p_queue,
+                                uint16_t                  msg_to_dequeue,
+                                mqttsn_packet_dequeue_t   mode)
+{
+    uint16_t  id     = (mode == MQTTSN_MESSAGE_ID) ? msg_to_dequeue : 0;
+    uint8_t * p_link = bucket_get(p_queue, id);
+
+    while (*p_link != SLOT_NONE)
+    {
+        const mqttsn_packet_t * p_packet = &p_queue->packet[*p_link];
+
+        if ((p_packet->id == id) &&
+            ((mode == MQTTSN_MESSAGE_ID) || (p_packet->msg_type == msg_to_dequeue)))
+        {
+            return p_link;
+        }
+
+        p_link = &p_queue->next[*p_link];
+    }
+
+    return NULL;
+}
 
 void mqttsn_packet_fifo_init(mqttsn_client_t * p_client)
 {
-    memset(&p_client->packet_queue, 0, sizeof(mqttsn_packet_queue_t));
+    mqttsn_packet_queue_t * p_queue = &p_client->packet_queue;
+
+    memset(p_queue, 0, sizeof(mqttsn_packet_queue_t));
+    memset(p_queue->bucket, SLOT_NONE, sizeof(p_queue->bucket));
+
+    for (uint8_t i = 0; i < MQTTSN_PACKET_FIFO_MAX_LENGTH; i++)
+    {
+        p_queue->next[i] = (i + 1 < MQTTSN_PACKET_FIFO_MAX_LENGTH) ? (i + 1) : SLOT_NONE;
+    }
 }
 
 void mqttsn_packet_fifo_uninit(mqttsn_client_t * p_client)
 {
-    memset(&p_client->packet_queue, 0, sizeof(mqttsn_packet_queue_t));
+    mqttsn_packet_queue_t * p_queue = &p_client->packet_queue;
+
+    for (int i = 0; i < MQTTSN_PACKET_FIFO_MAX_LENGTH; i++)
+    {
+        if (p_queue->in_use[i])
+        {
+            mqttsn_transport_message_free(p_queue->packet[i].p_message);
+            mqttsn_timer_queue_cancel(p_client, i);
+        }
+    }
+
+    for (int i = 0; i < p_queue->backlog_count; i++)
+    {
+        mqttsn_transport_message_free(
+            p_queue->backlog[(p_queue->backlog_head + i) % MQTTSN_PUBLISH_BACKLOG_MAX_LENGTH].p_message);
+    }
+
+    mqttsn_packet_fifo_init(p_client);
 }
 
 uint32_t mqttsn_packet_fifo_elem_add(mqttsn_client_t * p_client, mqttsn_packet_t * packet)
 {
-    if (p_client->packet_queue.num_of_elements == MQTTSN_PACKET_FIFO_MAX_LENGTH)
+    mqttsn_packet_queue_t * p_queue = &p_client->packet_queue;
+    uint8_t                 slot    = p_queue->free_slot;
+
+    if (slot == SLOT_NONE)
     {
         NRF_LOG_ERROR("Packet ID fifo capacity exceeded\r\n");
         return NRF_ERROR_NO_MEM;
     }
-    else
-    {
-        p_client->packet_queue.packet[p_client->packet_queue.num_of_elements] = *packet;
 
-        p_client->packet_queue.num_of_elements++;
-        return NRF_SUCCESS;
-    }
+    uint8_t * p_bucket = bucket_get(p_queue, packet->id);
+
+    p_queue->free_slot     = p_queue->next[slot];
+    p_queue->packet[slot]  = *packet;
+    p_queue->in_use[slot]  = true;
+    p_queue->next[slot]    = *p_bucket;
+    *p_bucket              = slot;
+
+    mqttsn_timer_queue_set(p_client, slot, packet->timeout);
+
+    p_queue->num_of_elements++;
+    return NRF_SUCCESS;
 }
 
 uint32_t mqttsn_packet_fifo_elem_dequeue(mqttsn_client_t * p_client, uint16_t msg_to_dequeue, mqttsn_packet_dequeue_t mode)
 {
-    uint32_t elem_to_dequeue = mqttsn_packet_fifo_elem_find(p_client, msg_to_dequeue, mode);
-    if (elem_to_dequeue == MQTTSN_PACKET_FIFO_MAX_LENGTH)
+    mqttsn_packet_queue_t * p_queue = &p_client->packet_queue;
+    uint8_t               * p_link  = slot_link_find(p_queue, msg_to_dequeue, mode);
+
+    if (p_link == NULL)
     {
         NRF_LOG_ERROR("Cannot dequeue packet. Packet does not exist\r\n");
         return NRF_ERROR_NOT_FOUND;
     }
 
-    nrf_free(p_client->packet_queue.packet[elem_to_dequeue].p_data);
+    uint8_t slot = *p_link;
+
+    mqttsn_transport_message_free(p_queue->packet[slot].p_message);
+    p_queue->packet[slot].p_message = NULL;
+
+    *p_link                = p_queue->next[slot];
+    p_queue->in_use[slot]  = false;
+    p_queue->next[slot]    = p_queue->free_slot;
+    p_queue->free_slot     = slot;
+
+    mqttsn_timer_queue_cancel(p_client, slot);
+
+    p_queue->num_of_elements--;
+
+    return NRF_SUCCESS;
+}
+
+uint32_t mqttsn_packet_fifo_elem_find(mqttsn_client_t * p_client, uint16_t msg_to_dequeue, mqttsn_packet_dequeue_t mode)
+{
+    uint8_t * p_link = slot_link_find(&p_client->packet_queue, msg_to_dequeue, mode);
 
-    for (int i = elem_to_dequeue; i < p_client->packet_queue.num_of_elements; i++)
+    return (p_link != NULL) ? *p_link : MQTTSN_PACKET_FIFO_MAX_LENGTH;
+}
+
+bool mqttsn_packet_fifo_is_full(mqttsn_client_t * p_client)
+{
+    return p_client->packet_queue.free_slot == SLOT_NONE;
+}
+
+uint32_t mqttsn_packet_fifo_backlog_add(mqttsn_client_t * p_client, mqttsn_packet_t * p_packet)
+{
+    mqttsn_packet_queue_t * p_queue = &p_client->packet_queue;
+
+    if (p_queue->backlog_count == MQTTSN_PUBLISH_BACKLOG_MAX_LENGTH)
     {
-        p_client->packet_queue.packet[i] = p_client->packet_queue.packet[i+1];
+        NRF_LOG_ERROR("Publish backlog capacity exceeded\r\n");
+        return NRF_ERROR_NO_MEM;
     }
 
-    p_client->packet_queue.num_of_elements--;
+    p_queue->backlog[(p_queue->backlog_head + p_queue->backlog_count) % MQTTSN_PUBLISH_BACKLOG_MAX_LENGTH] =
+        *p_packet;
+    p_queue->backlog_count++;
 
     return NRF_SUCCESS;
 }
 
-uint32_t mqttsn_packet_fifo_elem_find(mqttsn_client_t * p_client, uint16_t msg_to_dequeue, mqttsn_packet_dequeue_t mode)
+uint32_t mqttsn_packet_fifo_backlog_get(mqttsn_client_t * p_client, mqttsn_packet_t * p_packet)
 {
-    uint32_t index       = MQTTSN_PACKET_FIFO_MAX_LENGTH;
-    uint32_t type_offset = 0;
+    mqttsn_packet_queue_t * p_queue = &p_client->packet_queue;
 
-    for (int i = 0; i < p_client->packet_queue.num_of_elements; i++)
+    if (p_queue->backlog_count == 0)
     {
-        switch (mode)
-        {
-            case MQTTSN_MESSAGE_ID:
-                if (p_client->packet_queue.packet[i].id == msg_to_dequeue)
-                {
-                    return i;
-                }
-                break;
-
-            case MQTTSN_MESSAGE_TYPE:
-
-                type_offset = p_client->packet_queue.packet[i].p_data[0] == MQTTSN_TWO_BYTE_LENGTH_CODE ? 
-                              MQTTSN_OFFSET_TWO_BYTE_LENGTH : MQTTSN_OFFSET_ONE_BYTE_LENGTH;
-                
-                if (p_client->packet_queue.packet[i].p_data[type_offset] == msg_to_dequeue)
-                {
-                    return i;
-                }
-                break;
-
-            default:
-                break;
-        }
+        return NRF_ERROR_NOT_FOUND;
     }
-    return index;
+
+    *p_packet             = p_queue->backlog[p_queue->backlog_head];
+    p_queue->backlog_head = (p_queue->backlog_head + 1) % MQTTSN_PUBLISH_BACKLOG_MAX_LENGTH;
+    p_queue->backlog_count--;
+
+    return NRF_SUCCESS;
 }
@@ -80,6 +80,7 @@
 #define MQTTSN_MSGTYPE_CONNECT      0x04
 #define MQTTSN_MSGTYPE_REGISTER     0x0a
 #define MQTTSN_MSGTYPE_PUBLISH      0x0c
+#define MQTTSN_MSGTYPE_PUBREL       0x10
 #define MQTTSN_MSGTYPE_SUBSCRIBE    0x12
 #define MQTTSN_MSGTYPE_UNSUBSCRIBE  0x14
 #define MQTTSN_MSGTYPE_PINGREQ      0x16
@@ -164,25 +165,209 @@ uint32_t mqttsn_packet_fifo_elem_find(mqttsn_client_t        * p_client,
                                       uint16_t                 msg_to_dequeue,
                                       mqttsn_packet_dequeue_t  mode);
 
+/**@brief Checks if every slot of the in-flight window is taken.
+ *
+ * @param[in]    p_client    Pointer to initialized client.
+ *
+ * @retval       true        If no more packets can be enqueued.
+ * @retval       false       Otherwise.
+ */
+bool mqttsn_packet_fifo_is_full(mqttsn_client_t * p_client);
+
+/**@brief Appends a PUBLISH message to the backlog of messages waiting for a free slot.
+ *
+ * @param[inout] p_client         Pointer to initialized client.
+ * @param[in]    p_packet         Pointer to the packet; its message has not been sent yet.
+ *
+ * @retval       NRF_SUCCESS      If the packet has been added to the backlog.
+ * @retval       NRF_ERROR_NO_MEM If the backlog is full.
+ */
+uint32_t mqttsn_packet_fifo_backlog_add(mqttsn_client_t * p_client, mqttsn_packet_t * p_packet);
+
+/**@brief Takes the oldest packet out of the backlog.
+ *
+ * @param[inout] p_client            Pointer to initialized client.
+ * @param[out]   p_packet            Pointer to the taken packet.
+ *
+ * @retval       NRF_SUCCESS         If a packet has been taken.
+ * @retval       NRF_ERROR_NOT_FOUND If the backlog is empty.
+ */
+uint32_t mqttsn_packet_fifo_backlog_get(mqttsn_client_t * p_client, mqttsn_packet_t * p_packet);
+
+
+/***************************************************************************************************
+ * @section TIMER QUEUE
+ **************************************************************************************************/
+
+/**@brief Disarms every timer of the client.
+ *
+ * @param[inout] p_client    Pointer to MQTT-SN client.
+ */
+void mqttsn_timer_queue_init(mqttsn_client_t * p_client);
+
+/**@brief Arms a timer or moves its deadline if it is already armed.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    timer       Timer to arm, see MQTTSN_TIMER_COUNT.
+ * @param[in]    deadline    Timer value the timer expires at. [ms]
+ */
+void mqttsn_timer_queue_set(mqttsn_client_t * p_client, uint8_t timer, uint32_t deadline);
+
+/**@brief Disarms a timer. Does nothing if the timer is not armed.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    timer       Timer to disarm.
+ */
+void mqttsn_timer_queue_cancel(mqttsn_client_t * p_client, uint8_t timer);
+
+/**@brief Gets the armed timer with the earliest deadline.
+ *
+ * @param[in]    p_client            Pointer to initialized client.
+ * @param[out]   p_timer             Timer with the earliest deadline.
+ * @param[out]   p_deadline          Deadline of the timer. [ms]
+ *
+ * @retval       NRF_SUCCESS         If a timer is armed.
+ * @retval       NRF_ERROR_NOT_FOUND If no timer is armed.
+ */
+uint32_t mqttsn_timer_queue_next_get(const mqttsn_client_t * p_client,
+                                     uint8_t               * p_timer,
+                                     uint32_t              * p_deadline);
+
+/**@brief Checks if a deadline has been reached.
+ *
+ * @param[in]    deadline    Deadline to check. [ms]
+ * @param[in]    now         Current timer value. [ms]
+ *
+ * @retval       true        If the deadline is not later than now, also across the counter wrap-around.
+ * @retval       false       Otherwise.
+ */
+static inline bool mqttsn_timer_queue_is_expired(uint32_t deadline, uint32_t now)
+{
+    return (int32_t)(deadline - now) <= 0;
+}
+
+
+/***************************************************************************************************
+ * @section TOPIC REGISTRY
+ **************************************************************************************************/
+
+/**@brief Empties the topic registry without touching the stored copy.
+ *
+ * @param[inout] p_client    Pointer to MQTT-SN client.
+ */
+void mqttsn_topic_registry_init(mqttsn_client_t * p_client);
+
+/**@brief Replaces the topic registry with the one stored for a gateway.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    gateway_id  ID of the gateway.
+ */
+void mqttsn_topic_registry_load(mqttsn_client_t * p_client, uint8_t gateway_id);
+
+/**@brief Looks up a topic name.
+ *
+ * @param[in]    p_client       Pointer to initialized client.
+ * @param[in]    p_topic_name   Topic name.
+ * @param[in]    topic_name_len Topic name length.
+ *
+ * @return       Index of the entry. MQTTSN_TOPIC_REGISTRY_MAX_LENGTH if not found.
+ */
+uint32_t mqttsn_topic_registry_find(const mqttsn_client_t * p_client,
+                                    const uint8_t         * p_topic_name,
+                                    uint16_t                topic_name_len);
+
+/**@brief Adds a topic name with no topic ID, unless it is in the registry already.
+ *
+ * @param[inout] p_client       Pointer to initialized client.
+ * @param[in]    p_topic_name   Topic name.
+ * @param[in]    topic_name_len Topic name length.
+ *
+ * @return       Index of the entry. MQTTSN_TOPIC_REGISTRY_MAX_LENGTH if the registry is full or
+ *               the name is longer than MQTTSN_TOPIC_NAME_MAX_LENGTH.
+ */
+uint32_t mqttsn_topic_registry_add(mqttsn_client_t * p_client,
+                                   const uint8_t   * p_topic_name,
+                                   uint16_t          topic_name_len);
+
+/**@brief Looks up the entry a topic name pointer belongs to.
+ *
+ * @param[in]    p_client       Pointer to initialized client.
+ * @param[in]    p_topic_name   Pointer to check.
+ *
+ * @return       Index of the entry whose name p_topic_name points at. MQTTSN_TOPIC_REGISTRY_MAX_LENGTH
+ *               if it points elsewhere.
+ */
+uint32_t mqttsn_topic_registry_name_find(const mqttsn_client_t * p_client, const uint8_t * p_topic_name);
+
+/**@brief Looks up a topic ID.
+ *
+ * @param[in]    p_client    Pointer to initialized client.
+ * @param[in]    topic_id    Topic ID, not 0.
+ *
+ * @return       Index of the entry. MQTTSN_TOPIC_REGISTRY_MAX_LENGTH if not found.
+ */
+uint32_t mqttsn_topic_registry_id_find(const mqttsn_client_t * p_client, uint16_t topic_id);
+
+/**@brief Sets the topic ID of an entry and stores the registry if it has changed.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    index       Index of the entry.
+ * @param[in]    topic_id    Topic ID assigned by the gateway, 0 if it has been rejected.
+ */
+void mqttsn_topic_registry_id_set(mqttsn_client_t * p_client, uint32_t index, uint16_t topic_id);
+
+
+/***************************************************************************************************
+ * @section RTT
+ **************************************************************************************************/
+
+/**@brief Drops the round-trip time estimate; MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS is used until
+ *        the next sample.
+ *
+ * @param[inout] p_client    Pointer to MQTT-SN client.
+ */
+void mqttsn_rtt_init(mqttsn_client_t * p_client);
+
+/**@brief Updates the round-trip time estimate with the response to a message.
+ *
+ * @details Following Karn's algorithm, responses to retransmitted messages are not sampled, as it
+ *          is not known which transmission they answer.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    p_packet    Pointer to the packet that has been responded to.
+ */
+void mqttsn_rtt_packet_acked(mqttsn_client_t * p_client, const mqttsn_packet_t * p_packet);
+
+/**@brief Gets the time to wait for a response before the next retransmission of a message.
+ *
+ * @details The retransmission time is doubled with every retransmission already made.
+ *
+ * @param[in]    p_client            Pointer to initialized client.
+ * @param[in]    retransmission_cnt  Number of retransmissions left for the message.
+ *
+ * @return       Retransmission time in milliseconds.
+ */
+uint32_t mqttsn_rtt_retransmission_time_get(const mqttsn_client_t * p_client, uint8_t retransmission_cnt);
+
 
 /***************************************************************************************************
  * @section SENDER
  **************************************************************************************************/
 
 /**@brief Retransmits message.
+ *
+ * @note The packet keeps its content, so it can be retransmitted again.
  *
  * @param[inout] p_client    Pointer to initialized client.
  * @param[in]    p_remote    Pointer to remote endpoint.
- * @param[in]    p_data      Pointer to the data to be retransmitted.
- * @param[in]    datalen     Length of the data to be retransmitted.
+ * @param[in]    p_packet    Pointer to the packet to be retransmitted.
  *
  * @return       NRF_SUCCESS if the message has been sent successfully.
  *               Otherwise error code is returned.
  */
 uint32_t mqttsn_packet_sender_retransmit(mqttsn_client_t       * p_client,
                                          const mqttsn_remote_t * p_remote,
-                                         const uint8_t         * p_data,
-                                         uint16_t                datalen);
+                                         const mqttsn_packet_t * p_packet);
 
 /**@brief Sends SEARCHGW message.
  *
@@ -249,20 +434,105 @@ uint32_t mqttsn_packet_sender_regack(mqttsn_client_t * p_client,
                                      uint8_t           ret_code);
 
 /**@brief Sends PUBLISH message.
+ *
+ * @details If the in-flight window is full, the serialized message is put in the backlog and
+ *          sent by @ref mqttsn_packet_sender_backlog_flush once a slot is free.
  *
  * @param[inout] p_client    Pointer to initialized client.
  * @param[in]    p_topic     Pointer to topic to publish on.
+ * @param[in]    qos         QoS level, 1 or 2.
  * @param[in]    p_payload   Pointer to the data to be published.
  * @param[in]    payloadlen  Length of the data to be published.
  *
- * @return       NRF_SUCCESS if the message has been sent successfully.
+ * @return       NRF_SUCCESS if the message has been sent or put in the backlog successfully.
  *               Otherwise error code is returned.
  */
 uint32_t mqttsn_packet_sender_publish(mqttsn_client_t * p_client,
                                       mqttsn_topic_t  * p_topic,
+                                      uint8_t           qos,
                                       const uint8_t   * p_payload,
                                       uint16_t          payloadlen);
 
+/**@brief Sends PUBLISH message with QoS -1 to a predefined topic.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    p_remote    Pointer to remote endpoint.
+ * @param[in]    p_topic     Pointer to predefined topic to publish on.
+ * @param[in]    p_payload   Pointer to the data to be published.
+ * @param[in]    payloadlen  Length of the data to be published.
+ *
+ * @return       NRF_SUCCESS if the message has been sent successfully.
+ *               Otherwise error code is returned.
+ */
+uint32_t mqttsn_packet_sender_qos_negative_one_publish(mqttsn_client_t       * p_client,
+                                                       const mqttsn_remote_t * p_remote,
+                                                       mqttsn_topic_t        * p_topic,
+                                                       const uint8_t         * p_payload,
+                                                       uint16_t                payloadlen);
+
+/**@brief Sends PUBREC message in response to a QoS 2 PUBLISH message.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    packet_id   Message ID of the PUBLISH message.
+ *
+ * @return       NRF_SUCCESS if the message has been sent successfully.
+ *               Otherwise error code is returned.
+ */
+uint32_t mqttsn_packet_sender_pubrec(mqttsn_client_t * p_client, uint16_t packet_id);
+
+/**@brief Sends PUBREL message and keeps it for retransmission until PUBCOMP arrives.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    packet_id   Message ID of the QoS 2 PUBLISH message.
+ * @param[in]    p_topic     Topic of the QoS 2 PUBLISH message, reported once PUBCOMP arrives.
+ *
+ * @return       NRF_SUCCESS if the message has been sent successfully.
+ *               Otherwise error code is returned.
+ */
+uint32_t mqttsn_packet_sender_pubrel(mqttsn_client_t      * p_client,
+                                     uint16_t               packet_id,
+                                     const mqttsn_topic_t * p_topic);
+
+/**@brief Sends PUBCOMP message in response to a PUBREL message.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    packet_id   Message ID of the QoS 2 PUBLISH message.
+ *
+ * @return       NRF_SUCCESS if the message has been sent successfully.
+ *               Otherwise error code is returned.
+ */
+uint32_t mqttsn_packet_sender_pubcomp(mqttsn_client_t * p_client, uint16_t packet_id);
+
+/**@brief Adds PUBLISH message to the current batch.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    p_topic     Pointer to topic to publish on.
+ * @param[in]    p_payload   Pointer to the data to be published.
+ * @param[in]    payloadlen  Length of the data to be published.
+ *
+ * @return       NRF_SUCCESS if the message has been added to the batch or sent successfully.
+ *               Otherwise error code is returned.
+ */
+uint32_t mqttsn_packet_sender_batch_publish(mqttsn_client_t * p_client,
+                                            mqttsn_topic_t  * p_topic,
+                                            const uint8_t   * p_payload,
+                                            uint16_t          payloadlen);
+
+/**@brief Sends the current batch of PUBLISH messages, if there is one.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ *
+ * @return       NRF_SUCCESS if the batch has been sent successfully or was empty.
+ *               Otherwise error code is returned.
+ */
+uint32_t mqttsn_packet_sender_batch_flush(mqttsn_client_t * p_client);
+
+/**@brief Sends PUBLISH messages from the backlog while there are free slots in the in-flight window.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ */
+void mqttsn_packet_sender_backlog_flush(mqttsn_client_t * p_client);
+
 /**@brief Sends PUBACK message.
  *
  * @param[inout] p_client    Pointer to initialized client.
@@ -370,6 +640,22 @@ uint32_t mqttsn_packet_msgtype_index_get(const uint8_t * p_buffer);
  */
 mqttsn_ack_error_t mqttsn_packet_msgtype_error_get(const uint8_t * p_buffer);
 
+/**@brief Returns type of retranmission error for a given message type.
+ *
+ * @param[in]    msg_type Type of the message that has not been acknowledged.
+ *
+ * @return       Type of retransmission error.
+ */
+mqttsn_ack_error_t mqttsn_packet_msgtype_to_error(uint8_t msg_type);
+
+/**@brief Returns type of retranmission error for a packet awaiting acknowledgement.
+ *
+ * @param[in]    p_packet Pointer to the packet that has not been acknowledged.
+ *
+ * @return       Type of retransmission error.
+ */
+mqttsn_ack_error_t mqttsn_packet_error_get(const mqttsn_packet_t * p_packet);
+
 /***************************************************************************************************
  * @section CLIENT INTERNAL
  **************************************************************************************************/
@@ -386,6 +672,17 @@ uint32_t mqttsn_client_timeout_schedule(mqttsn_client_t * p_client);
  */
 void mqttsn_client_timeout_handle(mqttsn_client_t * p_client);
 
+/**@brief Requests the data poll period matching the client's state from the transport.
+ *
+ * @details A sleeping client polls once per sleep duration, so the data poll and the PINGREQ
+ *          wake-up happen together. While a PINGRESP, the sleep permission or an acknowledgement
+ *          is pending, the client polls every MQTTSN_FAST_POLL_PERIOD_IN_MS. Awake clients leave
+ *          the poll period to the link.
+ *
+ * @param[inout] p_client Pointer to MQTT-SN client instance.
+ */
+void mqttsn_client_poll_period_update(mqttsn_client_t * p_client);
+
 /**@brief Launches the gateway discovery procedure.  
  *
  * @param[inout] p_client    Pointer to MQTT-SN client instance.
@@ -41,7 +41,6 @@
 #include "MQTTSNPacket.h"
 #include "mqttsn_packet_internal.h"
 #include "mqttsn_platform.h"
-#include "mem_manager.h"
 #include "nrf_assert.h"
 #include "nrf_error.h"
 #include "nrf_log.h"
@@ -49,9 +48,6 @@
 
 #define MQTTSN_PACKET_PINGREQ_LENGTH 2
 
-/**@brief PINGREQ message buffer. */
-static uint8_t mp_pingreq_msg[MQTTSN_PACKET_PINGREQ_LENGTH + MQTTSN_CLIENT_ID_MAX_LENGTH];
-
 uint32_t mqttsn_packet_msgtype_index_get(const uint8_t * p_buffer)
 {
     if (p_buffer[0] == MQTTSN_TWO_BYTE_LENGTH_CODE)
@@ -66,8 +62,11 @@ uint32_t mqttsn_packet_msgtype_index_get(const uint8_t * p_buffer)
 
 mqttsn_ack_error_t mqttsn_packet_msgtype_error_get(const uint8_t * p_buffer)
 {
-    uint32_t msg_type = p_buffer[mqttsn_packet_msgtype_index_get(p_buffer)];
-    
+    return mqttsn_packet_msgtype_to_error(p_buffer[mqttsn_packet_msgtype_index_get(p_buffer)]);
+}
+
+mqttsn_ack_error_t mqttsn_packet_msgtype_to_error(uint8_t msg_type)
+{
     switch (msg_type)
     {
         case 0x04:
@@ -79,6 +78,9 @@ mqttsn_ack_error_t mqttsn_packet_msgtype_error_get(const uint8_t * p_buffer)
         case 0x0c:
             return MQTTSN_PACKET_PUBACK;
 
+        case 0x10:
+            return MQTTSN_PACKET_PUBCOMP;
+
         case 0x12:
             return MQTTSN_PACKET_SUBACK;
 
@@ -99,34 +101,38 @@ mqttsn_ack_error_t mqttsn_packet_msgtype_error_get(const uint8_t * p_buffer)
     }
 }
 
+mqttsn_ack_error_t mqttsn_packet_error_get(const mqttsn_packet_t * p_packet)
+{
+    if ((p_packet->msg_type == MQTTSN_MSGTYPE_PUBLISH) && (p_packet->qos == 2))
+    {
+        return MQTTSN_PACKET_PUBREC;
+    }
+
+    return mqttsn_packet_msgtype_to_error(p_packet->msg_type);
+}
+
 /**@brief Creates keep-alive PINGREQ packet.  
  *
  * @param[inout] p_client Pointer to an MQTT-SN client instance. 
  */
 static void pingreq_packet_create(mqttsn_client_t * p_client)
 {
-    MQTTSNString client_id = MQTTSNString_initializer;
-    client_id.cstring      = nrf_malloc(MQTTSN_CLIENT_ID_MAX_LENGTH);
-    if (client_id.cstring == NULL)
-    {
-        return;
-    }
+    MQTTSNString client_id   = MQTTSNString_initializer;
+    client_id.lenstring.data = (char *)p_client->connect_info.p_client_id;
+    client_id.lenstring.len  = p_client->connect_info.client_id_len;
 
-    memset(client_id.cstring, 0, MQTTSN_CLIENT_ID_MAX_LENGTH);
-    memcpy(client_id.cstring, p_client->connect_info.p_client_id, p_client->connect_info.client_id_len);
     uint16_t pingreq_len = MQTTSN_PACKET_PINGREQ_LENGTH + p_client->connect_info.client_id_len;
-    uint16_t datalen     = MQTTSNSerialize_pingreq(mp_pingreq_msg, pingreq_len, client_id);
+    uint16_t datalen     = MQTTSNSerialize_pingreq(p_client->keep_alive.pingreq, pingreq_len, client_id);
     if (datalen == 0)
     {
-        nrf_free(client_id.cstring);
         return;
     }
     
     p_client->keep_alive.message.retransmission_cnt = MQTTSN_DEFAULT_RETRANSMISSION_CNT + 1;
-    p_client->keep_alive.message.p_data             = mp_pingreq_msg;
+    p_client->keep_alive.message.msg_type           = MQTTSN_MSGTYPE_PINGREQ;
+    p_client->keep_alive.message.p_data             = p_client->keep_alive.pingreq;
     p_client->keep_alive.message.len                = datalen;
-
-    nrf_free(client_id.cstring);
+    p_client->keep_alive.message.p_message          = NULL;
 }
 
 /**@brief Handles GWINFO message received from the gateway. 
@@ -219,6 +225,7 @@ static uint32_t connack_handle(mqttsn_client_t * p_client,
             pingreq_packet_create(p_client);
             p_client->keep_alive.duration = p_client->connect_info.alive_duration * 1000;
             p_client->keep_alive.timeout  = mqttsn_platform_timer_set_in_ms(p_client->keep_alive.duration);
+            mqttsn_timer_queue_set(p_client, MQTTSN_TIMER_KEEP_ALIVE, p_client->keep_alive.timeout);
        
             if (mqttsn_client_timeout_schedule(p_client) != NRF_SUCCESS)
             {
@@ -365,14 +372,22 @@ static uint32_t regack_handle(mqttsn_client_t * p_client,
                 return NRF_ERROR_INTERNAL;
             }
 
-            uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client, packet_id, MQTTSN_MESSAGE_ID);
-            ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
-
             mqttsn_topic_t topic;
             memset(&topic, 0, sizeof(mqttsn_topic_t));
             topic.topic_id     = topic_id;
             topic.p_topic_name = p_client->packet_queue.packet[index].topic.p_topic_name;
 
+            mqttsn_rtt_packet_acked(p_client, &(p_client->packet_queue.packet[index]));
+
+            uint32_t registry_index = mqttsn_topic_registry_name_find(p_client, topic.p_topic_name);
+            if (registry_index != MQTTSN_TOPIC_REGISTRY_MAX_LENGTH)
+            {
+                mqttsn_topic_registry_id_set(p_client, registry_index, topic_id);
+            }
+
+            uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client, packet_id, MQTTSN_MESSAGE_ID);
+            ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
+
             mqttsn_event_t evt_acc;
             memset(&evt_acc, 0, sizeof(mqttsn_event_t));
             evt_acc.event_id                           = MQTTSN_EVENT_REGISTERED;
@@ -390,6 +405,39 @@ static uint32_t regack_handle(mqttsn_client_t * p_client,
     }
 }
 
+/**@brief Looks up a received QoS 2 PUBLISH message that has not been released yet.
+ *
+ * @param[in]    p_client    Pointer to an MQTT-SN client instance.
+ * @param[in]    packet_id   Message ID of the PUBLISH message.
+ *
+ * @return       Index of the message. MQTTSN_QOS2_RECEIVED_MAX_LENGTH if not found.
+ */
+static uint32_t qos2_received_find(const mqttsn_client_t * p_client, uint16_t packet_id)
+{
+    for (uint32_t i = 0; i < MQTTSN_QOS2_RECEIVED_MAX_LENGTH; i++)
+    {
+        if ((packet_id != 0) && (p_client->qos2_received.id[i] == packet_id))
+        {
+            return i;
+        }
+    }
+
+    return MQTTSN_QOS2_RECEIVED_MAX_LENGTH;
+}
+
+/**@brief Remembers a received QoS 2 PUBLISH message until it is released, replacing the oldest one.
+ *
+ * @param[inout] p_client    Pointer to an MQTT-SN client instance.
+ * @param[in]    packet_id   Message ID of the PUBLISH message.
+ */
+static void qos2_received_add(mqttsn_client_t * p_client, uint16_t packet_id)
+{
+    mqttsn_qos2_received_t * p_received = &p_client->qos2_received;
+
+    p_received->id[p_received->next] = packet_id;
+    p_received->next                 = (p_received->next + 1) % MQTTSN_QOS2_RECEIVED_MAX_LENGTH;
+}
+
 /**@brief Handles PUBLISH message received from the gateway.  
  *
  * @param[inout] p_client    Pointer to an MQTT-SN client instance. 
@@ -406,20 +454,20 @@ static uint32_t publish_handle(mqttsn_client_t * p_client,
 {
     uint32_t  err_code    = NRF_SUCCESS;
     uint16_t  packet_id   = 0;
-    uint32_t  payload_len = 0;
-    uint8_t   qos         = 0;
+    int       payload_len = 0;
+    int       qos         = 0;
     uint8_t   dup         = 0;
     uint8_t   retained    = 0;
     uint8_t * p_payload;
     MQTTSN_topicid ret_topic;
 
     if (MQTTSNDeserialize_publish(&dup,
-                                  (int *)(&qos),
+                                  &qos,
                                   &retained,
                                   (short unsigned int *)(&packet_id),
                                   &ret_topic,
                                   &p_payload,
-                                  (int *)(&payload_len),
+                                  &payload_len,
                                   (unsigned char *)p_data,
                                   datalen) == 0)
     {
@@ -427,10 +475,22 @@ static uint32_t publish_handle(mqttsn_client_t * p_client,
         return NRF_ERROR_INTERNAL;
     }
 
-    if (qos > 0)
+    if (qos == 1)
     {
         err_code = mqttsn_packet_sender_puback(p_client, ret_topic.data.id, packet_id, MQTTSN_RC_ACCEPTED);
     }
+    else if (qos == 2)
+    {
+        err_code = mqttsn_packet_sender_pubrec(p_client, packet_id);
+
+        /* The message is delivered on its first arrival; retransmissions before PUBREL are dropped. */
+        if (qos2_received_find(p_client, packet_id) != MQTTSN_QOS2_RECEIVED_MAX_LENGTH)
+        {
+            return err_code;
+        }
+
+        qos2_received_add(p_client, packet_id);
+    }
 
     mqttsn_topic_t topic = { .topic_id = ret_topic.data.id };
 
@@ -438,6 +498,7 @@ static uint32_t publish_handle(mqttsn_client_t * p_client,
     memset(&evt, 0, sizeof(mqttsn_event_t));
     evt.event_id                          = MQTTSN_EVENT_RECEIVED;
     evt.event_data.published.packet.id    = packet_id;
+    evt.event_data.published.packet.qos   = qos;
     evt.event_data.published.packet.topic = topic;
     evt.event_data.published.p_payload    = p_payload;
 
@@ -497,30 +558,196 @@ static uint32_t puback_handle(mqttsn_client_t * p_client,
 
         case MQTTSN_RC_ACCEPTED:
         {
-            if (mqttsn_packet_fifo_elem_find(p_client, packet_id, MQTTSN_MESSAGE_ID) == MQTTSN_PACKET_FIFO_MAX_LENGTH)
+            uint32_t index = mqttsn_packet_fifo_elem_find(p_client, packet_id, MQTTSN_MESSAGE_ID);
+            if (index == MQTTSN_PACKET_FIFO_MAX_LENGTH)
             {
                 NRF_LOG_ERROR("PUBACK packet ID has unexpected value.\r\n");
                 return NRF_ERROR_INTERNAL;
             }
+
+            mqttsn_rtt_packet_acked(p_client, &(p_client->packet_queue.packet[index]));
+
+            mqttsn_event_t evt_acc;
+            memset(&evt_acc, 0, sizeof(mqttsn_event_t));
+            evt_acc.event_id                          = MQTTSN_EVENT_PUBLISHED;
+            evt_acc.event_data.published.packet.id    = packet_id;
+            evt_acc.event_data.published.packet.qos   = p_client->packet_queue.packet[index].qos;
+            evt_acc.event_data.published.packet.topic = p_client->packet_queue.packet[index].topic;
     
             uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client, packet_id, MQTTSN_MESSAGE_ID) ;
             ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
 
-            mqttsn_event_t evt_acc =
-            {
-                .event_id = MQTTSN_EVENT_PUBLISHED
-            };
             p_client->evt_handler(p_client, &evt_acc);
 
             return NRF_SUCCESS;
         }
 
+        case MQTTSN_RC_REJECTED_INVALID_TOPIC_ID:
+        {
+            NRF_LOG_INFO("Publish message was rejected. Reason: invalid topic ID.\r\n");
+
+            (void)mqttsn_packet_fifo_elem_dequeue(p_client, packet_id, MQTTSN_MESSAGE_ID);
+
+            /* The gateway has forgotten the topic: register the cached name again. */
+            uint32_t registry_index = mqttsn_topic_registry_id_find(p_client, topic_id);
+            if (registry_index != MQTTSN_TOPIC_REGISTRY_MAX_LENGTH)
+            {
+                mqttsn_topic_t topic;
+                memset(&topic, 0, sizeof(mqttsn_topic_t));
+                topic.p_topic_name = p_client->topic_registry.name[registry_index];
+
+                mqttsn_topic_registry_id_set(p_client, registry_index, 0);
+
+                if (mqttsn_packet_sender_register(p_client,
+                                                  &topic,
+                                                  p_client->topic_registry.name_len[registry_index]) !=
+                    NRF_SUCCESS)
+                {
+                    NRF_LOG_ERROR("Topic could not be registered again.\r\n");
+                }
+            }
+
+            mqttsn_event_t evt_rc;
+            memset(&evt_rc, 0, sizeof(mqttsn_event_t));
+            evt_rc.event_id                  = MQTTSN_EVENT_TIMEOUT;
+            evt_rc.event_data.error.error    = MQTTSN_ERROR_REJECTED_TOPIC_ID;
+            evt_rc.event_data.error.msg_type = MQTTSN_PACKET_PUBACK;
+            evt_rc.event_data.error.msg_id   = packet_id;
+
+            p_client->evt_handler(p_client, &evt_rc);
+
+            return NRF_SUCCESS;
+        }
+
         default:
             NRF_LOG_ERROR("Publish message was rejected. Reason: %d\r\n", return_code);
             return NRF_ERROR_INTERNAL;
     }
 }
 
+/**@brief Handles PUBREC message received from the gateway.
+ *
+ * @param[inout] p_client    Pointer to an MQTT-SN client instance.
+ * @param[in]    p_data      Received data.
+ * @param[in]    datalen     Length of the received data.
+ *
+ * @retval       NRF_SUCCESS        If PUBREL message was sent in response or has been sent already.
+ * @retval       NRF_ERROR_INTERNAL Otherwise.
+ */
+static uint32_t pubrec_handle(mqttsn_client_t * p_client,
+                              const uint8_t   * p_data,
+                              uint16_t          datalen)
+{
+    uint8_t  packet_type = 0;
+    uint16_t packet_id   = 0;
+
+    if (MQTTSNDeserialize_ack(&packet_type, &packet_id, (unsigned char *)p_data, datalen) == 0)
+    {
+        NRF_LOG_ERROR("PUBREC packet cannot be deserialized.\r\n");
+        return NRF_ERROR_INTERNAL;
+    }
+
+    uint32_t index = mqttsn_packet_fifo_elem_find(p_client, packet_id, MQTTSN_MESSAGE_ID);
+    if (index == MQTTSN_PACKET_FIFO_MAX_LENGTH)
+    {
+        NRF_LOG_ERROR("PUBREC packet ID has unexpected value.\r\n");
+        return NRF_ERROR_INTERNAL;
+    }
+
+    /* PUBREC to a retransmitted PUBLISH message; PUBREL is retransmitted on its own. */
+    if (p_client->packet_queue.packet[index].msg_type == MQTTSN_MSGTYPE_PUBREL)
+    {
+        return NRF_SUCCESS;
+    }
+
+    mqttsn_rtt_packet_acked(p_client, &(p_client->packet_queue.packet[index]));
+
+    mqttsn_topic_t topic = p_client->packet_queue.packet[index].topic;
+
+    uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client, packet_id, MQTTSN_MESSAGE_ID);
+    ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
+
+    return mqttsn_packet_sender_pubrel(p_client, packet_id, &topic);
+}
+
+/**@brief Handles PUBREL message received from the gateway.
+ *
+ * @param[inout] p_client    Pointer to an MQTT-SN client instance.
+ * @param[in]    p_data      Received data.
+ * @param[in]    datalen     Length of the received data.
+ *
+ * @retval       NRF_SUCCESS        If PUBCOMP message was sent successfully in response.
+ * @retval       NRF_ERROR_INTERNAL Otherwise.
+ */
+static uint32_t pubrel_handle(mqttsn_client_t * p_client,
+                              const uint8_t   * p_data,
+                              uint16_t          datalen)
+{
+    uint8_t  packet_type = 0;
+    uint16_t packet_id   = 0;
+
+    if (MQTTSNDeserialize_ack(&packet_type, &packet_id, (unsigned char *)p_data, datalen) == 0)
+    {
+        NRF_LOG_ERROR("PUBREL packet cannot be deserialized.\r\n");
+        return NRF_ERROR_INTERNAL;
+    }
+
+    uint32_t index = qos2_received_find(p_client, packet_id);
+    if (index != MQTTSN_QOS2_RECEIVED_MAX_LENGTH)
+    {
+        p_client->qos2_received.id[index] = 0;
+    }
+
+    return mqttsn_packet_sender_pubcomp(p_client, packet_id);
+}
+
+/**@brief Handles PUBCOMP message received from the gateway.
+ *
+ * @param[inout] p_client    Pointer to an MQTT-SN client instance.
+ * @param[in]    p_data      Received data.
+ * @param[in]    datalen     Length of the received data.
+ *
+ * @retval       NRF_SUCCESS        If PUBCOMP message was processed successfully.
+ * @retval       NRF_ERROR_INTERNAL Otherwise.
+ */
+static uint32_t pubcomp_handle(mqttsn_client_t * p_client,
+                               const uint8_t   * p_data,
+                               uint16_t          datalen)
+{
+    uint8_t  packet_type = 0;
+    uint16_t packet_id   = 0;
+
+    if (MQTTSNDeserialize_ack(&packet_type, &packet_id, (unsigned char *)p_data, datalen) == 0)
+    {
+        NRF_LOG_ERROR("PUBCOMP packet cannot be deserialized.\r\n");
+        return NRF_ERROR_INTERNAL;
+    }
+
+    uint32_t index = mqttsn_packet_fifo_elem_find(p_client, packet_id, MQTTSN_MESSAGE_ID);
+    if ((index == MQTTSN_PACKET_FIFO_MAX_LENGTH) ||
+        (p_client->packet_queue.packet[index].msg_type != MQTTSN_MSGTYPE_PUBREL))
+    {
+        NRF_LOG_ERROR("PUBCOMP packet ID has unexpected value.\r\n");
+        return NRF_ERROR_INTERNAL;
+    }
+
+    mqttsn_rtt_packet_acked(p_client, &(p_client->packet_queue.packet[index]));
+
+    mqttsn_event_t evt;
+    memset(&evt, 0, sizeof(mqttsn_event_t));
+    evt.event_id                          = MQTTSN_EVENT_PUBLISHED;
+    evt.event_data.published.packet.id    = packet_id;
+    evt.event_data.published.packet.qos   = p_client->packet_queue.packet[index].qos;
+    evt.event_data.published.packet.topic = p_client->packet_queue.packet[index].topic;
+
+    uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client, packet_id, MQTTSN_MESSAGE_ID);
+    ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
+
+    p_client->evt_handler(p_client, &evt);
+
+    return NRF_SUCCESS;
+}
+
 /**@brief Handles SUBACK message received from the gateway.  
  *
  * @param[inout] p_client    Pointer to an MQTT-SN client instance. 
@@ -652,10 +879,13 @@ static uint32_t pingresp_handle(mqttsn_client_t * p_client)
 {
     if (p_client->keep_alive.response_arrived == 0)
     {
+        mqttsn_rtt_packet_acked(p_client, &(p_client->keep_alive.message));
+
         p_client->keep_alive.message.retransmission_cnt = MQTTSN_DEFAULT_RETRANSMISSION_CNT + 1;
         p_client->keep_alive.response_arrived           = 1;
         p_client->keep_alive.timeout                    =
             mqttsn_platform_timer_set_in_ms(p_client->keep_alive.duration);
+        mqttsn_timer_queue_set(p_client, MQTTSN_TIMER_KEEP_ALIVE, p_client->keep_alive.timeout);
 
         mqttsn_client_state_update(p_client, RECEIVED_PINGRESP);
 
@@ -686,7 +916,7 @@ static uint32_t disconnect_handle(mqttsn_client_t * p_client)
     {
         case MQTTSN_CLIENT_WAITING_FOR_DISCONNECT:
         {
-            uint32_t timer_stop_rc = mqttsn_platform_timer_stop();
+            uint32_t timer_stop_rc = mqttsn_platform_timer_stop(p_client);
             ASSERT(timer_stop_rc == NRF_SUCCESS);
 
             mqttsn_client_state_update(p_client, RECEIVED_DISCONNECT_PERMISSION);
@@ -704,6 +934,7 @@ static uint32_t disconnect_handle(mqttsn_client_t * p_client)
         {
             p_client->keep_alive.timeout =
                 mqttsn_platform_timer_set_in_ms(p_client->keep_alive.duration);
+            mqttsn_timer_queue_set(p_client, MQTTSN_TIMER_KEEP_ALIVE, p_client->keep_alive.timeout);
 
             mqttsn_client_state_update(p_client, RECEIVED_SLEEP_PERMISSION);
  
@@ -920,6 +1151,18 @@ static uint32_t message_handle(mqttsn_client_t        * p_client,
             err_code = puback_handle(p_client, p_data, datalen);
             break;
 
+        case MQTTSN_PUBREC:
+            err_code = pubrec_handle(p_client, p_data, datalen);
+            break;
+
+        case MQTTSN_PUBREL:
+            err_code = pubrel_handle(p_client, p_data, datalen);
+            break;
+
+        case MQTTSN_PUBCOMP:
+            err_code = pubcomp_handle(p_client, p_data, datalen);
+            break;
+
         case MQTTSN_SUBACK:
             err_code = suback_handle(p_client, p_data, datalen);
             break;
@@ -959,6 +1202,36 @@ uint32_t mqttsn_packet_receiver(mqttsn_client_t        * p_client,
                                 const uint8_t          * p_data,
                                 uint16_t                 datalen)
 {
-    MQTTSN_msgTypes msg_type = (MQTTSN_msgTypes)p_data[mqttsn_packet_msgtype_index_get(p_data)];
-    return message_handle(p_client, p_port, p_remote, p_data, datalen, msg_type);
+    uint32_t err_code = NRF_SUCCESS;
+
+    /* A datagram may carry several messages back to back, e.g. batched acknowledgements. */
+    while (datalen > 0)
+    {
+        int packet_len   = 0;
+        int length_bytes = MQTTSNPacket_decode((unsigned char *)p_data, datalen, &packet_len);
+
+        if ((length_bytes <= 0) || (packet_len <= length_bytes) || (packet_len > datalen))
+        {
+            NRF_LOG_ERROR("Malformed message length. Rest of the datagram dropped.\r\n");
+            err_code = NRF_ERROR_INVALID_LENGTH;
+            break;
+        }
+
+        MQTTSN_msgTypes msg_type = (MQTTSN_msgTypes)p_data[mqttsn_packet_msgtype_index_get(p_data)];
+        uint32_t        rc       = message_handle(p_client, p_port, p_remote, p_data, packet_len, msg_type);
+
+        if (rc != NRF_SUCCESS)
+        {
+            err_code = rc;
+        }
+
+        p_data  += packet_len;
+        datalen -= packet_len;
+    }
+
+    /* Acknowledgements free slots in the in-flight window. */
+    mqttsn_packet_sender_backlog_flush(p_client);
+    mqttsn_client_poll_period_update(p_client);
+
+    return err_code;
 }
@@ -43,25 +43,21 @@
 #include "mqttsn_packet_internal.h"
 #include "mqttsn_transport.h"
 #include "mqttsn_platform.h"
-#include "mem_manager.h"
 #include "nrf_assert.h"
 #include "nrf_error.h"
 #include "nrf_log.h"
+#include <string.h>
 
-#define MQTTSN_PACKET_SEARCHGW_LENGTH     3
-#define MQTTSN_PACKET_CONNECT_LENGTH     (6 + MQTTSN_CLIENT_ID_MAX_LENGTH)
-#define MQTTSN_PACKET_WILLTOPIC_LENGTH    3
-#define MQTTSN_PACKET_WILLMSG_LENGTH      2
-#define MQTTSN_PACKET_REGISTER_LENGTH     6
-#define MQTTSN_PACKET_REGACK_LENGTH       7
-#define MQTTSN_PACKET_PUBLISH_LENGTH      7
-#define MQTTSN_PACKET_PUBACK_LENGTH       7
-#define MQTTSN_PACKET_SUBSCRIBE_LENGTH    5
-#define MQTTSN_PACKET_UNSUBSCRIBE_LENGTH  5
-#define MQTTSN_PACKET_DISCONNECT_LENGTH   2
-#define MQTTSN_PACKET_WILLTOPICUPD_LENGTH 4
-#define MQTTSN_PACKET_WILLMSGUPD_LENGTH   4
-#define MQTTSN_PACKET_DISCONNECT_DURATION -1
+#define MQTTSN_PACKET_PUBLISH_HEADER_MAX_LENGTH 9
+#define MQTTSN_PACKET_DISCONNECT_DURATION       -1
+#define MQTTSN_QOS_NEGATIVE_ONE                 3
+
+/**@brief Buffer control packets are serialized into before being copied into a transport message.
+ *
+ * @note Packets are serialized and handed over to the transport before the sender returns, so one
+ *       static buffer is enough. PUBLISH payloads are appended to the transport message directly.
+ */
+static uint8_t m_tx_buffer[MQTTSN_TX_BUFFER_SIZE];
 
 /**@brief Calculates next message ID. 
  *
@@ -92,658 +88,740 @@ static uint32_t mqttsn_packet_sender_send(mqttsn_client_t       * p_client,
     return mqttsn_transport_write(p_client, p_remote, p_data, datalen);
 }
 
-uint32_t mqttsn_packet_sender_retransmit(mqttsn_client_t       * p_client,
-                                         const mqttsn_remote_t * p_remote,
-                                         const uint8_t         * p_data,
-                                         uint16_t                datalen)
+/**@brief Creates a transport message holding the packet serialized into the transmit buffer.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    datalen     Length of the serialized packet.
+ *
+ * @return       Pointer to the message. NULL if it could not be allocated.
+ */
+static mqttsn_message_t * tx_buffer_message_create(mqttsn_client_t * p_client, uint16_t datalen)
 {
-    return mqttsn_packet_sender_send(p_client, p_remote, p_data, datalen);
+    mqttsn_message_t * p_message = mqttsn_transport_message_alloc(p_client);
+
+    if ((p_message != NULL) &&
+        (mqttsn_transport_message_append(p_message, m_tx_buffer, datalen) != NRF_SUCCESS))
+    {
+        mqttsn_transport_message_free(p_message);
+        p_message = NULL;
+    }
+
+    return p_message;
 }
 
-uint32_t mqttsn_packet_sender_searchgw(mqttsn_client_t * p_client)
+/**@brief Enqueues a packet awaiting acknowledgement.
+ *
+ * @note The message is kept by the queue on success and freed otherwise. Packets without message
+ *       ID are dequeued by message type.
+ *
+ * @param[inout] p_client    Pointer to initialized and connected client.
+ * @param[in]    p_message   Pointer to the message to keep for retransmission.
+ * @param[in]    msg_type    MQTT-SN message type of the packet.
+ * @param[in]    p_packet    Pointer to packet information (message ID and topic) to enqueue.
+ * @param[in]    delay_ms    Time after which the message is sent. The retransmission time is added.
+ *
+ * @return       NRF_SUCCESS if the packet has been enqueued successfully.
+ *               Otherwise error code is returned.
+ */
+static uint32_t packet_enqueue(mqttsn_client_t  * p_client,
+                               mqttsn_message_t * p_message,
+                               uint8_t            msg_type,
+                               mqttsn_packet_t  * p_packet,
+                               uint32_t           delay_ms)
 {
-    unsigned char radius   = 1;
-    uint32_t      err_code = NRF_SUCCESS;
-    uint8_t     * p_data   = nrf_malloc(MQTTSN_PACKET_SEARCHGW_LENGTH);
+    p_packet->retransmission_cnt = MQTTSN_DEFAULT_RETRANSMISSION_CNT;
+    p_packet->msg_type           = msg_type;
+    p_packet->p_message          = p_message;
+    p_packet->sent               = mqttsn_platform_timer_set_in_ms(delay_ms);
+    p_packet->timeout            = p_packet->sent +
+        mqttsn_rtt_retransmission_time_get(p_client, MQTTSN_DEFAULT_RETRANSMISSION_CNT);
 
-    do
+    if (mqttsn_packet_fifo_elem_add(p_client, p_packet) != NRF_SUCCESS)
     {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("SEARCHGW message cannot be allocated\r\n");
-            break;
-        }
+        mqttsn_transport_message_free(p_message);
+        return NRF_ERROR_NO_MEM;
+    }
 
-        uint16_t datalen = MQTTSNSerialize_searchgw(p_data, MQTTSN_PACKET_SEARCHGW_LENGTH, radius);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
+    if (mqttsn_client_timeout_schedule(p_client) != NRF_SUCCESS)
+    {
+        uint32_t fifo_dequeue_rc = (p_packet->id != 0) ?
+            mqttsn_packet_fifo_elem_dequeue(p_client, p_packet->id, MQTTSN_MESSAGE_ID) :
+            mqttsn_packet_fifo_elem_dequeue(p_client, msg_type, MQTTSN_MESSAGE_TYPE);
+        ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
+        return NRF_ERROR_INTERNAL;
+    }
 
-        const mqttsn_remote_t broadcast_search =
-        {
-            .addr        = MQTTSN_BROADCAST_ADDR,
-            .port_number = MQTTSN_DEFAULT_CLIENT_PORT,
-        };
+    return NRF_SUCCESS;
+}
 
-        err_code = mqttsn_packet_sender_send(p_client, &broadcast_search, p_data, datalen);
+/**@brief Enqueues a copy of the message for retransmission and sends the message to the gateway.
+ *
+ * @note The message is always consumed. Once the copy is enqueued, a failed first transmission is
+ *       handled like a lost message: it is retransmitted and ends in a timeout if never answered.
+ *
+ * @param[inout] p_client    Pointer to initialized and connected client.
+ * @param[in]    p_message   Pointer to the message to send.
+ * @param[in]    msg_type    MQTT-SN message type of the packet.
+ * @param[in]    p_packet    Pointer to packet information (message ID and topic) to enqueue.
+ *
+ * @return       NRF_SUCCESS if the message has been enqueued for retransmission.
+ *               Otherwise error code is returned and the message is not sent.
+ */
+static uint32_t mqttsn_packet_sender_send_with_retransmission(mqttsn_client_t  * p_client,
+                                                              mqttsn_message_t * p_message,
+                                                              uint8_t            msg_type,
+                                                              mqttsn_packet_t  * p_packet)
+{
+    mqttsn_message_t * p_message_copy = mqttsn_transport_message_clone(p_message);
+    if (p_message_copy == NULL)
+    {
+        mqttsn_transport_message_free(p_message);
+        return NRF_ERROR_NO_MEM;
+    }
 
-    } while (0);
+    uint32_t err_code = packet_enqueue(p_client,
+                                       p_message_copy,
+                                       msg_type,
+                                       p_packet,
+                                       0);
+    if (err_code != NRF_SUCCESS)
+    {
+        mqttsn_transport_message_free(p_message);
+        return err_code;
+    }
 
-    if (p_data)
+    /* The packet is in flight now, reporting the error would make the caller send it twice. */
+    err_code = mqttsn_transport_message_send(p_client, &(p_client->gateway_info.addr), p_message);
+    if (err_code != NRF_SUCCESS)
     {
-        nrf_free(p_data);
+        NRF_LOG_WARNING("Message could not be sent, it will be retransmitted. Error code: 0x%x\r\n",
+                        err_code);
     }
 
-    return err_code;
+    return NRF_SUCCESS;
 }
 
-uint32_t mqttsn_packet_sender_willtopic(mqttsn_client_t * p_client)
+/**@brief Serializes PUBLISH header into the given buffer.
+ *
+ * @param[in]    p_topic     Pointer to topic to publish on.
+ * @param[in]    topic_type  MQTTSN_TOPIC_TYPE_NORMAL or MQTTSN_TOPIC_TYPE_PREDEFINED.
+ * @param[in]    qos         QoS level; 3 stands for QoS -1.
+ * @param[in]    id          Message ID.
+ * @param[in]    payload_len Length of the payload that follows the header.
+ * @param[out]   p_header    Buffer of MQTTSN_PACKET_PUBLISH_HEADER_MAX_LENGTH bytes.
+ *
+ * @return       Length of the header. 0 or less if it could not be serialized.
+ */
+static int publish_header_serialize(const mqttsn_topic_t * p_topic,
+                                    uint8_t                topic_type,
+                                    uint8_t                qos,
+                                    uint16_t               id,
+                                    uint16_t               payload_len,
+                                    uint8_t              * p_header)
 {
-    uint8_t   will_qos    = 0;
-    uint8_t   will_retain = 0;
+    unsigned char dup      = 0;
+    unsigned char retained = 0;
+
+    MQTTSN_topicid topic;
+    memset(&topic, 0, sizeof(MQTTSN_topicid));
+    topic.type    = topic_type;
+    topic.data.id = p_topic->topic_id;
+
+    return MQTTSNSerialize_publishHeader(p_header,
+                                         MQTTSN_PACKET_PUBLISH_HEADER_MAX_LENGTH,
+                                         dup,
+                                         qos,
+                                         retained,
+                                         id,
+                                         topic,
+                                         payload_len);
+}
 
-    uint32_t  err_code    = NRF_SUCCESS;
-    uint16_t  packet_len  = MQTTSN_PACKET_WILLTOPIC_LENGTH + p_client->connect_info.will_topic_len;
-    uint8_t * p_data      = nrf_malloc(packet_len);
+/**@brief Appends PUBLISH header and payload to a message.
+ *
+ * @param[inout] p_message   Pointer to the message to append to.
+ * @param[in]    p_header    Serialized PUBLISH header.
+ * @param[in]    header_len  Length of the header.
+ * @param[in]    p_payload   Data to be published.
+ * @param[in]    payload_len Length of the data.
+ *
+ * @return       NRF_SUCCESS if the packet has been appended successfully.
+ *               Otherwise error code is returned.
+ */
+static uint32_t publish_append(mqttsn_message_t * p_message,
+                               const uint8_t    * p_header,
+                               uint16_t           header_len,
+                               const uint8_t    * p_payload,
+                               uint16_t           payload_len)
+{
+    uint32_t err_code = mqttsn_transport_message_append(p_message, p_header, header_len);
 
-    do
+    if (err_code == NRF_SUCCESS)
     {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("WILLTOPIC message cannot be allocated\r\n");
-            break;
-        }
+        err_code = mqttsn_transport_message_append(p_message, p_payload, payload_len);
+    }
 
-        MQTTSNString will_topic;
-        
-        memset(&will_topic, 0, sizeof(MQTTSNString));
-        will_topic.lenstring.data = (char *)p_client->connect_info.p_will_topic;
-        will_topic.lenstring.len  = p_client->connect_info.will_topic_len;
+    return err_code;
+}
 
-        uint16_t datalen = MQTTSNSerialize_willtopic(p_data, packet_len, will_qos, will_retain, will_topic);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
+/**@brief Serializes a control packet from the transmit buffer, enqueues and sends it.
+ *
+ * @param[inout] p_client    Pointer to initialized and connected client.
+ * @param[in]    datalen     Length of the packet serialized into the transmit buffer.
+ * @param[in]    msg_type    MQTT-SN message type of the packet.
+ * @param[in]    p_packet    Pointer to packet information (message ID and topic) to enqueue.
+ *
+ * @return       NRF_SUCCESS if the message has been sent successfully.
+ *               Otherwise error code is returned.
+ */
+static uint32_t tx_buffer_send_with_retransmission(mqttsn_client_t * p_client,
+                                                   uint16_t          datalen,
+                                                   uint8_t           msg_type,
+                                                   mqttsn_packet_t * p_packet)
+{
+    mqttsn_message_t * p_message = tx_buffer_message_create(p_client, datalen);
+    if (p_message == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
 
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
+    return mqttsn_packet_sender_send_with_retransmission(p_client, p_message, msg_type, p_packet);
+}
 
-    } while (0);
+uint32_t mqttsn_packet_sender_retransmit(mqttsn_client_t       * p_client,
+                                         const mqttsn_remote_t * p_remote,
+                                         const mqttsn_packet_t * p_packet)
+{
+    if (p_packet->p_message == NULL)
+    {
+        return mqttsn_packet_sender_send(p_client, p_remote, p_packet->p_data, p_packet->len);
+    }
 
-    if (p_data)
+    mqttsn_message_t * p_message = mqttsn_transport_message_clone(p_packet->p_message);
+    if (p_message == NULL)
     {
-        nrf_free(p_data);
+        return NRF_ERROR_NO_MEM;
     }
 
-    return err_code;
+    return mqttsn_transport_message_send(p_client, p_remote, p_message);
 }
 
-uint32_t mqttsn_packet_sender_willmsg(mqttsn_client_t * p_client)
+uint32_t mqttsn_packet_sender_searchgw(mqttsn_client_t * p_client)
 {
-    uint32_t  err_code   = NRF_SUCCESS;
-    uint16_t  packet_len = MQTTSN_PACKET_WILLMSG_LENGTH + p_client->connect_info.will_msg_len;
-    uint8_t * p_data     = nrf_malloc(packet_len);
+    unsigned char radius = 1;
 
-    do
+    int datalen = MQTTSNSerialize_searchgw(m_tx_buffer, sizeof(m_tx_buffer), radius);
+    if (datalen <= 0)
     {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("WILLMSG message cannot be allocated\r\n");
-            break;
-        }
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-        MQTTSNString will_msg;
-        memset(&will_msg, 0, sizeof(MQTTSNString));
-        will_msg.lenstring.data = (char *)p_client->connect_info.p_will_msg;
-        will_msg.lenstring.len  = p_client->connect_info.will_msg_len;
+    const mqttsn_remote_t broadcast_search =
+    {
+        .addr        = MQTTSN_BROADCAST_ADDR,
+        .port_number = MQTTSN_DEFAULT_CLIENT_PORT,
+    };
 
-        uint16_t datalen = MQTTSNSerialize_willmsg(p_data, packet_len, will_msg);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
+    return mqttsn_packet_sender_send(p_client, &broadcast_search, m_tx_buffer, datalen);
+}
 
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
+uint32_t mqttsn_packet_sender_willtopic(mqttsn_client_t * p_client)
+{
+    uint8_t will_qos    = 0;
+    uint8_t will_retain = 0;
 
-    } while (0);
+    MQTTSNString will_topic;
+    memset(&will_topic, 0, sizeof(MQTTSNString));
+    will_topic.lenstring.data = (char *)p_client->connect_info.p_will_topic;
+    will_topic.lenstring.len  = p_client->connect_info.will_topic_len;
 
-    if (p_data)
+    int datalen = MQTTSNSerialize_willtopic(m_tx_buffer, sizeof(m_tx_buffer), will_qos, will_retain, will_topic);
+    if (datalen <= 0)
     {
-        nrf_free(p_data);
+        return NRF_ERROR_INVALID_PARAM;
     }
 
-    return err_code;
+    return mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), m_tx_buffer, datalen);
 }
 
-uint32_t mqttsn_packet_sender_connect(mqttsn_client_t * p_client)
+uint32_t mqttsn_packet_sender_willmsg(mqttsn_client_t * p_client)
 {
-    uint32_t                 err_code = NRF_SUCCESS;
-    char                     p_buf[MQTTSN_CLIENT_ID_MAX_LENGTH];
-    MQTTSNPacket_connectData options  = MQTTSNPacket_connectData_initializer;
-    options.clientID.cstring          = p_buf;
-
-    memset(options.clientID.cstring, 0, MQTTSN_CLIENT_ID_MAX_LENGTH);
-    memcpy(options.clientID.cstring,
-           p_client->connect_info.p_client_id,
-           p_client->connect_info.client_id_len);
-    options.willFlag     = p_client->connect_info.will_flag;
-    options.duration     = p_client->connect_info.alive_duration;
-    options.cleansession = p_client->connect_info.clean_session;
+    MQTTSNString will_msg;
+    memset(&will_msg, 0, sizeof(MQTTSNString));
+    will_msg.lenstring.data = (char *)p_client->connect_info.p_will_msg;
+    will_msg.lenstring.len  = p_client->connect_info.will_msg_len;
 
-    uint8_t * p_data      = nrf_malloc(MQTTSN_PACKET_CONNECT_LENGTH);
-    uint8_t * p_packet_copy = NULL;
-
-    do
+    int datalen = MQTTSNSerialize_willmsg(m_tx_buffer, sizeof(m_tx_buffer), will_msg);
+    if (datalen <= 0)
     {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("CONNECT message cannot be allocated\r\n");
-            break;
-        }
-
-        uint16_t datalen = MQTTSNSerialize_connect(p_data, MQTTSN_PACKET_CONNECT_LENGTH, &options);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-        p_packet_copy = nrf_malloc(datalen);
-        if (p_packet_copy == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
+    return mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), m_tx_buffer, datalen);
+}
 
-        memcpy(p_packet_copy, p_data, datalen);
+uint32_t mqttsn_packet_sender_connect(mqttsn_client_t * p_client)
+{
+    MQTTSNPacket_connectData options = MQTTSNPacket_connectData_initializer;
+    options.clientID.lenstring.data  = (char *)p_client->connect_info.p_client_id;
+    options.clientID.lenstring.len   = p_client->connect_info.client_id_len;
+    options.willFlag                 = p_client->connect_info.will_flag;
+    options.duration                 = p_client->connect_info.alive_duration;
+    options.cleansession             = p_client->connect_info.clean_session;
 
-        mqttsn_packet_t retransmission_packet;
-        memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
-        retransmission_packet.retransmission_cnt = MQTTSN_DEFAULT_RETRANSMISSION_CNT;
-        retransmission_packet.p_data             = p_packet_copy;
-        retransmission_packet.len                = datalen;
-        retransmission_packet.timeout =
-            mqttsn_platform_timer_set_in_ms(MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS);
+    int datalen = MQTTSNSerialize_connect(m_tx_buffer, sizeof(m_tx_buffer), &options);
+    if (datalen <= 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-        if (mqttsn_packet_fifo_elem_add(p_client, &retransmission_packet) != NRF_SUCCESS)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
+    mqttsn_packet_t retransmission_packet;
+    memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
 
-        if (mqttsn_client_timeout_schedule(p_client) != NRF_SUCCESS)
-        {
-            uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client,
-                                                                       MQTTSN_MSGTYPE_CONNECT,
-                                                                       MQTTSN_MESSAGE_TYPE);
-            ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
-            err_code = NRF_ERROR_INTERNAL;
-            break;
-        }
+    return tx_buffer_send_with_retransmission(p_client,
+                                              datalen,
+                                              MQTTSN_MSGTYPE_CONNECT,
+                                              &retransmission_packet);
+}
 
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
+uint32_t mqttsn_packet_sender_register(mqttsn_client_t * p_client,
+                                       mqttsn_topic_t  * p_topic,
+                                       uint16_t          topic_name_len)
+{
+    MQTTSNString topic_name;
+    memset(&topic_name, 0, sizeof(topic_name));
+    topic_name.lenstring.data = (char *)(p_topic->p_topic_name);
+    topic_name.lenstring.len  = topic_name_len;
+
+    int datalen = MQTTSNSerialize_register(m_tx_buffer,
+                                           sizeof(m_tx_buffer),
+                                           0,
+                                           next_packet_id_get(p_client),
+                                           &topic_name);
+    if (datalen <= 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-    } while (0);
+    mqttsn_packet_t retransmission_packet;
+    memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
+    retransmission_packet.id    = p_client->message_id;
+    retransmission_packet.topic = *p_topic;
 
-    if (p_data)
-    {
-        nrf_free(p_data);
-    }
+    return tx_buffer_send_with_retransmission(p_client,
+                                              datalen,
+                                              MQTTSN_MSGTYPE_REGISTER,
+                                              &retransmission_packet);
+}
 
-    if (p_packet_copy && err_code != NRF_SUCCESS)
+uint32_t mqttsn_packet_sender_regack(mqttsn_client_t * p_client,
+                                     uint16_t          topic_id,
+                                     uint16_t          packet_id,
+                                     uint8_t           ret_code)
+{
+    int datalen = MQTTSNSerialize_regack(m_tx_buffer, sizeof(m_tx_buffer), topic_id, packet_id, ret_code);
+    if (datalen <= 0)
     {
-        nrf_free(p_packet_copy);
+        return NRF_ERROR_INVALID_PARAM;
     }
 
-    return err_code;
+    return mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), m_tx_buffer, datalen);
 }
 
-uint32_t mqttsn_packet_sender_register(mqttsn_client_t * p_client,
-                                       mqttsn_topic_t  * p_topic,
-                                       uint16_t          topic_name_len)
+uint32_t mqttsn_packet_sender_publish(mqttsn_client_t * p_client,
+                                      mqttsn_topic_t  * p_topic,
+                                      uint8_t           qos,
+                                      const uint8_t   * payload,
+                                      uint16_t          payload_len)
 {
-    uint32_t  err_code    = NRF_SUCCESS;
-    uint16_t  packet_len  = MQTTSN_PACKET_REGISTER_LENGTH + topic_name_len;
-    uint8_t * p_data      = nrf_malloc(packet_len);
-    uint8_t * p_packet_copy = NULL;
+    uint8_t header[MQTTSN_PACKET_PUBLISH_HEADER_MAX_LENGTH];
 
-    do
+    int header_len = publish_header_serialize(p_topic,
+                                              MQTTSN_TOPIC_TYPE_NORMAL,
+                                              qos,
+                                              next_packet_id_get(p_client),
+                                              payload_len,
+                                              header);
+    if (header_len <= 0)
     {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("REGISTER message cannot be allocated\r\n");
-            break;
-        }
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-        MQTTSNString topic_name;
-        memset(&topic_name, 0, sizeof(topic_name));
-        topic_name.lenstring.data = (char *)(p_topic->p_topic_name);
-        topic_name.lenstring.len  = topic_name_len;
-
-        uint16_t datalen = MQTTSNSerialize_register(p_data,
-                                                    packet_len,
-                                                    0,
-                                                    next_packet_id_get(p_client),
-                                                    &topic_name);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
+    mqttsn_message_t * p_message = mqttsn_transport_message_alloc(p_client);
+    if (p_message == NULL)
+    {
+        NRF_LOG_ERROR("PUBLISH message cannot be allocated\r\n");
+        return NRF_ERROR_NO_MEM;
+    }
 
-        p_packet_copy = nrf_malloc(datalen);
-        if (p_packet_copy == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
-        memcpy(p_packet_copy, p_data, datalen);
+    if (publish_append(p_message, header, header_len, payload, payload_len) != NRF_SUCCESS)
+    {
+        mqttsn_transport_message_free(p_message);
+        return NRF_ERROR_NO_MEM;
+    }
 
+    mqttsn_packet_t retransmission_packet;
+    memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
+    retransmission_packet.id    = p_client->message_id;
+    retransmission_packet.qos   = qos;
+    retransmission_packet.topic = *p_topic;
 
-        mqttsn_packet_t retransmission_packet;
-        memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
-        retransmission_packet.retransmission_cnt = MQTTSN_DEFAULT_RETRANSMISSION_CNT;
-        retransmission_packet.p_data             = p_packet_copy;
-        retransmission_packet.len                = datalen;
-        retransmission_packet.id                 = p_client->message_id;
-        retransmission_packet.timeout =
-            mqttsn_platform_timer_set_in_ms(MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS);
-        retransmission_packet.topic = *p_topic;
+    /* Keep publish order: once the backlog is used, new messages go behind it. */
+    if ((p_client->packet_queue.backlog_count > 0) || mqttsn_packet_fifo_is_full(p_client))
+    {
+        retransmission_packet.msg_type  = MQTTSN_MSGTYPE_PUBLISH;
+        retransmission_packet.p_message = p_message;
 
-        if (mqttsn_packet_fifo_elem_add(p_client, &retransmission_packet) != NRF_SUCCESS)
+        uint32_t err_code = mqttsn_packet_fifo_backlog_add(p_client, &retransmission_packet);
+        if (err_code != NRF_SUCCESS)
         {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
+            mqttsn_transport_message_free(p_message);
         }
 
-        if (mqttsn_client_timeout_schedule(p_client) != NRF_SUCCESS)
-        {
-            uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client,
-                                                                       p_client->message_id,
-                                                                       MQTTSN_MESSAGE_ID);
-            ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
-            err_code = NRF_ERROR_INTERNAL;
-            break;
-        }
+        return err_code;
+    }
+
+    return mqttsn_packet_sender_send_with_retransmission(p_client,
+                                                         p_message,
+                                                         MQTTSN_MSGTYPE_PUBLISH,
+                                                         &retransmission_packet);
+}
 
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
+uint32_t mqttsn_packet_sender_qos_negative_one_publish(mqttsn_client_t       * p_client,
+                                                       const mqttsn_remote_t * p_remote,
+                                                       mqttsn_topic_t        * p_topic,
+                                                       const uint8_t         * payload,
+                                                       uint16_t                payload_len)
+{
+    uint8_t header[MQTTSN_PACKET_PUBLISH_HEADER_MAX_LENGTH];
 
-    } while (0);
+    int header_len = publish_header_serialize(p_topic,
+                                              MQTTSN_TOPIC_TYPE_PREDEFINED,
+                                              MQTTSN_QOS_NEGATIVE_ONE,
+                                              0,
+                                              payload_len,
+                                              header);
+    if (header_len <= 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-    if (p_data)
+    mqttsn_message_t * p_message = mqttsn_transport_message_alloc(p_client);
+    if (p_message == NULL)
     {
-        nrf_free(p_data);
+        NRF_LOG_ERROR("PUBLISH message cannot be allocated\r\n");
+        return NRF_ERROR_NO_MEM;
     }
 
-    if (p_packet_copy && err_code != NRF_SUCCESS)
+    if (publish_append(p_message, header, header_len, payload, payload_len) != NRF_SUCCESS)
     {
-        nrf_free(p_packet_copy);
+        mqttsn_transport_message_free(p_message);
+        return NRF_ERROR_NO_MEM;
     }
 
-    return err_code;
+    return mqttsn_transport_message_send(p_client, p_remote, p_message);
 }
 
-uint32_t mqttsn_packet_sender_regack(mqttsn_client_t * p_client,
-                                     uint16_t          topic_id,
-                                     uint16_t          packet_id,
-                                     uint8_t           ret_code)
+uint32_t mqttsn_packet_sender_pubrec(mqttsn_client_t * p_client, uint16_t packet_id)
 {
-    uint32_t err_code = NRF_SUCCESS;
-    uint8_t * p_data  = nrf_malloc(MQTTSN_PACKET_REGACK_LENGTH);
-
-    do
+    int datalen = MQTTSNSerialize_pubrec(m_tx_buffer, sizeof(m_tx_buffer), packet_id);
+    if (datalen <= 0)
     {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("REGACK message cannot be allocated\r\n");
-            break;
-        }
-
-        uint16_t datalen = MQTTSNSerialize_regack(p_data,
-                                                  MQTTSN_PACKET_REGACK_LENGTH,
-                                                  topic_id,
-                                                  packet_id,
-                                                  ret_code);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
-
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-    } while (0);
+    return mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), m_tx_buffer, datalen);
+}
 
-    if (p_data)
+uint32_t mqttsn_packet_sender_pubrel(mqttsn_client_t      * p_client,
+                                     uint16_t               packet_id,
+                                     const mqttsn_topic_t * p_topic)
+{
+    int datalen = MQTTSNSerialize_pubrel(m_tx_buffer, sizeof(m_tx_buffer), packet_id);
+    if (datalen <= 0)
     {
-        nrf_free(p_data);
+        return NRF_ERROR_INVALID_PARAM;
     }
 
-    return err_code;
+    mqttsn_packet_t retransmission_packet;
+    memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
+    retransmission_packet.id    = packet_id;
+    retransmission_packet.qos   = 2;
+    retransmission_packet.topic = *p_topic;
+
+    return tx_buffer_send_with_retransmission(p_client,
+                                              datalen,
+                                              MQTTSN_MSGTYPE_PUBREL,
+                                              &retransmission_packet);
 }
 
-uint32_t mqttsn_packet_sender_publish(mqttsn_client_t * p_client,
-                                      mqttsn_topic_t  * p_topic,
-                                      const uint8_t   * payload,
-                                      uint16_t          payload_len)
+uint32_t mqttsn_packet_sender_pubcomp(mqttsn_client_t * p_client, uint16_t packet_id)
 {
-    uint32_t err_code      = NRF_SUCCESS;
+    int datalen = MQTTSNSerialize_pubcomp(m_tx_buffer, sizeof(m_tx_buffer), packet_id);
+    if (datalen <= 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-    unsigned char dup      = 0;
-    unsigned char retained = 0;
-    uint8_t  qos           = 1;
+    return mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), m_tx_buffer, datalen);
+}
 
-    uint32_t  packet_len   = MQTTSN_PACKET_PUBLISH_LENGTH + payload_len;
-    uint8_t * p_data       = nrf_malloc(packet_len);
-    uint8_t * p_packet_copy  = NULL;
+uint32_t mqttsn_packet_sender_batch_publish(mqttsn_client_t * p_client,
+                                            mqttsn_topic_t  * p_topic,
+                                            const uint8_t   * payload,
+                                            uint16_t          payload_len)
+{
+    mqttsn_batch_t * p_batch = &p_client->batch;
+    uint8_t          header[MQTTSN_PACKET_PUBLISH_HEADER_MAX_LENGTH];
+    uint32_t         err_code;
 
-    do
+    /* Messages that cannot take a slot now, or never fit in a batch, are sent on their own,
+     * after the batch so that publish order is kept. */
+    if ((p_client->packet_queue.backlog_count > 0) ||
+        mqttsn_packet_fifo_is_full(p_client) ||
+        (payload_len + MQTTSN_PACKET_PUBLISH_HEADER_MAX_LENGTH > MQTTSN_BATCH_MAX_DATAGRAM_SIZE))
     {
-        if (p_data == NULL)
+        err_code = mqttsn_packet_sender_batch_flush(p_client);
+        if (err_code != NRF_SUCCESS)
         {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("PUBLISH message cannot be allocated\r\n");
-            break;
+            NRF_LOG_ERROR("Batch could not be sent. Error code: 0x%x\r\n", err_code);
         }
 
-        MQTTSN_topicid topic;
-        memset(&topic, 0, sizeof(MQTTSN_topicid));
-        topic.type    = MQTTSN_TOPIC_TYPE_NORMAL;
-        topic.data.id = p_topic->topic_id;
-
-        uint16_t datalen = MQTTSNSerialize_publish(p_data,
-                                                   packet_len,
-                                                   dup,
-                                                   qos,
-                                                   retained,
-                                                   next_packet_id_get(p_client),
-                                                   topic,
-                                                   (uint8_t *)payload,
-                                                   payload_len);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
-
-        p_packet_copy = nrf_malloc(datalen);
-        if (p_packet_copy == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
+        return mqttsn_packet_sender_publish(p_client, p_topic, 1, payload, payload_len);
+    }
 
-        memcpy(p_packet_copy, p_data, datalen);
+    int header_len = publish_header_serialize(p_topic,
+                                              MQTTSN_TOPIC_TYPE_NORMAL,
+                                              1,
+                                              next_packet_id_get(p_client),
+                                              payload_len,
+                                              header);
+    if (header_len <= 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
 
-        mqttsn_packet_t retransmission_packet;
-        memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
-        retransmission_packet.retransmission_cnt = MQTTSN_DEFAULT_RETRANSMISSION_CNT;
-        retransmission_packet.p_data             = p_packet_copy;
-        retransmission_packet.len                = datalen;
-        retransmission_packet.id                 = p_client->message_id;
-        retransmission_packet.timeout =
-            mqttsn_platform_timer_set_in_ms(MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS);
-        retransmission_packet.topic = *p_topic;
+    uint16_t packet_len = header_len + payload_len;
+    uint16_t id         = p_client->message_id;
 
-        if (mqttsn_packet_fifo_elem_add(p_client, &retransmission_packet) != NRF_SUCCESS)
+    if (p_batch->len + packet_len > MQTTSN_BATCH_MAX_DATAGRAM_SIZE)
+    {
+        err_code = mqttsn_packet_sender_batch_flush(p_client);
+        if (err_code != NRF_SUCCESS)
         {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
+            NRF_LOG_ERROR("Batch could not be sent. Error code: 0x%x\r\n", err_code);
         }
+    }
 
-        if (mqttsn_client_timeout_schedule(p_client) != NRF_SUCCESS)
+    if (p_batch->p_message == NULL)
+    {
+        p_batch->p_message = mqttsn_transport_message_alloc(p_client);
+        if (p_batch->p_message == NULL)
         {
-            uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client,
-                                                                       p_client->message_id,
-                                                                       MQTTSN_MESSAGE_ID);
-            ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
-            err_code = NRF_ERROR_INTERNAL;
-            break;
+            return NRF_ERROR_NO_MEM;
         }
 
-            err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
+        p_batch->timeout = mqttsn_platform_timer_set_in_ms(MQTTSN_BATCH_WINDOW_MS);
+        mqttsn_timer_queue_set(p_client, MQTTSN_TIMER_BATCH, p_batch->timeout);
+    }
+
+    /* Every message of the batch is retransmitted on its own. */
+    mqttsn_message_t * p_message = mqttsn_transport_message_alloc(p_client);
+    if (p_message == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    if (publish_append(p_message, header, header_len, payload, payload_len) != NRF_SUCCESS)
+    {
+        mqttsn_transport_message_free(p_message);
+        return NRF_ERROR_NO_MEM;
+    }
 
-    } while (0);
+    mqttsn_packet_t retransmission_packet;
+    memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
+    retransmission_packet.id    = id;
+    retransmission_packet.qos   = 1;
+    retransmission_packet.topic = *p_topic;
 
-    if (p_data)
+    err_code = packet_enqueue(p_client,
+                              p_message,
+                              MQTTSN_MSGTYPE_PUBLISH,
+                              &retransmission_packet,
+                              MQTTSN_BATCH_WINDOW_MS);
+    if (err_code != NRF_SUCCESS)
     {
-        nrf_free(p_data);
+        return err_code;
     }
 
-    if (p_packet_copy && err_code != NRF_SUCCESS)
+    if (publish_append(p_batch->p_message, header, header_len, payload, payload_len) != NRF_SUCCESS)
     {
-        nrf_free(p_packet_copy);
+        uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client, id, MQTTSN_MESSAGE_ID);
+        ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
+        return NRF_ERROR_NO_MEM;
     }
 
-    return err_code;
+    p_batch->id[p_batch->count++] = id;
+    p_batch->len                 += packet_len;
+
+    return NRF_SUCCESS;
 }
 
-uint32_t mqttsn_packet_sender_puback(mqttsn_client_t * p_client,
-                                     uint16_t          topic_id,
-                                     uint16_t          packet_id,
-                                     uint8_t           ret_code)
+uint32_t mqttsn_packet_sender_batch_flush(mqttsn_client_t * p_client)
 {
-    uint32_t err_code = NRF_SUCCESS;
-    uint8_t * p_data  = nrf_malloc(MQTTSN_PACKET_PUBACK_LENGTH);
+    mqttsn_batch_t   * p_batch   = &p_client->batch;
+    mqttsn_message_t * p_message = p_batch->p_message;
 
-    do
+    if (p_message == NULL)
     {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("PUBACK message cannot be allocated\r\n");
-            break;
-        }
+        return NRF_SUCCESS;
+    }
 
-        uint16_t datalen = MQTTSNSerialize_puback(p_data,
-                                                  MQTTSN_PACKET_PUBACK_LENGTH,
-                                                  topic_id,
-                                                  packet_id,
-                                                  ret_code);
-        if (datalen == 0)
+    /* Retransmission timers of the batched messages start when the datagram is sent. */
+    for (uint8_t i = 0; i < p_batch->count; i++)
+    {
+        uint32_t index = mqttsn_packet_fifo_elem_find(p_client, p_batch->id[i], MQTTSN_MESSAGE_ID);
+        if (index != MQTTSN_PACKET_FIFO_MAX_LENGTH)
         {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
+            mqttsn_packet_t * p_packet = &p_client->packet_queue.packet[index];
 
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
+            p_packet->sent    = mqttsn_platform_timer_cnt_get();
+            p_packet->timeout = p_packet->sent +
+                mqttsn_rtt_retransmission_time_get(p_client, p_packet->retransmission_cnt);
+            mqttsn_timer_queue_set(p_client, index, p_packet->timeout);
+        }
+    }
 
-    } while (0);
+    uint8_t count = p_batch->count;
+    memset(p_batch, 0, sizeof(mqttsn_batch_t));
+    mqttsn_timer_queue_cancel(p_client, MQTTSN_TIMER_BATCH);
 
-    if (p_data)
+    if (count == 0)
     {
-        nrf_free(p_data);
+        mqttsn_transport_message_free(p_message);
+        return NRF_SUCCESS;
     }
 
-    return err_code;
+    (void)mqttsn_client_timeout_schedule(p_client);
+
+    return mqttsn_transport_message_send(p_client, &(p_client->gateway_info.addr), p_message);
 }
 
-uint32_t mqttsn_packet_sender_subscribe(mqttsn_client_t * p_client,
-                                        mqttsn_topic_t * p_topic,
-                                        uint16_t topic_name_len)
+void mqttsn_packet_sender_backlog_flush(mqttsn_client_t * p_client)
 {
-    uint32_t  err_code    = NRF_SUCCESS;
-    uint16_t  packet_len  = MQTTSN_PACKET_SUBSCRIBE_LENGTH + topic_name_len;
-    uint8_t   qos         = 1;
-    uint8_t   dup         = 0;
-    uint8_t * p_data      = nrf_malloc(packet_len);
-    uint8_t * p_packet_copy = NULL;
+    mqttsn_packet_t packet;
 
-    do
+    if ((p_client->client_state != MQTTSN_CLIENT_CONNECTED) &&
+        (p_client->client_state != MQTTSN_CLIENT_ASLEEP))
     {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("SUBSCRIBE message cannot be allocated\r\n");
-            break;
-        }
+        return;
+    }
 
-        MQTTSN_topicid topic;
-        memset(&topic, 0, sizeof(MQTTSN_topicid));
-        topic.type            = MQTTSN_TOPIC_TYPE_NORMAL;
-        topic.data.long_.name = (char *)(p_topic->p_topic_name);
-        topic.data.long_.len  = (int)topic_name_len;
-
-        uint16_t datalen = MQTTSNSerialize_subscribe(p_data,
-                                                     packet_len,
-                                                     dup,
-                                                     qos,
-                                                     next_packet_id_get(p_client),
-                                                     &topic);
-        if (datalen == 0)
+    while (!mqttsn_packet_fifo_is_full(p_client) &&
+           (mqttsn_packet_fifo_backlog_get(p_client, &packet) == NRF_SUCCESS))
+    {
+        uint32_t err_code = mqttsn_packet_sender_send_with_retransmission(p_client,
+                                                                          packet.p_message,
+                                                                          packet.msg_type,
+                                                                          &packet);
+        /* A packet that made it into the window is retransmitted later; only lost ones fail. */
+        if (err_code != NRF_SUCCESS)
         {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
+            NRF_LOG_ERROR("Backlog PUBLISH message could not be sent. Error code: 0x%x\r\n", err_code);
 
-        p_packet_copy = nrf_malloc(datalen);
-        if (p_packet_copy == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
-        memcpy(p_packet_copy, p_data, datalen);
-
-        mqttsn_packet_t retransmission_packet;
-        memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
-        retransmission_packet.retransmission_cnt = MQTTSN_DEFAULT_RETRANSMISSION_CNT;
-        retransmission_packet.p_data             = p_packet_copy;
-        retransmission_packet.len                = datalen;
-        retransmission_packet.id                 = p_client->message_id;
-        retransmission_packet.timeout =
-            mqttsn_platform_timer_set_in_ms(MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS);
-        retransmission_packet.topic = *p_topic;
-
-        if (mqttsn_packet_fifo_elem_add(p_client, &retransmission_packet) != NRF_SUCCESS)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
+            mqttsn_event_t evt;
+            memset(&evt, 0, sizeof(mqttsn_event_t));
+            evt.event_id                  = MQTTSN_EVENT_TIMEOUT;
+            evt.event_data.error.error    = MQTTSN_ERROR_TIMEOUT;
+            evt.event_data.error.msg_type = mqttsn_packet_error_get(&packet);
+            evt.event_data.error.msg_id   = packet.id;
 
-        if (mqttsn_client_timeout_schedule(p_client) != NRF_SUCCESS)
-        {
-            uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client,
-                                                                       p_client->message_id,
-                                                                       MQTTSN_MESSAGE_ID);
-            ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
-            err_code = NRF_ERROR_INTERNAL;
-            break;
+            p_client->evt_handler(p_client, &evt);
         }
+    }
+}
 
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
-
-    } while (0);
-
-    if (p_data)
+uint32_t mqttsn_packet_sender_puback(mqttsn_client_t * p_client,
+                                     uint16_t          topic_id,
+                                     uint16_t          packet_id,
+                                     uint8_t           ret_code)
+{
+    int datalen = MQTTSNSerialize_puback(m_tx_buffer, sizeof(m_tx_buffer), topic_id, packet_id, ret_code);
+    if (datalen <= 0)
     {
-        nrf_free(p_data);
+        return NRF_ERROR_INVALID_PARAM;
     }
 
-    if (p_packet_copy && err_code != NRF_SUCCESS)
-    {
-        nrf_free(p_packet_copy);
+    return mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), m_tx_buffer, datalen);
+}
+
+uint32_t mqttsn_packet_sender_subscribe(mqttsn_client_t * p_client,
+                                        mqttsn_topic_t * p_topic,
+                                        uint16_t topic_name_len)
+{
+    uint8_t qos = MQTTSN_SUBSCRIBE_QOS;
+    uint8_t dup = 0;
+
+    MQTTSN_topicid topic;
+    memset(&topic, 0, sizeof(MQTTSN_topicid));
+    topic.type            = MQTTSN_TOPIC_TYPE_NORMAL;
+    topic.data.long_.name = (char *)(p_topic->p_topic_name);
+    topic.data.long_.len  = (int)topic_name_len;
+
+    int datalen = MQTTSNSerialize_subscribe(m_tx_buffer,
+                                            sizeof(m_tx_buffer),
+                                            dup,
+                                            qos,
+                                            next_packet_id_get(p_client),
+                                            &topic);
+    if (datalen <= 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
     }
 
-    return err_code;
+    mqttsn_packet_t retransmission_packet;
+    memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
+    retransmission_packet.id    = p_client->message_id;
+    retransmission_packet.topic = *p_topic;
+
+    return tx_buffer_send_with_retransmission(p_client,
+                                              datalen,
+                                              MQTTSN_MSGTYPE_SUBSCRIBE,
+                                              &retransmission_packet);
 }
 
 uint32_t mqttsn_packet_sender_unsubscribe(mqttsn_client_t * p_client,
                                           mqttsn_topic_t  * p_topic,
                                           uint16_t          topic_name_len)
 {
-    uint32_t  err_code    = NRF_SUCCESS;
-    uint16_t  packet_len  = MQTTSN_PACKET_UNSUBSCRIBE_LENGTH + topic_name_len;
-    uint8_t * p_data      = nrf_malloc(packet_len);
-    uint8_t * p_packet_copy = NULL;
-
-    do
-    {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("UNSUBSCRIBE message cannot be allocated\r\n");
-            break;
-        }
-
-        MQTTSN_topicid topic;
-        memset(&topic, 0, sizeof(MQTTSN_topicid));
-        topic.type            = MQTTSN_TOPIC_TYPE_NORMAL;
-        topic.data.long_.name = (char *)(p_topic->p_topic_name);
-        topic.data.long_.len  = (int)topic_name_len;
-
-        uint16_t datalen =
-            MQTTSNSerialize_unsubscribe(p_data, packet_len, next_packet_id_get(p_client), &topic);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
-
-        p_packet_copy = nrf_malloc(datalen);
-        if (p_packet_copy == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
-        memcpy(p_packet_copy, p_data, datalen);
-
-        mqttsn_packet_t retransmission_packet;
-        memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
-        retransmission_packet.retransmission_cnt = MQTTSN_DEFAULT_RETRANSMISSION_CNT;
-        retransmission_packet.p_data             = p_packet_copy;
-        retransmission_packet.len                = datalen;
-        retransmission_packet.id                 = p_client->message_id;
-        retransmission_packet.timeout =
-            mqttsn_platform_timer_set_in_ms(MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS);
-        retransmission_packet.topic = *p_topic;
-
-        if (mqttsn_packet_fifo_elem_add(p_client, &retransmission_packet) != NRF_SUCCESS)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
-
-        if (mqttsn_client_timeout_schedule(p_client) != NRF_SUCCESS)
-        {
-            uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client,
-                                                                       p_client->message_id,
-                                                                       MQTTSN_MESSAGE_ID);
-            ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
-            err_code = NRF_ERROR_INTERNAL;
-            break;
-        }
-
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
-
-    } while (0);
-
-    if (p_data)
-    {
-        nrf_free(p_data);
+    MQTTSN_topicid topic;
+    memset(&topic, 0, sizeof(MQTTSN_topicid));
+    topic.type            = MQTTSN_TOPIC_TYPE_NORMAL;
+    topic.data.long_.name = (char *)(p_topic->p_topic_name);
+    topic.data.long_.len  = (int)topic_name_len;
+
+    int datalen = MQTTSNSerialize_unsubscribe(m_tx_buffer,
+                                              sizeof(m_tx_buffer),
+                                              next_packet_id_get(p_client),
+                                              &topic);
+    if (datalen <= 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
     }
 
-    if (p_packet_copy && err_code != NRF_SUCCESS)
-    {
-        nrf_free(p_packet_copy);
-    }
+    mqttsn_packet_t retransmission_packet;
+    memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
+    retransmission_packet.id    = p_client->message_id;
+    retransmission_packet.topic = *p_topic;
 
-    return err_code;
+    return tx_buffer_send_with_retransmission(p_client,
+                                              datalen,
+                                              MQTTSN_MSGTYPE_UNSUBSCRIBE,
+                                              &retransmission_packet);
 }
 
 uint32_t mqttsn_packet_sender_disconnect(mqttsn_client_t * p_client, uint16_t duration)
 {
-    uint32_t              err_code = NRF_SUCCESS;
-    uint16_t              packet_len;
     int16_t               disconnect_duration;
     mqttsn_client_state_t next_state;
 
@@ -752,43 +830,23 @@ uint32_t mqttsn_packet_sender_disconnect(mqttsn_client_t * p_client, uint16_t du
         disconnect_duration           = duration + (MQTTSN_DEFAULT_RETRANSMISSION_CNT + 1) *
                                                     MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS / 1000;
         next_state                    = MQTTSN_CLIENT_WAITING_FOR_SLEEP;
-        packet_len                    = MQTTSN_PACKET_DISCONNECT_LENGTH + sizeof(duration);
         p_client->keep_alive.duration = duration * 1000;
     }
     else
     {
         disconnect_duration = MQTTSN_PACKET_DISCONNECT_DURATION;
         next_state          = MQTTSN_CLIENT_WAITING_FOR_DISCONNECT;
-        packet_len          = MQTTSN_PACKET_DISCONNECT_LENGTH;
     }
 
-    uint8_t * p_data = nrf_malloc(packet_len);
-
-    do
-    {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("DISCONNECT message cannot be allocated\r\n");
-            break;
-        }
-
-        uint16_t datalen = MQTTSNSerialize_disconnect(p_data, packet_len, disconnect_duration);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
-
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
-
-    } while (0);
-
-    if (p_data)
+    int datalen = MQTTSNSerialize_disconnect(m_tx_buffer, sizeof(m_tx_buffer), disconnect_duration);
+    if (datalen <= 0)
     {
-        nrf_free(p_data);
+        return NRF_ERROR_INVALID_PARAM;
     }
 
+    uint32_t err_code =
+        mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), m_tx_buffer, datalen);
+
     if (err_code == NRF_SUCCESS)
     {
         p_client->client_state = next_state;
@@ -799,159 +857,51 @@ uint32_t mqttsn_packet_sender_disconnect(mqttsn_client_t * p_client, uint16_t du
 
 uint32_t mqttsn_packet_sender_willtopicupd(mqttsn_client_t * p_client)
 {
-    uint8_t   will_qos      = 1;
-    uint8_t   will_retain   = 0;
-
-    uint32_t  err_code      = NRF_SUCCESS;
-    uint16_t  packet_len    = MQTTSN_PACKET_WILLTOPIC_LENGTH + p_client->connect_info.will_topic_len;
-    uint8_t * p_data        = nrf_malloc(packet_len);
-    uint8_t * p_packet_copy   = NULL;
-
-    do
-    {
-        if (p_data == NULL)
-        {
-            NRF_LOG_ERROR("WILLTOPICUPD message cannot be allocated\r\n");
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
-
-        MQTTSNString will_topic;
-        memset(&will_topic, 0, sizeof(MQTTSNString));
-        will_topic.lenstring.data = (char *)p_client->connect_info.p_will_topic;
-        will_topic.lenstring.len  = p_client->connect_info.will_topic_len;
-
-        uint16_t datalen = MQTTSNSerialize_willtopicupd(p_data, packet_len, will_qos, will_retain, will_topic);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
-
-        p_packet_copy = nrf_malloc(datalen);
-        if (p_packet_copy == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
-        memcpy(p_packet_copy, p_data, datalen);
-        
-        mqttsn_packet_t retransmission_packet;
-        memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t)); 
-        retransmission_packet.retransmission_cnt = MQTTSN_DEFAULT_RETRANSMISSION_CNT;
-        retransmission_packet.p_data             = p_packet_copy;
-        retransmission_packet.len                = datalen;
-        retransmission_packet.timeout            =
-            mqttsn_platform_timer_set_in_ms(MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS);
-
-        if (mqttsn_packet_fifo_elem_add(p_client, &retransmission_packet) != NRF_SUCCESS)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
-    
-        if (mqttsn_client_timeout_schedule(p_client) != NRF_SUCCESS)
-        {
-            uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client,
-                                                                       MQTTSN_MSGTYPE_WILLTOPICUPD,
-                                                                       MQTTSN_MESSAGE_TYPE);
-            ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
-            err_code = NRF_ERROR_INTERNAL;
-            break;
-        }
-    
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
-
-    } while (0);
-
-    if (p_data)
-    {
-        nrf_free(p_data);
+    uint8_t will_qos    = 1;
+    uint8_t will_retain = 0;
+
+    MQTTSNString will_topic;
+    memset(&will_topic, 0, sizeof(MQTTSNString));
+    will_topic.lenstring.data = (char *)p_client->connect_info.p_will_topic;
+    will_topic.lenstring.len  = p_client->connect_info.will_topic_len;
+
+    int datalen = MQTTSNSerialize_willtopicupd(m_tx_buffer,
+                                               sizeof(m_tx_buffer),
+                                               will_qos,
+                                               will_retain,
+                                               will_topic);
+    if (datalen <= 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
     }
 
-    if (p_packet_copy && err_code != NRF_SUCCESS)
-    {
-        nrf_free(p_packet_copy);
-    }
+    mqttsn_packet_t retransmission_packet;
+    memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
 
-    return err_code;
+    return tx_buffer_send_with_retransmission(p_client,
+                                              datalen,
+                                              MQTTSN_MSGTYPE_WILLTOPICUPD,
+                                              &retransmission_packet);
 }
 
 uint32_t mqttsn_packet_sender_willmsgupd(mqttsn_client_t * p_client)
 {
-    uint32_t  err_code    = NRF_SUCCESS;
-    uint16_t  packet_len  = MQTTSN_PACKET_WILLMSG_LENGTH + p_client->connect_info.will_msg_len;
-    uint8_t * p_data      = nrf_malloc(packet_len);
-    uint8_t * p_packet_copy = NULL;
+    MQTTSNString will_msg;
+    memset(&will_msg, 0, sizeof(MQTTSNString));
+    will_msg.lenstring.data = (char *)p_client->connect_info.p_will_msg;
+    will_msg.lenstring.len  = p_client->connect_info.will_msg_len;
 
-    do
+    int datalen = MQTTSNSerialize_willmsgupd(m_tx_buffer, sizeof(m_tx_buffer), will_msg);
+    if (datalen <= 0)
     {
-        if (p_data == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            NRF_LOG_ERROR("WILLMSGUPD message cannot be allocated\r\n");
-            break;
-        }
-
-        uint16_t datalen = 0;
-
-        MQTTSNString will_msg;
-        memset(&will_msg, 0, sizeof(MQTTSNString));
-        will_msg.lenstring.data = (char *)p_client->connect_info.p_will_msg;
-        will_msg.lenstring.len  = p_client->connect_info.will_msg_len;
-
-        datalen = MQTTSNSerialize_willmsgupd(p_data, packet_len, will_msg);
-        if (datalen == 0)
-        {
-            err_code = NRF_ERROR_INVALID_PARAM;
-            break;
-        }
-
-        p_packet_copy = nrf_malloc(datalen);
-        if (p_packet_copy == NULL)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
-        memcpy(p_packet_copy, p_data, datalen);
-
-        mqttsn_packet_t retransmission_packet;
-        memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
-        retransmission_packet.retransmission_cnt = MQTTSN_DEFAULT_RETRANSMISSION_CNT;
-        retransmission_packet.p_data             = p_packet_copy;
-        retransmission_packet.len                = datalen;
-        retransmission_packet.timeout =
-            mqttsn_platform_timer_set_in_ms(MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS);
-
-        if (mqttsn_packet_fifo_elem_add(p_client, &retransmission_packet) != NRF_SUCCESS)
-        {
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
-
-        if (mqttsn_client_timeout_schedule(p_client) != NRF_SUCCESS)
-        {
-            uint32_t fifo_dequeue_rc = mqttsn_packet_fifo_elem_dequeue(p_client,
-                                                                       MQTTSN_MSGTYPE_WILLMSGUPD,
-                                                                       MQTTSN_MESSAGE_TYPE);
-            ASSERT(fifo_dequeue_rc == NRF_SUCCESS);
-            err_code = NRF_ERROR_INTERNAL;
-            break;
-        }
-
-        err_code = mqttsn_packet_sender_send(p_client, &(p_client->gateway_info.addr), p_data, datalen);
-
-    } while (0);
-
-    if (p_data)
-    {
-        nrf_free(p_data);
+        return NRF_ERROR_INVALID_PARAM;
     }
 
-    if (p_packet_copy && err_code != NRF_SUCCESS)
-    {
-        nrf_free(p_packet_copy);
-    }
+    mqttsn_packet_t retransmission_packet;
+    memset(&retransmission_packet, 0, sizeof(mqttsn_packet_t));
 
-    return err_code;
+    return tx_buffer_send_with_retransmission(p_client,
+                                              datalen,
+                                              MQTTSN_MSGTYPE_WILLMSGUPD,
+                                              &retransmission_packet);
 }
@@ -47,25 +47,78 @@
 /* Available timer is 32-bit. */
 #define MQTTSN_PLATFORM_TIMER_MAX_MS UINT32_MAX
 
-APP_TIMER_DEF(m_timer_id);
+/**@brief Platform timer of a client. */
+struct mqttsn_platform_timer_t
+{
+    app_timer_t       data;     /**< Timer node of the app_timer library. */
+    app_timer_id_t    id;       /**< Timer ID pointing at the node. */
+    bool              created;  /**< Stores whether the timer has been created; it is never deleted. */
+    mqttsn_client_t * p_client; /**< Client the timer belongs to, NULL if the timer is free. */
+};
 
 typedef app_timer_event_t mqttsn_timer_event_t;
 
+/**@brief Timers of the clients. */
+static mqttsn_platform_timer_t m_timers[MQTTSN_CLIENT_MAX_COUNT];
+
 static void timer_timeout_handler(void * p_context)
 {
     mqttsn_client_t * p_client = (mqttsn_client_t *)p_context;
     mqttsn_client_timeout_handle(p_client);    
 }
 
-uint32_t mqttsn_platform_init()
+uint32_t mqttsn_platform_init(mqttsn_client_t * p_client)
 {
-    return mqttsn_platform_timer_init();
+    return mqttsn_platform_timer_init(p_client);
 }
 
-uint32_t mqttsn_platform_timer_init()
+void mqttsn_platform_uninit(mqttsn_client_t * p_client)
 {
-    UNUSED_VARIABLE(app_timer_init());
-    return app_timer_create(&m_timer_id, APP_TIMER_MODE_SINGLE_SHOT, timer_timeout_handler);
+    if (p_client->p_timer != NULL)
+    {
+        UNUSED_RETURN_VALUE(app_timer_stop(p_client->p_timer->id));
+        p_client->p_timer->p_client = NULL;
+        p_client->p_timer           = NULL;
+    }
+}
+
+uint32_t mqttsn_platform_timer_init(mqttsn_client_t * p_client)
+{
+    mqttsn_platform_timer_t * p_timer = NULL;
+
+    for (uint32_t i = 0; i < MQTTSN_CLIENT_MAX_COUNT; i++)
+    {
+        if (m_timers[i].p_client == NULL)
+        {
+            p_timer = &m_timers[i];
+            break;
+        }
+    }
+
+    if (p_timer == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    if (!p_timer->created)
+    {
+        UNUSED_VARIABLE(app_timer_init());
+
+        p_timer->id = &p_timer->data;
+
+        uint32_t err_code = app_timer_create(&p_timer->id, APP_TIMER_MODE_SINGLE_SHOT, timer_timeout_handler);
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+
+        p_timer->created = true;
+    }
+
+    p_timer->p_client = p_client;
+    p_client->p_timer = p_timer;
+
+    return NRF_SUCCESS;
 }
 
 uint32_t mqttsn_platform_timer_start(mqttsn_client_t * p_client, uint32_t timeout_ms)
@@ -76,12 +129,12 @@ uint32_t mqttsn_platform_timer_start(mqttsn_client_t * p_client, uint32_t timeou
         timeout_ticks = APP_TIMER_MIN_TIMEOUT_TICKS;
     }
     
-    return app_timer_start(m_timer_id, timeout_ticks, p_client);
+    return app_timer_start(p_client->p_timer->id, timeout_ticks, p_client);
 }
 
-uint32_t mqttsn_platform_timer_stop()
+uint32_t mqttsn_platform_timer_stop(mqttsn_client_t * p_client)
 {
-    return app_timer_stop(m_timer_id);
+    return app_timer_stop(p_client->p_timer->id);
 }
 
 uint32_t mqttsn_platform_timer_cnt_get()
@@ -47,17 +47,30 @@ typedef void (*timer_timeout_handler_t)(void * p_context);
 
 
 /**@brief Initializes the MQTT-SN client's platform.  
+ *
+ * @param[inout] p_client            Pointer to MQTT-SN client instance.
  *
  * @return NRF_SUCCESS if the initialization has been successful. Otherwise error code is returned.
  */
-uint32_t mqttsn_platform_init(void);
+uint32_t mqttsn_platform_init(mqttsn_client_t * p_client);
 
 
-/**@brief Initializes the MQTT-SN platform's timer.  
+/**@brief Releases the MQTT-SN client's platform resources.  
  *
- * @return NRF_SUCCESS if the initialization has been successful. Otherwise error code is returned.
+ * @param[inout] p_client            Pointer to MQTT-SN client instance.
  */
-uint32_t mqttsn_platform_timer_init(void);
+void mqttsn_platform_uninit(mqttsn_client_t * p_client);
+
+
+/**@brief Initializes the MQTT-SN platform's timer of a client.  
+ *
+ * @param[inout] p_client            Pointer to MQTT-SN client instance.
+ *
+ * @retval NRF_SUCCESS      If the initialization has been successful.
+ * @retval NRF_ERROR_NO_MEM If MQTTSN_CLIENT_MAX_COUNT clients already have a timer.
+ * @return Otherwise error code is returned.
+ */
+uint32_t mqttsn_platform_timer_init(mqttsn_client_t * p_client);
 
 
 /**@brief Starts the MQTT-SN platform's timer. 
@@ -73,10 +86,12 @@ uint32_t mqttsn_platform_timer_start(mqttsn_client_t * p_client, uint32_t timeou
 
 
 /**@brief Stops the MQTT-SN platform's timer.  
+ *
+ * @param[in]    p_client            Pointer to MQTT-SN client instance.
  *
  * @return NRF_SUCCESS if the stop operation has been successful. Otherwise error code is returned.
  */
-uint32_t mqttsn_platform_timer_stop(void);
+uint32_t mqttsn_platform_timer_stop(mqttsn_client_t * p_client);
 
 
 /**@brief Gets the current MQTT-SN platform's timer value.  
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2017 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+#include "mqttsn_packet_internal.h"
+#include "mqttsn_platform.h"
+#include "nordic_common.h"
+#include <string.h>
+
+/**@brief Clock granularity (G in RFC 6298). [ms] */
+#define RTT_CLOCK_GRANULARITY_MS 1
+
+void mqttsn_rtt_init(mqttsn_client_t * p_client)
+{
+    memset(&p_client->rtt, 0, sizeof(mqttsn_rtt_t));
+    p_client->rtt.rto = MQTTSN_DEFAULT_RETRANSMISSION_TIME_IN_MS;
+}
+
+void mqttsn_rtt_packet_acked(mqttsn_client_t * p_client, const mqttsn_packet_t * p_packet)
+{
+    mqttsn_rtt_t * p_rtt = &p_client->rtt;
+
+    if (p_packet->retransmission_cnt != MQTTSN_DEFAULT_RETRANSMISSION_CNT)
+    {
+        return;
+    }
+
+    uint32_t sample = mqttsn_platform_timer_cnt_get() - p_packet->sent;
+
+    if (!p_rtt->measured)
+    {
+        p_rtt->measured = true;
+        p_rtt->srtt     = sample;
+        p_rtt->rttvar   = sample / 2;
+    }
+    else
+    {
+        uint32_t delta = (p_rtt->srtt > sample) ? (p_rtt->srtt - sample) : (sample - p_rtt->srtt);
+
+        /* RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|, SRTT = 7/8 SRTT + 1/8 R */
+        p_rtt->rttvar = (3 * p_rtt->rttvar + delta) / 4;
+        p_rtt->srtt   = (7 * p_rtt->srtt + sample) / 8;
+    }
+
+    uint32_t rto = p_rtt->srtt + MAX(RTT_CLOCK_GRANULARITY_MS, 4 * p_rtt->rttvar);
+
+    p_rtt->rto = MIN(MAX(rto, MQTTSN_MIN_RETRANSMISSION_TIME_IN_MS), MQTTSN_MAX_RETRANSMISSION_TIME_IN_MS);
+}
+
+uint32_t mqttsn_rtt_retransmission_time_get(const mqttsn_client_t * p_client, uint8_t retransmission_cnt)
+{
+    uint32_t rto = p_client->rtt.rto;
+
+    /* Exponential backoff. */
+    for (uint8_t i = retransmission_cnt; i < MQTTSN_DEFAULT_RETRANSMISSION_CNT; i++)
+    {
+        if (rto >= MQTTSN_MAX_RETRANSMISSION_TIME_IN_MS / 2)
+        {
+            return MQTTSN_MAX_RETRANSMISSION_TIME_IN_MS;
+        }
+
+        rto *= 2;
+    }
+
+    return rto;
+}
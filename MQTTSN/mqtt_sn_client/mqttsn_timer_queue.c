@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2017 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+#include "mqttsn_packet_internal.h"
+#include "nrf_error.h"
+#include <string.h>
+
+/**@brief Heap position of a timer that is not armed. */
+#define POSITION_NONE 0xFF
+
+#if MQTTSN_TIMER_COUNT >= POSITION_NONE
+#error "MQTTSN_PACKET_FIFO_MAX_LENGTH must be smaller than 252."
+#endif
+
+/**@brief Checks if the deadline of timer a comes before the deadline of timer b. */
+static inline bool is_before(const mqttsn_timer_queue_t * p_queue, uint8_t a, uint8_t b)
+{
+    return (int32_t)(p_queue->deadline[a] - p_queue->deadline[b]) < 0;
+}
+
+/**@brief Puts a timer at the given heap position and updates its position index. */
+static inline void heap_put(mqttsn_timer_queue_t * p_queue, uint8_t position, uint8_t timer)
+{
+    p_queue->heap[position]  = timer;
+    p_queue->position[timer] = position;
+}
+
+/**@brief Moves the timer at the given position towards the root until its parent is not later. */
+static void sift_up(mqttsn_timer_queue_t * p_queue, uint8_t position)
+{
+    uint8_t timer = p_queue->heap[position];
+
+    while (position > 0)
+    {
+        uint8_t parent = (position - 1) / 2;
+
+        if (!is_before(p_queue, timer, p_queue->heap[parent]))
+        {
+            break;
+        }
+
+        heap_put(p_queue, position, p_queue->heap[parent]);
+        position = parent;
+    }
+
+    heap_put(p_queue, position, timer);
+}
+
+/**@brief Moves the timer at the given position towards the leaves until no child is earlier. */
+static void sift_down(mqttsn_timer_queue_t * p_queue, uint8_t position)
+{
+    uint8_t timer = p_queue->heap[position];
+
+    for (;;)
+    {
+        uint8_t child = 2 * position + 1;
+
+        if (child >= p_queue->size)
+        {
+            break;
+        }
+
+        if ((child + 1 < p_queue->size) && is_before(p_queue, p_queue->heap[child + 1], p_queue->heap[child]))
+        {
+            child++;
+        }
+
+        if (!is_before(p_queue, p_queue->heap[child], timer))
+        {
+            break;
+        }
+
+        heap_put(p_queue, position, p_queue->heap[child]);
+        position = child;
+    }
+
+    heap_put(p_queue, position, timer);
+}
+
+void mqttsn_timer_queue_init(mqttsn_client_t * p_client)
+{
+    mqttsn_timer_queue_t * p_queue = &p_client->timer_queue;
+
+    memset(p_queue, 0, sizeof(mqttsn_timer_queue_t));
+    memset(p_queue->position, POSITION_NONE, sizeof(p_queue->position));
+}
+
+void mqttsn_timer_queue_set(mqttsn_client_t * p_client, uint8_t timer, uint32_t deadline)
+{
+    mqttsn_timer_queue_t * p_queue = &p_client->timer_queue;
+    uint8_t                position = p_queue->position[timer];
+
+    p_queue->deadline[timer] = deadline;
+
+    if (position == POSITION_NONE)
+    {
+        position = p_queue->size++;
+        heap_put(p_queue, position, timer);
+        sift_up(p_queue, position);
+        return;
+    }
+
+    sift_up(p_queue, position);
+    sift_down(p_queue, p_queue->position[timer]);
+}
+
+void mqttsn_timer_queue_cancel(mqttsn_client_t * p_client, uint8_t timer)
+{
+    mqttsn_timer_queue_t * p_queue  = &p_client->timer_queue;
+    uint8_t                position = p_queue->position[timer];
+
+    if (position == POSITION_NONE)
+    {
+        return;
+    }
+
+    p_queue->position[timer] = POSITION_NONE;
+    p_queue->size--;
+
+    if (position == p_queue->size)
+    {
+        return;
+    }
+
+    /* Fill the gap with the last timer and restore the heap order around it. */
+    uint8_t last = p_queue->heap[p_queue->size];
+
+    heap_put(p_queue, position, last);
+    sift_up(p_queue, position);
+    sift_down(p_queue, p_queue->position[last]);
+}
+
+uint32_t mqttsn_timer_queue_next_get(const mqttsn_client_t * p_client,
+                                     uint8_t               * p_timer,
+                                     uint32_t              * p_deadline)
+{
+    const mqttsn_timer_queue_t * p_queue = &p_client->timer_queue;
+
+    if (p_queue->size == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    *p_timer    = p_queue->heap[0];
+    *p_deadline = p_queue->deadline[p_queue->heap[0]];
+
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) 2017 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+#include "mqttsn_packet_internal.h"
+#include "mqttsn_transport.h"
+#include "nrf_error.h"
+#include "nrf_log.h"
+#include <string.h>
+
+/**@brief Marks the end of a bucket chain. */
+#define ENTRY_NONE 0xFF
+
+/**@brief Length of a stored entry without the topic name: topic ID and name length. */
+#define ENTRY_HEADER_LENGTH 3
+
+#if MQTTSN_TOPIC_REGISTRY_MAX_LENGTH >= ENTRY_NONE
+#error "MQTTSN_TOPIC_REGISTRY_MAX_LENGTH must be smaller than 255."
+#endif
+
+#if MQTTSN_TOPIC_NAME_MAX_LENGTH > UINT8_MAX
+#error "MQTTSN_TOPIC_NAME_MAX_LENGTH must not exceed 255."
+#endif
+
+#if MQTTSN_TOPIC_REGISTRY_SETTINGS_KEY + MQTTSN_CLIENT_MAX_COUNT * 256 > 0x10000
+#error "MQTTSN_TOPIC_REGISTRY_SETTINGS_KEY leaves no room for the keys of every client."
+#endif
+
+/**@brief Buffer the registry is serialized into for storage. */
+static uint8_t m_settings_buffer[MQTTSN_TOPIC_REGISTRY_MAX_LENGTH *
+                                 (ENTRY_HEADER_LENGTH + MQTTSN_TOPIC_NAME_MAX_LENGTH)];
+
+/**@brief Returns the bucket a topic name hashes to (32-bit FNV-1a). */
+static uint32_t bucket_get(const uint8_t * p_topic_name, uint16_t topic_name_len)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (uint16_t i = 0; i < topic_name_len; i++)
+    {
+        hash ^= p_topic_name[i];
+        hash *= 16777619UL;
+    }
+
+    return hash % MQTTSN_TOPIC_REGISTRY_BUCKETS;
+}
+
+/**@brief Returns the settings key of the client's registry for a gateway.
+ *
+ * @details Clients connected to the same gateway register their own topics, so each one has a
+ *          block of 256 keys, one per gateway ID.
+ */
+static uint16_t registry_key_get(const mqttsn_client_t * p_client, uint8_t gateway_id)
+{
+    return (uint16_t)(MQTTSN_TOPIC_REGISTRY_SETTINGS_KEY + mqttsn_transport_index_get(p_client) * 256 +
+                      gateway_id);
+}
+
+/**@brief Stores the registered topic IDs under the key of the gateway they were assigned by. */
+static void registry_store(mqttsn_client_t * p_client)
+{
+    const mqttsn_topic_registry_t * p_registry = &p_client->topic_registry;
+    uint16_t                        len        = 0;
+
+    for (uint32_t i = 0; i < p_registry->count; i++)
+    {
+        if (p_registry->topic_id[i] == 0)
+        {
+            continue;
+        }
+
+        m_settings_buffer[len++] = (uint8_t)(p_registry->topic_id[i] >> 8);
+        m_settings_buffer[len++] = (uint8_t)(p_registry->topic_id[i]);
+        m_settings_buffer[len++] = p_registry->name_len[i];
+        memcpy(&m_settings_buffer[len], p_registry->name[i], p_registry->name_len[i]);
+        len += p_registry->name_len[i];
+    }
+
+    if (mqttsn_transport_settings_set(p_client,
+                                      registry_key_get(p_client, p_registry->gateway_id),
+                                      m_settings_buffer,
+                                      len) != NRF_SUCCESS)
+    {
+        NRF_LOG_ERROR("Topic registry could not be stored.\r\n");
+    }
+}
+
+void mqttsn_topic_registry_init(mqttsn_client_t * p_client)
+{
+    mqttsn_topic_registry_t * p_registry = &p_client->topic_registry;
+
+    memset(p_registry, 0, sizeof(mqttsn_topic_registry_t));
+    memset(p_registry->bucket, ENTRY_NONE, sizeof(p_registry->bucket));
+}
+
+void mqttsn_topic_registry_load(mqttsn_client_t * p_client, uint8_t gateway_id)
+{
+    uint16_t len = sizeof(m_settings_buffer);
+    uint16_t pos = 0;
+
+    mqttsn_topic_registry_init(p_client);
+    p_client->topic_registry.gateway_id = gateway_id;
+
+    if (mqttsn_transport_settings_get(p_client,
+                                      registry_key_get(p_client, gateway_id),
+                                      m_settings_buffer,
+                                      &len) != NRF_SUCCESS)
+    {
+        return;
+    }
+
+    while (pos + ENTRY_HEADER_LENGTH <= len)
+    {
+        uint16_t topic_id       = (uint16_t)((m_settings_buffer[pos] << 8) | m_settings_buffer[pos + 1]);
+        uint8_t  topic_name_len = m_settings_buffer[pos + 2];
+
+        pos += ENTRY_HEADER_LENGTH;
+
+        if (pos + topic_name_len > len)
+        {
+            NRF_LOG_ERROR("Stored topic registry is truncated.\r\n");
+            break;
+        }
+
+        uint32_t index = mqttsn_topic_registry_add(p_client, &m_settings_buffer[pos], topic_name_len);
+        if (index != MQTTSN_TOPIC_REGISTRY_MAX_LENGTH)
+        {
+            p_client->topic_registry.topic_id[index] = topic_id;
+        }
+
+        pos += topic_name_len;
+    }
+}
+
+uint32_t mqttsn_topic_registry_find(const mqttsn_client_t * p_client,
+                                    const uint8_t         * p_topic_name,
+                                    uint16_t                topic_name_len)
+{
+    const mqttsn_topic_registry_t * p_registry = &p_client->topic_registry;
+
+    for (uint8_t index = p_registry->bucket[bucket_get(p_topic_name, topic_name_len)];
+         index != ENTRY_NONE;
+         index = p_registry->next[index])
+    {
+        if ((p_registry->name_len[index] == topic_name_len) &&
+            (memcmp(p_registry->name[index], p_topic_name, topic_name_len) == 0))
+        {
+            return index;
+        }
+    }
+
+    return MQTTSN_TOPIC_REGISTRY_MAX_LENGTH;
+}
+
+uint32_t mqttsn_topic_registry_add(mqttsn_client_t * p_client,
+                                   const uint8_t   * p_topic_name,
+                                   uint16_t          topic_name_len)
+{
+    mqttsn_topic_registry_t * p_registry = &p_client->topic_registry;
+
+    uint32_t index = mqttsn_topic_registry_find(p_client, p_topic_name, topic_name_len);
+    if (index != MQTTSN_TOPIC_REGISTRY_MAX_LENGTH)
+    {
+        return index;
+    }
+
+    if ((topic_name_len == 0) || (topic_name_len > MQTTSN_TOPIC_NAME_MAX_LENGTH) ||
+        (p_registry->count == MQTTSN_TOPIC_REGISTRY_MAX_LENGTH))
+    {
+        return MQTTSN_TOPIC_REGISTRY_MAX_LENGTH;
+    }
+
+    uint8_t * p_bucket = &p_registry->bucket[bucket_get(p_topic_name, topic_name_len)];
+
+    index = p_registry->count++;
+
+    memcpy(p_registry->name[index], p_topic_name, topic_name_len);
+    p_registry->name_len[index] = (uint8_t)topic_name_len;
+    p_registry->topic_id[index] = 0;
+    p_registry->next[index]     = *p_bucket;
+    *p_bucket                   = (uint8_t)index;
+
+    return index;
+}
+
+uint32_t mqttsn_topic_registry_name_find(const mqttsn_client_t * p_client, const uint8_t * p_topic_name)
+{
+    const mqttsn_topic_registry_t * p_registry = &p_client->topic_registry;
+
+    for (uint32_t i = 0; i < p_registry->count; i++)
+    {
+        if (p_topic_name == p_registry->name[i])
+        {
+            return i;
+        }
+    }
+
+    return MQTTSN_TOPIC_REGISTRY_MAX_LENGTH;
+}
+
+uint32_t mqttsn_topic_registry_id_find(const mqttsn_client_t * p_client, uint16_t topic_id)
+{
+    const mqttsn_topic_registry_t * p_registry = &p_client->topic_registry;
+
+    for (uint32_t i = 0; i < p_registry->count; i++)
+    {
+        if ((topic_id != 0) && (p_registry->topic_id[i] == topic_id))
+        {
+            return i;
+        }
+    }
+
+    return MQTTSN_TOPIC_REGISTRY_MAX_LENGTH;
+}
+
+void mqttsn_topic_registry_id_set(mqttsn_client_t * p_client, uint32_t index, uint16_t topic_id)
+{
+    if (p_client->topic_registry.topic_id[index] != topic_id)
+    {
+        p_client->topic_registry.topic_id[index] = topic_id;
+        registry_store(p_client);
+    }
+}
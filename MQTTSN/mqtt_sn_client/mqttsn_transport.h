@@ -51,6 +51,7 @@
  * @param[in]    p_context           Pointer to transport layer specific context.
  *
  * @retval       NRF_SUCCESS         If the initialization has been successful.
+ * @retval       NRF_ERROR_NO_MEM    If MQTTSN_CLIENT_MAX_COUNT clients already have a transport.
  * @retval       NRF_ERROR_INTERNAL  Otherwise.
  */
 uint32_t mqttsn_transport_init(mqttsn_client_t * p_client, uint16_t port, const void * p_context);
@@ -72,6 +73,120 @@ uint32_t mqttsn_transport_write(mqttsn_client_t       * p_client,
                                 uint16_t                datalen);
 
 
+/**@brief Allocates an empty message to serialize a packet into.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ *
+ * @return       Pointer to the allocated message. NULL if no message buffers are available.
+ */
+mqttsn_message_t * mqttsn_transport_message_alloc(mqttsn_client_t * p_client);
+
+
+/**@brief Appends data to the end of a message.
+ *
+ * @param[inout] p_message   Pointer to the message to append to.
+ * @param[in]    p_data      Data to append.
+ * @param[in]    datalen     Length of the data.
+ *
+ * @retval       NRF_SUCCESS      If the data has been appended.
+ * @retval       NRF_ERROR_NO_MEM If the message could not be grown.
+ */
+uint32_t mqttsn_transport_message_append(mqttsn_message_t * p_message,
+                                         const void       * p_data,
+                                         uint16_t           datalen);
+
+
+/**@brief Creates a copy of a message that has not been sent yet.
+ *
+ * @param[in]    p_message   Pointer to the message to copy.
+ *
+ * @return       Pointer to the copy. NULL if no message buffers are available.
+ */
+mqttsn_message_t * mqttsn_transport_message_clone(const mqttsn_message_t * p_message);
+
+
+/**@brief Frees a message that has not been sent.
+ *
+ * @param[in]    p_message   Pointer to the message to free.
+ */
+void mqttsn_transport_message_free(mqttsn_message_t * p_message);
+
+
+/**@brief Sends a message.
+ *
+ * @note The transport takes ownership of the message, also when sending fails.
+ *
+ * @param[inout] p_client    Pointer to initialized and connected client.
+ * @param[in]    p_remote    Pointer to remote endpoint.
+ * @param[in]    p_message   Pointer to the message to send.
+ *
+ * @return       NRF_SUCCESS if the message has been sent successfully.
+ *               Otherwise error code is returned.
+ */
+uint32_t mqttsn_transport_message_send(mqttsn_client_t       * p_client,
+                                       const mqttsn_remote_t * p_remote,
+                                       mqttsn_message_t      * p_message);
+
+
+/**@brief Requests a data poll period of the link.
+ *
+ * @details All clients of a node share the link, so the shortest period requested by any of them
+ *          is applied. The request has effect only if the node is a sleepy end device.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    period_ms   Data poll period in milliseconds, 0 to withdraw the request.
+ *
+ * @retval       NRF_SUCCESS         If the period has been applied.
+ * @retval       NRF_ERROR_INTERNAL  Otherwise.
+ */
+uint32_t mqttsn_transport_poll_period_set(mqttsn_client_t * p_client, uint32_t period_ms);
+
+
+/**@brief Returns the index of the client's transport.
+ *
+ * @details Transports are taken in order, so the index of a client stays the same across reboots
+ *          as long as the clients are initialized in the same order.
+ *
+ * @param[in]    p_client    Pointer to initialized client.
+ *
+ * @return       Index of the transport, below MQTTSN_CLIENT_MAX_COUNT.
+ */
+uint8_t mqttsn_transport_index_get(const mqttsn_client_t * p_client);
+
+
+/**@brief Reads a value from persistent storage.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    key         Key of the value.
+ * @param[out]   p_value     Buffer for the value.
+ * @param[inout] p_len       Size of the buffer on input, length of the value on output.
+ *
+ * @retval       NRF_SUCCESS         If the value has been read. It is truncated if longer than the buffer.
+ * @retval       NRF_ERROR_NOT_FOUND If no value is stored under the key.
+ * @retval       NRF_ERROR_INTERNAL  Otherwise.
+ */
+uint32_t mqttsn_transport_settings_get(mqttsn_client_t * p_client,
+                                       uint16_t          key,
+                                       uint8_t         * p_value,
+                                       uint16_t        * p_len);
+
+
+/**@brief Writes a value to persistent storage, replacing the stored one.
+ *
+ * @param[inout] p_client    Pointer to initialized client.
+ * @param[in]    key         Key of the value.
+ * @param[in]    p_value     Value to store.
+ * @param[in]    len         Length of the value.
+ *
+ * @retval       NRF_SUCCESS         If the value has been stored.
+ * @retval       NRF_ERROR_INTERNAL  Otherwise.
+ */
+uint32_t mqttsn_transport_settings_set(mqttsn_client_t * p_client,
+                                       uint16_t          key,
+                                       const uint8_t   * p_value,
+                                       uint16_t          len);
+
+
 /**@brief Receives message.  
  *
  * @param[inout] p_context          Pointer to transport layer specific context. 
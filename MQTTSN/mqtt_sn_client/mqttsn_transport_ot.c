@@ -40,11 +40,14 @@
 
 #include "mqttsn_transport.h"
 #include "mqttsn_packet_internal.h"
-#include "mem_manager.h"
+#include "nordic_common.h"
 #include "nrf_log.h"
 #include "nrf_error.h"
 
+#include <openthread/link.h>
+#include <openthread/message.h>
 #include <openthread/udp.h>
+#include <openthread/platform/settings.h>
 #include <openthread/error.h>
 
 #include <stdint.h>
@@ -56,61 +59,77 @@
         return (NRF_ERROR_NULL);                                                                   \
     }
 
-/**@brief OpenThread transport instance. */
-static otInstance * m_p_instance;
-/**@brief OpenThread UDP socket. */
-static otUdpSocket  m_socket;
+/**@brief OpenThread transport of a client. */
+struct mqttsn_transport_t
+{
+    otInstance      * p_instance; /**< OpenThread instance the socket is opened in. */
+    otUdpSocket       socket;     /**< OpenThread UDP socket. */
+    mqttsn_client_t * p_client;   /**< Client the socket belongs to, NULL if the transport is free. */
+    uint32_t          poll_period; /**< Data poll period requested by the client, 0 if none. [ms] */
+};
+
+/**@brief Transports of the clients. */
+static mqttsn_transport_t m_transports[MQTTSN_CLIENT_MAX_COUNT];
+/**@brief Buffer received datagrams are copied into before parsing.
+ *
+ * @note The receive callback runs to completion before the next datagram is read, so one static
+ *       buffer is enough and no heap memory is needed on the receive path.
+ */
+static uint8_t      m_rx_buffer[MQTTSN_RX_BUFFER_SIZE];
 
 /**@brief Callback from the OpenThread port. */
 static void port_data_callback(void                * p_context,
                                otMessage           * p_message,
                                const otMessageInfo * p_message_info)
 {
-    const mqttsn_port_t port = p_message_info->mSockPort;
-    mqttsn_remote_t     remote_endpoint;
+    mqttsn_transport_t * p_transport = (mqttsn_transport_t *)p_context;
+    const mqttsn_port_t  port = p_message_info->mSockPort;
+    mqttsn_remote_t      remote_endpoint;
 
     memcpy(remote_endpoint.addr,  p_message_info->mPeerAddr.mFields.m8, OT_IP6_ADDRESS_SIZE);
     remote_endpoint.port_number = MQTTSN_DEFAULT_GATEWAY_PORT;
 
-    uint16_t  payload_size = otMessageGetLength(p_message) - otMessageGetOffset(p_message);
-    uint8_t * p_msg        = nrf_malloc(payload_size);
+    uint16_t payload_size = otMessageGetLength(p_message) - otMessageGetOffset(p_message);
 
-    if (p_msg)
+    if ((payload_size == 0) || (payload_size > sizeof(m_rx_buffer)))
     {
-        if (otMessageRead(p_message, otMessageGetOffset(p_message), p_msg, payload_size) == payload_size)
-        {
-            if (mqttsn_transport_read(p_context, &port, &remote_endpoint, p_msg, payload_size) != 
-                NRF_SUCCESS)
-            {
-                NRF_LOG_ERROR("MQTT-SN message could not be processed.\r\n");
-            }
-        }
-        else
+        NRF_LOG_ERROR("MQTT-SN message of %d bytes dropped.\r\n", payload_size);
+        return;
+    }
+
+    if (otMessageRead(p_message, otMessageGetOffset(p_message), m_rx_buffer, payload_size) == payload_size)
+    {
+        if (mqttsn_transport_read(p_transport->p_client, &port, &remote_endpoint, m_rx_buffer, payload_size) !=
+            NRF_SUCCESS)
         {
-            NRF_LOG_ERROR("Openthread message cannot be read.\r\n");
+            NRF_LOG_ERROR("MQTT-SN message could not be processed.\r\n");
         }
-
-        nrf_free(p_msg);
     }
     else
     {
-        NRF_LOG_ERROR("Openthread message buffer cannot be allocated (receive_data_callback)\r\n");
+        NRF_LOG_ERROR("Openthread message cannot be read.\r\n");
     }
 }
 
 /**@brief Creates OpenThread network port. */
-static uint32_t port_create(mqttsn_client_t * p_client, uint16_t port)
+static uint32_t port_create(mqttsn_transport_t * p_transport, uint16_t port)
 {
     otError    err_code;
     otSockAddr addr;
 
     memset(&addr, 0, sizeof(addr));
 
-    err_code = otUdpOpen(m_p_instance, &m_socket, port_data_callback, p_client);
+    err_code = otUdpOpen(p_transport->p_instance, &p_transport->socket, port_data_callback, p_transport);
     if (err_code == OT_ERROR_NONE)
     {
         addr.mPort = port;
-        err_code   = otUdpBind(&m_socket, &addr);
+        err_code   = otUdpBind(&p_transport->socket, &addr);
+
+        if (err_code != OT_ERROR_NONE)
+        {
+            NRF_LOG_ERROR("UDP Socket cannot be bound\r\n");
+            (void)otUdpClose(&p_transport->socket);
+        }
     }
     else
     {
@@ -122,8 +141,106 @@ static uint32_t port_create(mqttsn_client_t * p_client, uint16_t port)
 
 uint32_t mqttsn_transport_init(mqttsn_client_t * p_client, uint16_t port, const void * p_context)
 {
-    m_p_instance = (otInstance *)p_context;
-    return port_create(p_client, port);
+    mqttsn_transport_t * p_transport = NULL;
+
+    for (uint32_t i = 0; i < MQTTSN_CLIENT_MAX_COUNT; i++)
+    {
+        if (m_transports[i].p_client == NULL)
+        {
+            p_transport = &m_transports[i];
+            break;
+        }
+    }
+
+    if (p_transport == NULL)
+    {
+        NRF_LOG_ERROR("No free MQTT-SN transport\r\n");
+        return NRF_ERROR_NO_MEM;
+    }
+
+    memset(p_transport, 0, sizeof(mqttsn_transport_t));
+    p_transport->p_instance = (otInstance *)p_context;
+
+    uint32_t err_code = port_create(p_transport, port);
+    if (err_code == NRF_SUCCESS)
+    {
+        p_transport->p_client = p_client;
+        p_client->p_transport = p_transport;
+    }
+
+    return err_code;
+}
+
+mqttsn_message_t * mqttsn_transport_message_alloc(mqttsn_client_t * p_client)
+{
+    otMessage * p_msg = otUdpNewMessage(p_client->p_transport->p_instance, NULL);
+    if (p_msg == NULL)
+    {
+        NRF_LOG_ERROR("Failed to allocate OT message\r\n");
+    }
+
+    return (mqttsn_message_t *)p_msg;
+}
+
+uint32_t mqttsn_transport_message_append(mqttsn_message_t * p_message,
+                                         const void       * p_data,
+                                         uint16_t           datalen)
+{
+    NULL_PARAM_CHECK(p_message);
+
+    if (otMessageAppend((otMessage *)p_message, p_data, datalen) != OT_ERROR_NONE)
+    {
+        NRF_LOG_ERROR("Failed to append message payload\r\n");
+        return NRF_ERROR_NO_MEM;
+    }
+
+    return NRF_SUCCESS;
+}
+
+mqttsn_message_t * mqttsn_transport_message_clone(const mqttsn_message_t * p_message)
+{
+    otMessage * p_msg = otMessageClone((const otMessage *)p_message);
+    if (p_msg == NULL)
+    {
+        NRF_LOG_ERROR("Failed to clone OT message\r\n");
+    }
+
+    return (mqttsn_message_t *)p_msg;
+}
+
+void mqttsn_transport_message_free(mqttsn_message_t * p_message)
+{
+    otMessageFree((otMessage *)p_message);
+}
+
+uint32_t mqttsn_transport_message_send(mqttsn_client_t       * p_client,
+                                       const mqttsn_remote_t * p_remote,
+                                       mqttsn_message_t      * p_message)
+{
+    NULL_PARAM_CHECK(p_message);
+
+    if (p_remote == NULL)
+    {
+        otMessageFree((otMessage *)p_message);
+        return NRF_ERROR_NULL;
+    }
+
+    otMessageInfo msg_info;
+
+    memset(&msg_info, 0, sizeof(msg_info));
+    msg_info.mInterfaceId = OT_NETIF_INTERFACE_ID_THREAD;
+    msg_info.mPeerPort    = p_remote->port_number;
+
+    memcpy(msg_info.mPeerAddr.mFields.m8, p_remote->addr, OT_IP6_ADDRESS_SIZE);
+
+    if (otUdpSend(&p_client->p_transport->socket, (otMessage *)p_message, &msg_info) != OT_ERROR_NONE)
+    {
+        NRF_LOG_ERROR("Failed to send message\r\n");
+        otMessageFree((otMessage *)p_message);
+        return NRF_ERROR_INTERNAL;
+    }
+
+    return NRF_SUCCESS;
 }
 
 uint32_t mqttsn_transport_write(mqttsn_client_t       * p_client,
@@ -134,52 +251,96 @@ uint32_t mqttsn_transport_write(mqttsn_client_t       * p_client,
     NULL_PARAM_CHECK(p_remote);
     NULL_PARAM_CHECK(p_data);
 
-    uint32_t      err_code = NRF_ERROR_INVALID_STATE;
-    otMessage   * p_msg    = NULL;
-    otUdpSocket * p_socket = &m_socket;
+    mqttsn_message_t * p_msg = mqttsn_transport_message_alloc(p_client);
+    if (p_msg == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
 
-    do
+    uint32_t err_code = mqttsn_transport_message_append(p_msg, p_data, datalen);
+    if (err_code != NRF_SUCCESS)
     {
-        p_msg = otUdpNewMessage(m_p_instance, true);
-        if (p_msg == NULL)
-        {
-            NRF_LOG_ERROR("Failed to allocate OT message\r\n");
-            err_code = NRF_ERROR_NO_MEM;
-            break;
-        }
+        mqttsn_transport_message_free(p_msg);
+        return err_code;
+    }
 
-        if (otMessageAppend(p_msg, p_data, datalen) != OT_ERROR_NONE)
-        {
-            NRF_LOG_ERROR("Failed to append message payload\r\n");
-            err_code = NRF_ERROR_INTERNAL;
-            break;
-        }
+    return mqttsn_transport_message_send(p_client, p_remote, p_msg);
+}
 
-        otMessageInfo msg_info;
+uint32_t mqttsn_transport_poll_period_set(mqttsn_client_t * p_client, uint32_t period_ms)
+{
+    mqttsn_transport_t * p_transport = p_client->p_transport;
+    uint32_t             period      = 0;
 
-        memset(&msg_info, 0, sizeof(msg_info));
-        msg_info.mInterfaceId = OT_NETIF_INTERFACE_ID_THREAD;
-        msg_info.mPeerPort    = p_remote->port_number;
+    NULL_PARAM_CHECK(p_transport);
 
-        memcpy(msg_info.mPeerAddr.mFields.m8, p_remote->addr, OT_IP6_ADDRESS_SIZE);
+    p_transport->poll_period = period_ms;
 
-        if (otUdpSend(p_socket, p_msg, &msg_info) != OT_ERROR_NONE)
+    for (uint32_t i = 0; i < MQTTSN_CLIENT_MAX_COUNT; i++)
+    {
+        if ((m_transports[i].p_client != NULL) && (m_transports[i].poll_period != 0) &&
+            ((period == 0) || (m_transports[i].poll_period < period)))
         {
-            NRF_LOG_ERROR("Failed to send message\r\n");
-            err_code = NRF_ERROR_INTERNAL;
-            break;
+            period = m_transports[i].poll_period;
         }
+    }
+
+    if (otLinkSetPollPeriod(p_transport->p_instance, period) != OT_ERROR_NONE)
+    {
+        NRF_LOG_ERROR("Failed to set data poll period\r\n");
+        return NRF_ERROR_INTERNAL;
+    }
+
+    return NRF_SUCCESS;
+}
+
+uint8_t mqttsn_transport_index_get(const mqttsn_client_t * p_client)
+{
+    if (p_client->p_transport == NULL)
+    {
+        return 0;
+    }
+
+    return (uint8_t)(p_client->p_transport - m_transports);
+}
+
+uint32_t mqttsn_transport_settings_get(mqttsn_client_t * p_client,
+                                       uint16_t          key,
+                                       uint8_t         * p_value,
+                                       uint16_t        * p_len)
+{
+    NULL_PARAM_CHECK(p_client->p_transport);
+
+    uint16_t size = *p_len;
+
+    switch (otPlatSettingsGet(p_client->p_transport->p_instance, key, 0, p_value, p_len))
+    {
+        case OT_ERROR_NONE:
+            *p_len = MIN(*p_len, size);
+            return NRF_SUCCESS;
 
-        err_code = NRF_SUCCESS;
+        case OT_ERROR_NOT_FOUND:
+            return NRF_ERROR_NOT_FOUND;
 
-    } while(0);
+        default:
+            return NRF_ERROR_INTERNAL;
+    }
+}
 
-    if ((p_msg != NULL) && (err_code != NRF_SUCCESS))
+uint32_t mqttsn_transport_settings_set(mqttsn_client_t * p_client,
+                                       uint16_t          key,
+                                       const uint8_t   * p_value,
+                                       uint16_t          len)
+{
+    NULL_PARAM_CHECK(p_client->p_transport);
+
+    if (otPlatSettingsSet(p_client->p_transport->p_instance, key, p_value, len) != OT_ERROR_NONE)
     {
-        otMessageFree(p_msg);
+        NRF_LOG_ERROR("Failed to store setting 0x%x\r\n", key);
+        return NRF_ERROR_INTERNAL;
     }
 
-    return err_code;
+    return NRF_SUCCESS;
 }
 
 uint32_t mqttsn_transport_read(void                   * p_context,
@@ -194,5 +355,19 @@ uint32_t mqttsn_transport_read(void                   * p_context,
 
 uint32_t mqttsn_transport_uninit(mqttsn_client_t * p_client)
 {
-    return otUdpClose(&m_socket) == OT_ERROR_NONE ? NRF_SUCCESS : NRF_ERROR_INTERNAL;
+    mqttsn_transport_t * p_transport = p_client->p_transport;
+
+    NULL_PARAM_CHECK(p_transport);
+
+    if (p_transport->poll_period != 0)
+    {
+        (void)mqttsn_transport_poll_period_set(p_client, 0);
+    }
+
+    otError err_code = otUdpClose(&p_transport->socket);
+
+    p_transport->p_client = NULL;
+    p_client->p_transport = NULL;
+
+    return err_code == OT_ERROR_NONE ? NRF_SUCCESS : NRF_ERROR_INTERNAL;
 }
@@ -70,7 +70,9 @@
 #include "app_util.h"
 #include "sdk_errors.h"
 #include "nordic_common.h"
+#ifdef FREERTOS
 #include "FreeRTOS.h"
+#endif
 #if 0
 #include "sdk_config.h"
 #include "app_error.h"
@@ -118,10 +120,8 @@ extern "C" {
  * @return     Number of timer ticks.
  */
 #ifndef FREERTOS
-#define APP_TIMER_TICKS(MS)                                \
-            ((uint32_t)ROUNDED_DIV(                        \
-            (MS) * (uint64_t)APP_TIMER_CLOCK_FREQ,         \
-            1000 * (APP_TIMER_CONFIG_RTC_FREQUENCY + 1)))
+/* The host port (app_timer_posix.c) counts in milliseconds. */
+#define APP_TIMER_TICKS(MS) ((uint32_t)(MS))
 #else
 #include "FreeRTOSConfig.h"
 #define APP_TIMER_TICKS(MS) (uint32_t)ROUNDED_DIV((MS)*configTICK_RATE_HZ,1000)
@@ -296,6 +296,22 @@ uint32_t app_timer_cnt_diff_compute(uint32_t   ticks_to,
  */
 uint8_t app_timer_op_queue_utilization_get(void);
 
+#ifndef FREERTOS
+/**@brief Function for running the handlers of all expired timers of the host port.
+ *
+ * @details The host port has no timer task, the main loop calls this function instead.
+ */
+void app_timer_process(void);
+
+/**@brief Function for getting the time until the next timer of the host port expires.
+ *
+ * @param[in]  max_ms  Value returned when no timer is running.
+ *
+ * @return    Milliseconds until the next timer expires, at most max_ms.
+ */
+uint32_t app_timer_next_timeout_get(uint32_t max_ms);
+#endif
+
 /**
  * @brief Function for pausing RTC activity which drives app_timer.
  *
@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2014 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "app_timer.h"
+#include "nrf_assert.h"
+#include "nrf_error.h"
+
+/**
+ * Note that this implementation is made only for running the SDK components on the host simulation (posix/).
+ * There is no timer task: the main loop calls app_timer_process() and sleeps at most app_timer_next_timeout_get().
+ */
+
+/**
+ * @brief Number of timers which can be created.
+ */
+#ifndef APP_TIMER_POSIX_MAX_TIMERS
+#define APP_TIMER_POSIX_MAX_TIMERS 8
+#endif
+
+/**@brief This structure keeps information about host timer.*/
+typedef struct
+{
+    void                      * argument;
+    app_timer_timeout_handler_t func;
+    uint32_t                    deadline;
+    uint32_t                    period;
+    app_timer_mode_t            mode;
+    bool                        active;
+}app_timer_info_t;
+
+/* Check if app_timer_t variable type can held our app_timer_info_t structure */
+STATIC_ASSERT(sizeof(app_timer_info_t) <= sizeof(app_timer_t));
+
+static app_timer_info_t * m_timers[APP_TIMER_POSIX_MAX_TIMERS];
+
+
+static uint32_t app_timer_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+
+uint32_t app_timer_init(void)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                          app_timer_mode_t            mode,
+                          app_timer_timeout_handler_t timeout_handler)
+{
+    app_timer_info_t * pinfo;
+    uint32_t           i;
+
+    if ((timeout_handler == NULL) || (p_timer_id == NULL))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    pinfo = (app_timer_info_t*)(*p_timer_id);
+
+    if (pinfo->active)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    for (i = 0; i < APP_TIMER_POSIX_MAX_TIMERS; i++)
+    {
+        if (m_timers[i] == pinfo)
+        {
+            break;
+        }
+    }
+
+    if (i == APP_TIMER_POSIX_MAX_TIMERS)
+    {
+        for (i = 0; i < APP_TIMER_POSIX_MAX_TIMERS; i++)
+        {
+            if (m_timers[i] == NULL)
+            {
+                break;
+            }
+        }
+
+        if (i == APP_TIMER_POSIX_MAX_TIMERS)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+
+        m_timers[i] = pinfo;
+    }
+
+    memset(pinfo, 0, sizeof(app_timer_info_t));
+    pinfo->func = timeout_handler;
+    pinfo->mode = mode;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context)
+{
+    app_timer_info_t * pinfo = (app_timer_info_t*)(timer_id);
+
+    if (pinfo->func == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    if (pinfo->active)
+    {
+        // Timer already running - exit silently
+        return NRF_SUCCESS;
+    }
+
+    pinfo->argument = p_context;
+    pinfo->deadline = app_timer_now() + timeout_ticks;
+    pinfo->period   = (pinfo->mode == APP_TIMER_MODE_REPEATED) ? timeout_ticks : 0;
+    pinfo->active   = true;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_timer_stop(app_timer_id_t timer_id)
+{
+    app_timer_info_t * pinfo = (app_timer_info_t*)(timer_id);
+
+    if (pinfo->func == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    pinfo->active = false;
+    return NRF_SUCCESS;
+}
+
+
+void app_timer_process(void)
+{
+    uint32_t now = app_timer_now();
+
+    for (uint32_t i = 0; i < APP_TIMER_POSIX_MAX_TIMERS; i++)
+    {
+        app_timer_info_t * pinfo = m_timers[i];
+
+        if ((pinfo == NULL) || !pinfo->active || ((int32_t)(pinfo->deadline - now) > 0))
+        {
+            continue;
+        }
+
+        if (pinfo->period != 0)
+        {
+            pinfo->deadline += pinfo->period;
+        }
+        else
+        {
+            pinfo->active = false;
+        }
+
+        // The handler may restart or stop this or any other timer.
+        pinfo->func(pinfo->argument);
+    }
+}
+
+
+uint32_t app_timer_next_timeout_get(uint32_t max_ms)
+{
+    uint32_t now     = app_timer_now();
+    uint32_t timeout = max_ms;
+
+    for (uint32_t i = 0; i < APP_TIMER_POSIX_MAX_TIMERS; i++)
+    {
+        app_timer_info_t * pinfo = m_timers[i];
+        int32_t            remaining;
+
+        if ((pinfo == NULL) || !pinfo->active)
+        {
+            continue;
+        }
+
+        remaining = (int32_t)(pinfo->deadline - now);
+
+        if (remaining <= 0)
+        {
+            return 0;
+        }
+
+        if ((uint32_t)remaining < timeout)
+        {
+            timeout = (uint32_t)remaining;
+        }
+    }
+
+    return timeout;
+}
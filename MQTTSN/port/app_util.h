@@ -53,7 +53,11 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#ifdef CPU_MKW41Z512VHT4
 #include "MKW41Z4.h"
+#else
+#define __REV(value) __builtin_bswap32(value)
+#endif
 //#include "compiler_abstraction.h"
 //#include "nordic_common.h"
 //#include "nrf.h"
@@ -1188,8 +1192,8 @@ static __INLINE bool is_word_aligned(void const* p)
  */
 static __INLINE bool is_address_from_stack(void * ptr)
 {
-    if (((uint32_t)ptr >= (uint32_t)STACK_BASE) &&
-        ((uint32_t)ptr <  (uint32_t)STACK_TOP) )
+    if (((uintptr_t)ptr >= (uintptr_t)STACK_BASE) &&
+        ((uintptr_t)ptr <  (uintptr_t)STACK_TOP) )
     {
         return true;
     }
@@ -0,0 +1,420 @@
+/**
+ * Copyright (c) 2014 - 2018, Nordic Semiconductor ASA
+ * 
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ * 
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ * 
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ * 
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mem_manager.h"
+#include "app_util.h"
+#include "nordic_common.h"
+#include "nrf_assert.h"
+#include "nrf_error.h"
+#include "nrf_log.h"
+
+#ifdef FREERTOS
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define MM_MUTEX_LOCK()   taskENTER_CRITICAL()
+#define MM_MUTEX_UNLOCK() taskEXIT_CRITICAL()
+#else
+#define MM_MUTEX_LOCK()
+#define MM_MUTEX_UNLOCK()
+#endif
+
+/**@brief Marks the end of a free list. */
+#define BLOCK_NONE 0xFFFF
+
+/**@brief Size of the memory taken by all blocks of a category. */
+#define CATEGORY_POOL_SIZE(CATEGORY) \
+    (MEMORY_MANAGER_##CATEGORY##_BLOCK_COUNT * MEMORY_MANAGER_##CATEGORY##_BLOCK_SIZE)
+
+/**@brief Size of the memory taken by all categories. */
+#define TOTAL_POOL_SIZE (CATEGORY_POOL_SIZE(XXSMALL) + CATEGORY_POOL_SIZE(XSMALL) + \
+                         CATEGORY_POOL_SIZE(SMALL)   + CATEGORY_POOL_SIZE(MEDIUM) + \
+                         CATEGORY_POOL_SIZE(LARGE)   + CATEGORY_POOL_SIZE(XLARGE) + \
+                         CATEGORY_POOL_SIZE(XXLARGE))
+
+/**@brief Checks that a category keeps its blocks word aligned and its free list indexable. */
+#define CATEGORY_CHECK(CATEGORY)                                                                   \
+    STATIC_ASSERT((MEMORY_MANAGER_##CATEGORY##_BLOCK_SIZE % sizeof(uint32_t)) == 0,                \
+                  "Block size of " #CATEGORY " must be a non-zero multiple of 4.");                \
+    STATIC_ASSERT(MEMORY_MANAGER_##CATEGORY##_BLOCK_SIZE > 0,                                      \
+                  "Block size of " #CATEGORY " must be a non-zero multiple of 4.");                \
+    STATIC_ASSERT(MEMORY_MANAGER_##CATEGORY##_BLOCK_COUNT < BLOCK_NONE,                            \
+                  "Too many blocks in " #CATEGORY ".")
+
+CATEGORY_CHECK(XXSMALL);
+CATEGORY_CHECK(XSMALL);
+CATEGORY_CHECK(SMALL);
+CATEGORY_CHECK(MEDIUM);
+CATEGORY_CHECK(LARGE);
+CATEGORY_CHECK(XLARGE);
+CATEGORY_CHECK(XXLARGE);
+
+STATIC_ASSERT(TOTAL_POOL_SIZE > 0, "At least one block category must be configured.");
+
+/**@brief Block category. */
+typedef struct
+{
+    uint8_t         * p_pool;     /**< First block of the category. */
+    uint16_t          free_block; /**< First block on the free list, BLOCK_NONE if all blocks are in use. */
+    nrf_mem_stats_t   stats;      /**< Configuration and usage statistics of the category. */
+} block_category_t;
+
+/**@brief Memory of all blocks, word aligned. */
+static uint32_t m_pool[CEIL_DIV(TOTAL_POOL_SIZE, sizeof(uint32_t))];
+
+/**@brief Block categories, in order of increasing block size. */
+static block_category_t m_categories[MEMORY_MANAGER_CATEGORY_COUNT] =
+{
+    { .stats = { MEMORY_MANAGER_XXSMALL_BLOCK_SIZE, MEMORY_MANAGER_XXSMALL_BLOCK_COUNT } },
+    { .stats = { MEMORY_MANAGER_XSMALL_BLOCK_SIZE,  MEMORY_MANAGER_XSMALL_BLOCK_COUNT  } },
+    { .stats = { MEMORY_MANAGER_SMALL_BLOCK_SIZE,   MEMORY_MANAGER_SMALL_BLOCK_COUNT   } },
+    { .stats = { MEMORY_MANAGER_MEDIUM_BLOCK_SIZE,  MEMORY_MANAGER_MEDIUM_BLOCK_COUNT  } },
+    { .stats = { MEMORY_MANAGER_LARGE_BLOCK_SIZE,   MEMORY_MANAGER_LARGE_BLOCK_COUNT   } },
+    { .stats = { MEMORY_MANAGER_XLARGE_BLOCK_SIZE,  MEMORY_MANAGER_XLARGE_BLOCK_COUNT  } },
+    { .stats = { MEMORY_MANAGER_XXLARGE_BLOCK_SIZE, MEMORY_MANAGER_XXLARGE_BLOCK_COUNT } },
+};
+
+/**@brief Stores whether the pools have been set up. */
+static bool m_initialized;
+
+/**@brief Returns pointer to the link to the next free block stored in a free block. */
+static inline uint16_t * block_link_get(const block_category_t * p_category, uint16_t block)
+{
+    return (uint16_t *)(p_category->p_pool + (uint32_t)block * p_category->stats.block_size);
+}
+
+/**@brief Finds the category a block belongs to.
+ *
+ * @param[in]  p_buffer  Pointer to the block.
+ * @param[out] p_block   Index of the block within the category.
+ *
+ * @return     Pointer to the category, NULL if p_buffer is not a block of the pools.
+ */
+static block_category_t * category_find(const void * p_buffer, uint16_t * p_block)
+{
+    const uint8_t * p_byte = (const uint8_t *)p_buffer;
+
+    for (uint32_t i = 0; i < MEMORY_MANAGER_CATEGORY_COUNT; i++)
+    {
+        block_category_t * p_category = &m_categories[i];
+        uint32_t           pool_size  = p_category->stats.block_count * p_category->stats.block_size;
+
+        if ((p_byte >= p_category->p_pool) && (p_byte < p_category->p_pool + pool_size))
+        {
+            uint32_t offset = (uint32_t)(p_byte - p_category->p_pool);
+
+            if ((offset % p_category->stats.block_size) != 0)
+            {
+                return NULL;
+            }
+
+            *p_block = (uint16_t)(offset / p_category->stats.block_size);
+            return p_category;
+        }
+    }
+
+    return NULL;
+}
+
+/**@brief Takes a block from the smallest category that fits the size and has a free block.
+ *
+ * @param[in]  size          Requested size.
+ * @param[out] p_block_size  Size of the block taken.
+ *
+ * @return     Pointer to the block, NULL if no fitting block is free.
+ */
+static uint8_t * block_take(uint32_t size, uint32_t * p_block_size)
+{
+    uint8_t * p_block  = NULL;
+    bool      best_fit = true;
+
+    MM_MUTEX_LOCK();
+
+    for (uint32_t i = 0; i < MEMORY_MANAGER_CATEGORY_COUNT; i++)
+    {
+        block_category_t * p_category = &m_categories[i];
+
+        if ((p_category->stats.block_count == 0) || (p_category->stats.block_size < size))
+        {
+            continue;
+        }
+
+        if (p_category->free_block == BLOCK_NONE)
+        {
+            if (best_fit)
+            {
+                p_category->stats.fail_count++;
+                best_fit = false;
+            }
+            continue;
+        }
+
+        uint16_t block = p_category->free_block;
+
+        p_block                  = (uint8_t *)block_link_get(p_category, block);
+        p_category->free_block   = *block_link_get(p_category, block);
+        p_category->stats.in_use++;
+
+        if (p_category->stats.in_use > p_category->stats.max_in_use)
+        {
+            p_category->stats.max_in_use = p_category->stats.in_use;
+        }
+        if ((p_category->stats.min_size == 0) || (size < p_category->stats.min_size))
+        {
+            p_category->stats.min_size = size;
+        }
+        if (size > p_category->stats.max_size)
+        {
+            p_category->stats.max_size = size;
+        }
+
+        *p_block_size = p_category->stats.block_size;
+        break;
+    }
+
+    MM_MUTEX_UNLOCK();
+
+    return p_block;
+}
+
+uint32_t nrf_mem_init(void)
+{
+    if (m_initialized)
+    {
+        return NRF_SUCCESS;
+    }
+
+    uint8_t * p_pool = (uint8_t *)m_pool;
+
+    for (uint32_t i = 0; i < MEMORY_MANAGER_CATEGORY_COUNT; i++)
+    {
+        block_category_t * p_category = &m_categories[i];
+        uint16_t           count      = (uint16_t)p_category->stats.block_count;
+
+        p_category->p_pool     = p_pool;
+        p_category->free_block = (count > 0) ? 0 : BLOCK_NONE;
+
+        for (uint16_t block = 0; block < count; block++)
+        {
+            *block_link_get(p_category, block) = (block + 1 < count) ? (block + 1) : BLOCK_NONE;
+        }
+
+        p_pool += (uint32_t)count * p_category->stats.block_size;
+    }
+
+    m_initialized = true;
+
+    return NRF_SUCCESS;
+}
+
+uint32_t nrf_mem_reserve(uint8_t ** pp_buffer, uint32_t * p_size)
+{
+    if ((pp_buffer == NULL) || (p_size == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    *pp_buffer = NULL;
+
+    if (!m_initialized)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    uint32_t largest = 0;
+
+    for (uint32_t i = 0; i < MEMORY_MANAGER_CATEGORY_COUNT; i++)
+    {
+        if (m_categories[i].stats.block_count > 0)
+        {
+            largest = m_categories[i].stats.block_size;
+        }
+    }
+
+    if ((*p_size == 0) || (*p_size > largest))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t  block_size;
+    uint8_t * p_block = block_take(*p_size, &block_size);
+
+    if (p_block == NULL)
+    {
+        NRF_LOG_ERROR("No memory block of %d bytes available\r\n", *p_size);
+        return NRF_ERROR_NO_MEM;
+    }
+
+    *pp_buffer = p_block;
+    *p_size    = block_size;
+
+    return NRF_SUCCESS;
+}
+
+void * nrf_malloc(uint32_t size)
+{
+    uint8_t * p_buffer = NULL;
+
+    UNUSED_RETURN_VALUE(nrf_mem_reserve(&p_buffer, &size));
+
+    return p_buffer;
+}
+
+void * nrf_calloc(uint32_t nmemb, uint32_t size)
+{
+    if ((size != 0) && (nmemb > UINT32_MAX / size))
+    {
+        return NULL;
+    }
+
+    void * p_buffer = nrf_malloc(nmemb * size);
+
+    if (p_buffer != NULL)
+    {
+        memset(p_buffer, 0, nmemb * size);
+    }
+
+    return p_buffer;
+}
+
+void nrf_free(void * p_buffer)
+{
+    uint16_t           block;
+    block_category_t * p_category;
+
+    if (p_buffer == NULL)
+    {
+        return;
+    }
+
+    p_category = category_find(p_buffer, &block);
+    if (p_category == NULL)
+    {
+        NRF_LOG_ERROR("Freed memory does not belong to the memory manager\r\n");
+        ASSERT(false);
+        return;
+    }
+
+    MM_MUTEX_LOCK();
+
+    *block_link_get(p_category, block) = p_category->free_block;
+    p_category->free_block             = block;
+    p_category->stats.in_use--;
+
+    MM_MUTEX_UNLOCK();
+}
+
+void * nrf_realloc(void * p_buffer, uint32_t size)
+{
+    uint16_t           block;
+    block_category_t * p_category;
+
+    if (p_buffer == NULL)
+    {
+        return nrf_malloc(size);
+    }
+
+    p_category = category_find(p_buffer, &block);
+    if (p_category == NULL)
+    {
+        return NULL;
+    }
+
+    /* Trimming, or growing within the block, keeps the block. */
+    if (size <= p_category->stats.block_size)
+    {
+        return p_buffer;
+    }
+
+    void * p_new = nrf_malloc(size);
+
+    if (p_new != NULL)
+    {
+        memcpy(p_new, p_buffer, p_category->stats.block_size);
+        nrf_free(p_buffer);
+    }
+
+    return p_new;
+}
+
+uint32_t nrf_mem_stats_get(uint32_t category, nrf_mem_stats_t * p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    if (category >= MEMORY_MANAGER_CATEGORY_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    MM_MUTEX_LOCK();
+    *p_stats = m_categories[category].stats;
+    MM_MUTEX_UNLOCK();
+
+    return NRF_SUCCESS;
+}
+
+#ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
+
+void nrf_mem_diagnose(void)
+{
+    NRF_LOG_INFO("Block size | Count | In use | Max in use | Min size | Max size | Failed\r\n");
+
+    for (uint32_t i = 0; i < MEMORY_MANAGER_CATEGORY_COUNT; i++)
+    {
+        nrf_mem_stats_t stats;
+
+        UNUSED_RETURN_VALUE(nrf_mem_stats_get(i, &stats));
+
+        if (stats.block_count > 0)
+        {
+            NRF_LOG_INFO("%10d | %5d | %6d | %10d | %8d | %8d | %6d\r\n",
+                         stats.block_size, stats.block_count, stats.in_use, stats.max_in_use,
+                         stats.min_size, stats.max_size, stats.fail_count);
+        }
+    }
+}
+
+#endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
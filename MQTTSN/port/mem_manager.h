@@ -56,18 +56,93 @@
  * To use fewer than seven buffer pools, do not define the count for the unwanted block
  * or explicitly set it to zero. At least one block category must be configured
  * for this module to function as expected.
+ *
+ * In this port the categories are configured with the MEMORY_MANAGER_<CATEGORY>_BLOCK_COUNT and
+ * MEMORY_MANAGER_<CATEGORY>_BLOCK_SIZE defines below, which can be overridden from the compiler
+ * command line. The defaults follow the MQTT-SN packet sizes. Free blocks of every category are
+ * chained on a free list, so allocation and freeing take constant time and the pools never
+ * fragment. A request is served from the smallest category that fits and has a free block.
  */
 
 #ifndef MEM_MANAGER_H__
 #define MEM_MANAGER_H__
 
 //#include "sdk_common.h"
-#include "FreeRTOS.h"
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**@brief Number of blocks for acknowledgements, PINGREQ without client ID and DISCONNECT. */
+#ifndef MEMORY_MANAGER_XXSMALL_BLOCK_COUNT
+#define MEMORY_MANAGER_XXSMALL_BLOCK_COUNT 8
+#endif
+#ifndef MEMORY_MANAGER_XXSMALL_BLOCK_SIZE
+#define MEMORY_MANAGER_XXSMALL_BLOCK_SIZE  8
+#endif
+
+/**@brief Number of blocks for CONNECT and PINGREQ carrying a client ID of up to 23 bytes. */
+#ifndef MEMORY_MANAGER_XSMALL_BLOCK_COUNT
+#define MEMORY_MANAGER_XSMALL_BLOCK_COUNT  8
+#endif
+#ifndef MEMORY_MANAGER_XSMALL_BLOCK_SIZE
+#define MEMORY_MANAGER_XSMALL_BLOCK_SIZE   32
+#endif
+
+/**@brief Number of blocks for REGISTER and SUBSCRIBE carrying a topic name and for short PUBLISH. */
+#ifndef MEMORY_MANAGER_SMALL_BLOCK_COUNT
+#define MEMORY_MANAGER_SMALL_BLOCK_COUNT   4
+#endif
+#ifndef MEMORY_MANAGER_SMALL_BLOCK_SIZE
+#define MEMORY_MANAGER_SMALL_BLOCK_SIZE    64
+#endif
+
+/**@brief Number of blocks for PUBLISH with a longer payload. */
+#ifndef MEMORY_MANAGER_MEDIUM_BLOCK_COUNT
+#define MEMORY_MANAGER_MEDIUM_BLOCK_COUNT  2
+#endif
+#ifndef MEMORY_MANAGER_MEDIUM_BLOCK_SIZE
+#define MEMORY_MANAGER_MEDIUM_BLOCK_SIZE   128
+#endif
+
+/**@brief Number of blocks for the longest datagram the MQTT-SN client receives (MQTTSN_RX_BUFFER_SIZE). */
+#ifndef MEMORY_MANAGER_LARGE_BLOCK_COUNT
+#define MEMORY_MANAGER_LARGE_BLOCK_COUNT   1
+#endif
+#ifndef MEMORY_MANAGER_LARGE_BLOCK_SIZE
+#define MEMORY_MANAGER_LARGE_BLOCK_SIZE    256
+#endif
+
+#ifndef MEMORY_MANAGER_XLARGE_BLOCK_COUNT
+#define MEMORY_MANAGER_XLARGE_BLOCK_COUNT  0
+#endif
+#ifndef MEMORY_MANAGER_XLARGE_BLOCK_SIZE
+#define MEMORY_MANAGER_XLARGE_BLOCK_SIZE   512
+#endif
+
+#ifndef MEMORY_MANAGER_XXLARGE_BLOCK_COUNT
+#define MEMORY_MANAGER_XXLARGE_BLOCK_COUNT 0
+#endif
+#ifndef MEMORY_MANAGER_XXLARGE_BLOCK_SIZE
+#define MEMORY_MANAGER_XXLARGE_BLOCK_SIZE  1024
+#endif
+
+/**@brief Number of block categories. */
+#define MEMORY_MANAGER_CATEGORY_COUNT      7
+
+/**@brief Usage statistics of a block category. */
+typedef struct
+{
+    uint32_t block_size;   /**< Size of a block in bytes. */
+    uint32_t block_count;  /**< Number of blocks in the category. */
+    uint32_t in_use;       /**< Number of blocks currently allocated. */
+    uint32_t max_in_use;   /**< Highest number of blocks allocated at the same time (high-water mark). */
+    uint32_t min_size;     /**< Smallest size requested from the category, 0 if none. */
+    uint32_t max_size;     /**< Largest size requested from the category, 0 if none. */
+    uint32_t fail_count;   /**< Number of requests that fitted the category best but found no free block in it. */
+} nrf_mem_stats_t;
+
 
 /**@brief Initializes Memory Manager.
  *
@@ -77,11 +152,13 @@ extern "C" {
  * @retval NRF_SUCCESS If initialization was successful.
  *         Otherwise, an error code that indicates the reason for the failure is returned.
  *
+ * @note      Every MQTT-SN client calls this API on initialization, so calls after the first one
+ *            succeed without touching the pools.
+ *
  * @warning   If this API fails, the application shall not proceed with using other APIs of this
  *            module.
  */
-// uint32_t nrf_mem_init(void);
-#define nrf_mem_init() (NRF_SUCCESS)
+uint32_t nrf_mem_init(void);
 
 
 /**@brief Reserves a block of memory for the application.
@@ -117,8 +194,7 @@ uint32_t nrf_mem_reserve(uint8_t ** pp_buffer, uint32_t * p_size);
  *
  * @retval     Valid memory location if the procedure was successful, else, NULL.
  */
-//void * nrf_malloc(uint32_t size);
-#define nrf_malloc(size) pvPortMalloc(size)
+void * nrf_malloc(uint32_t size);
 
 
 /**@brief 'calloc' styled memory allocation function.
@@ -139,8 +215,7 @@ void * nrf_calloc(uint32_t nmemb, uint32_t size);
  *
  * @param[out] p_buffer   Pointer to the memory block that is being freed.
  */
-//void nrf_free(void * p_buffer);
-#define nrf_free(p_buffer)   vPortFree(p_buffer)
+void nrf_free(void * p_buffer);
 
 
 /**@brief Memory reallocation (trim) function.
@@ -155,6 +230,21 @@ void * nrf_calloc(uint32_t nmemb, uint32_t size);
  */
 void * nrf_realloc(void *p_buffer, uint32_t size);
 
+
+/**@brief Reads usage statistics of a block category.
+ *
+ * @details Statistics are kept also without MEM_MANAGER_ENABLE_DIAGNOSTICS, so that the block counts
+ *          can be tuned from the high-water marks of a running application.
+ *
+ * @param[in]  category  Index of the category, 0 (xxsmall) to MEMORY_MANAGER_CATEGORY_COUNT - 1 (xxlarge).
+ * @param[out] p_stats   Statistics of the category.
+ *
+ * @retval     NRF_SUCCESS             If the statistics have been read.
+ * @retval     NRF_ERROR_INVALID_PARAM If the category does not exist.
+ * @retval     NRF_ERROR_NULL          If p_stats is NULL.
+ */
+uint32_t nrf_mem_stats_get(uint32_t category, nrf_mem_stats_t * p_stats);
+
 #ifdef MEM_MANAGER_ENABLE_DIAGNOSTICS
 
 /**@brief Function to print statistics related to memory blocks managed by memory manager.
@@ -84,6 +84,7 @@
 
 #define configUSE_PREEMPTION                    1
 #define configUSE_TICKLESS_IDLE                 0
+#define configLPTMR_CLOCK_HZ                    (1000) /* LPTMR is clocked from the 1 kHz LPO in tickless idle */
 #define configCPU_CLOCK_HZ                      (SystemCoreClock)
 #define configTICK_RATE_HZ                      ((TickType_t)1000)
 #define configMAX_PRIORITIES                    5
@@ -91,12 +91,13 @@ typedef enum otCoapCode
     OT_COAP_CODE_PUT    = OT_COAP_CODE(0, 3), ///< Put
     OT_COAP_CODE_DELETE = OT_COAP_CODE(0, 4), ///< Delete
 
-    OT_COAP_CODE_RESPONSE_MIN = OT_COAP_CODE(2, 0), ///< 2.00
-    OT_COAP_CODE_CREATED      = OT_COAP_CODE(2, 1), ///< Created
-    OT_COAP_CODE_DELETED      = OT_COAP_CODE(2, 2), ///< Deleted
-    OT_COAP_CODE_VALID        = OT_COAP_CODE(2, 3), ///< Valid
-    OT_COAP_CODE_CHANGED      = OT_COAP_CODE(2, 4), ///< Changed
-    OT_COAP_CODE_CONTENT      = OT_COAP_CODE(2, 5), ///< Content
+    OT_COAP_CODE_RESPONSE_MIN = OT_COAP_CODE(2, 0),  ///< 2.00
+    OT_COAP_CODE_CREATED      = OT_COAP_CODE(2, 1),  ///< Created
+    OT_COAP_CODE_DELETED      = OT_COAP_CODE(2, 2),  ///< Deleted
+    OT_COAP_CODE_VALID        = OT_COAP_CODE(2, 3),  ///< Valid
+    OT_COAP_CODE_CHANGED      = OT_COAP_CODE(2, 4),  ///< Changed
+    OT_COAP_CODE_CONTENT      = OT_COAP_CODE(2, 5),  ///< Content
+    OT_COAP_CODE_CONTINUE     = OT_COAP_CODE(2, 31), ///< Continue
 
     OT_COAP_CODE_BAD_REQUEST         = OT_COAP_CODE(4, 0),  ///< Bad Request
     OT_COAP_CODE_UNAUTHORIZED        = OT_COAP_CODE(4, 1),  ///< Unauthorized
@@ -105,6 +106,7 @@ typedef enum otCoapCode
     OT_COAP_CODE_NOT_FOUND           = OT_COAP_CODE(4, 4),  ///< Not Found
     OT_COAP_CODE_METHOD_NOT_ALLOWED  = OT_COAP_CODE(4, 5),  ///< Method Not Allowed
     OT_COAP_CODE_NOT_ACCEPTABLE      = OT_COAP_CODE(4, 6),  ///< Not Acceptable
+    OT_COAP_CODE_REQUEST_INCOMPLETE  = OT_COAP_CODE(4, 8),  ///< Request Entity Incomplete
     OT_COAP_CODE_PRECONDITION_FAILED = OT_COAP_CODE(4, 12), ///< Precondition Failed
     OT_COAP_CODE_REQUEST_TOO_LARGE   = OT_COAP_CODE(4, 13), ///< Request Entity Too Large
     OT_COAP_CODE_UNSUPPORTED_FORMAT  = OT_COAP_CODE(4, 15), ///< Unsupported Content-Format
@@ -135,11 +137,29 @@ typedef enum otCoapOptionType
     OT_COAP_OPTION_URI_QUERY      = 15, ///< Uri-Query
     OT_COAP_OPTION_ACCEPT         = 17, ///< Accept
     OT_COAP_OPTION_LOCATION_QUERY = 20, ///< Location-Query
+    OT_COAP_OPTION_BLOCK2         = 23, ///< Block2 (RFC 7959)
+    OT_COAP_OPTION_BLOCK1         = 27, ///< Block1 (RFC 7959)
+    OT_COAP_OPTION_SIZE2          = 28, ///< Size2 (RFC 7959)
     OT_COAP_OPTION_PROXY_URI      = 35, ///< Proxy-Uri
     OT_COAP_OPTION_PROXY_SCHEME   = 39, ///< Proxy-Scheme
     OT_COAP_OPTION_SIZE1          = 60, ///< Size1
 } otCoapOptionType;
 
+/**
+ * CoAP block sizes (the SZX field of the Block1 and Block2 options, RFC 7959).
+ *
+ */
+typedef enum otCoapBlockSize
+{
+    OT_COAP_BLOCK_SIZE_16   = 0, ///< 16-byte blocks
+    OT_COAP_BLOCK_SIZE_32   = 1, ///< 32-byte blocks
+    OT_COAP_BLOCK_SIZE_64   = 2, ///< 64-byte blocks
+    OT_COAP_BLOCK_SIZE_128  = 3, ///< 128-byte blocks
+    OT_COAP_BLOCK_SIZE_256  = 4, ///< 256-byte blocks
+    OT_COAP_BLOCK_SIZE_512  = 5, ///< 512-byte blocks
+    OT_COAP_BLOCK_SIZE_1024 = 6, ///< 1024-byte blocks
+} otCoapBlockSize;
+
 /**
  * This structure represents a CoAP option.
  *
@@ -321,16 +341,66 @@ typedef void (*otCoapResponseHandler)(void *               aContext,
  */
 typedef void (*otCoapRequestHandler)(void *aContext, otMessage *aMessage, const otMessageInfo *aMessageInfo);
 
+/**
+ * This function pointer is called with each block of a request body received block-wise (RFC 7959).
+ *
+ * A PUT or POST request without a Block1 option is handed over as a single, last block.
+ *
+ * @param[in]  aContext      A pointer to the resource's context information.
+ * @param[in]  aBlock        A pointer to the block data.
+ * @param[in]  aPosition     The offset of the block within the request body.
+ * @param[in]  aBlockLength  The length of the block in bytes.
+ * @param[in]  aMore         TRUE if more blocks follow, FALSE if this is the last one.
+ *
+ * @retval  OT_ERROR_NONE          The block was accepted.
+ * @retval  OT_ERROR_INVALID_ARGS  The block does not continue the body (answered with 4.08).
+ * @retval  OT_ERROR_NO_BUFS       The body is too large (answered with 4.13).
+ *
+ */
+typedef otError (*otCoapBlockwiseReceiveHook)(void *         aContext,
+                                              const uint8_t *aBlock,
+                                              uint32_t       aPosition,
+                                              uint16_t       aBlockLength,
+                                              bool           aMore);
+
+/**
+ * This function pointer is called to fill one block of a representation sent block-wise (RFC 7959).
+ *
+ * @param[in]     aContext      A pointer to the resource's context information.
+ * @param[out]    aBlock        A pointer to the buffer to fill.
+ * @param[in]     aPosition     The offset of the block within the representation.
+ * @param[inout]  aBlockLength  On input, the size of @p aBlock. On output, the number of bytes filled.
+ * @param[out]    aMore         Set to TRUE if more blocks follow, FALSE if this is the last one.
+ *
+ * @retval  OT_ERROR_NONE          The block was filled.
+ * @retval  OT_ERROR_INVALID_ARGS  @p aPosition is past the end of the representation (answered with 4.02).
+ *
+ */
+typedef otError (*otCoapBlockwiseTransmitHook)(void *    aContext,
+                                               uint8_t * aBlock,
+                                               uint32_t  aPosition,
+                                               uint16_t *aBlockLength,
+                                               bool *    aMore);
+
 /**
  * This structure represents a CoAP resource.
  *
+ * A Uri-Path whose last segment is `*` (a lone "*", or e.g. "fw" followed by a "*" segment) is a wildcard: it serves
+ * every path below its prefix that no other resource matches, the deepest such wildcard winning.
+ *
+ * When set, @p mTransmitHook serves GET requests and @p mReceiveHook serves PUT and POST requests block by block;
+ * every other request goes to @p mHandler.
+ *
  */
 typedef struct otCoapResource
 {
-    const char *           mUriPath; ///< The URI Path string
-    otCoapRequestHandler   mHandler; ///< The callback for handling a received request
-    void *                 mContext; ///< Application-specific context
-    struct otCoapResource *mNext;    ///< The next CoAP resource in the list
+    const char *                mUriPath;      ///< The URI Path string
+    otCoapRequestHandler        mHandler;      ///< The callback for handling a received request
+    void *                      mContext;      ///< Application-specific context
+    otCoapBlockwiseReceiveHook  mReceiveHook;  ///< The callback for block-wise request bodies (may be NULL)
+    otCoapBlockwiseTransmitHook mTransmitHook; ///< The callback for block-wise representations (may be NULL)
+    uint32_t                    mUriHash;      ///< The hash of the URI Path string (set when added)
+    struct otCoapResource *     mNext;         ///< The next CoAP resource in the list
 } otCoapResource;
 
 /**
@@ -426,6 +496,49 @@ otError otCoapMessageAppendUintOption(otMessage *aMessage, uint16_t aNumber, uin
  */
 otError otCoapMessageAppendObserveOption(otMessage *aMessage, uint32_t aObserve);
 
+/**
+ * This function appends a Block1 or Block2 option (RFC 7959).
+ *
+ * @param[inout]  aMessage  A pointer to the CoAP message.
+ * @param[in]     aNumber   The option number, OT_COAP_OPTION_BLOCK1 or OT_COAP_OPTION_BLOCK2.
+ * @param[in]     aNum      The block number.
+ * @param[in]     aMore     TRUE if more blocks follow.
+ * @param[in]     aSize     The block size.
+ *
+ * @retval OT_ERROR_NONE          Successfully appended the option.
+ * @retval OT_ERROR_INVALID_ARGS  The option type is not equal or greater than the last option type, or the block
+ *                                number does not fit in 20 bits.
+ * @retval OT_ERROR_NO_BUFS       The option length exceeds the buffer size.
+ *
+ */
+otError otCoapMessageAppendBlockOption(otMessage *     aMessage,
+                                       uint16_t        aNumber,
+                                       uint32_t        aNum,
+                                       bool            aMore,
+                                       otCoapBlockSize aSize);
+
+/**
+ * This function reads a Block1 or Block2 option (RFC 7959).
+ *
+ * @note This function restarts the option iteration of @p aMessage.
+ *
+ * @param[in]   aMessage  A pointer to the CoAP message.
+ * @param[in]   aNumber   The option number, OT_COAP_OPTION_BLOCK1 or OT_COAP_OPTION_BLOCK2.
+ * @param[out]  aNum      The block number.
+ * @param[out]  aMore     TRUE if more blocks follow.
+ * @param[out]  aSize     The block size.
+ *
+ * @retval OT_ERROR_NONE       Successfully read the option.
+ * @retval OT_ERROR_NOT_FOUND  The message has no such option.
+ * @retval OT_ERROR_PARSE      The option is malformed.
+ *
+ */
+otError otCoapMessageReadBlockOption(otMessage *      aMessage,
+                                     uint16_t         aNumber,
+                                     uint32_t *       aNum,
+                                     bool *           aMore,
+                                     otCoapBlockSize *aSize);
+
 /**
  * This function appends a Uri-Path option.
  *
@@ -690,6 +803,55 @@ void otCoapSetDefaultHandler(otInstance *aInstance, otCoapRequestHandler aHandle
  */
 otError otCoapSendResponse(otInstance *aInstance, otMessage *aMessage, const otMessageInfo *aMessageInfo);
 
+/**
+ * This function processes the Observe option of a GET request for an observable resource (RFC 7641).
+ *
+ * It is meant to be called from the handler of @p aResource while preparing the response. Observe 0 registers (or
+ * refreshes) the sender as an observer and appends an Observe option to @p aResponse, Observe 1 deregisters it.
+ * Other requests are left untouched.
+ *
+ * @note The token of @p aResponse must be set and no option greater than Observe may have been appended yet.
+ *
+ * @param[in]  aInstance     A pointer to an OpenThread instance.
+ * @param[in]  aResource     A pointer to the resource addressed by @p aRequest.
+ * @param[in]  aRequest      A pointer to the CoAP request.
+ * @param[in]  aMessageInfo  A pointer to the message info associated with @p aRequest.
+ * @param[in]  aResponse     A pointer to the CoAP response being prepared for @p aRequest.
+ *
+ * @retval OT_ERROR_NONE     Successfully processed the Observe option, if any.
+ * @retval OT_ERROR_NO_BUFS  The observer list is full or there is not enough buffer to append the option.
+ *
+ */
+otError otCoapProcessObserveRequest(otInstance *          aInstance,
+                                    const otCoapResource *aResource,
+                                    otMessage *           aRequest,
+                                    const otMessageInfo * aMessageInfo,
+                                    otMessage *           aResponse);
+
+/**
+ * This function sends a notification with a new representation of a resource to its observers.
+ *
+ * Only observers that registered with an Accept of @p aContentFormat (text/plain when they sent none) are notified;
+ * notifications in any other format than text/plain carry a Content-Format option. Every
+ * `OPENTHREAD_CONFIG_COAP_OBSERVE_CONFIRMABLE_INTERVAL`th notification to an observer is confirmable. An observer
+ * that does not acknowledge it, or answers any notification with a reset, is removed.
+ *
+ * @param[in]  aInstance       A pointer to an OpenThread instance.
+ * @param[in]  aResource       A pointer to the resource.
+ * @param[in]  aContentFormat  The content format of @p aPayload.
+ * @param[in]  aPayload        A pointer to the payload of the notification.
+ * @param[in]  aLength         The length of @p aPayload in bytes.
+ *
+ * @retval OT_ERROR_NONE     Successfully sent the notification to all matching observers (if any).
+ * @retval OT_ERROR_NO_BUFS  Insufficient buffers to notify one or more observers.
+ *
+ */
+otError otCoapNotifyObservers(otInstance *          aInstance,
+                              const otCoapResource *aResource,
+                              uint16_t              aContentFormat,
+                              const void *          aPayload,
+                              uint16_t              aLength);
+
 /**
  * @}
  *
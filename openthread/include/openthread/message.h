@@ -295,6 +295,21 @@ int otMessageRead(const otMessage *aMessage, uint16_t aOffset, void *aBuf, uint1
  */
 int otMessageWrite(otMessage *aMessage, uint16_t aOffset, const void *aBuf, uint16_t aLength);
 
+/**
+ * Create a copy of a message.
+ *
+ * The copy has the same content, offset and reserved header space as the original, so it can be sent in place of
+ * the original, e.g. when retransmitting a message whose original has already been handed over to the stack.
+ *
+ * @param[in]  aMessage  A pointer to a message buffer.
+ *
+ * @returns A pointer to the message copy or NULL if no message buffers are available.
+ *
+ * @sa otMessageFree
+ *
+ */
+otMessage *otMessageClone(const otMessage *aMessage);
+
 /**
  * This structure represents an OpenThread message queue.
  */
@@ -60,6 +60,58 @@ extern "C" {
  */
 void otPlatSettingsInit(otInstance *aInstance);
 
+/// Signals that a group of setting changes is about to begin
+/** Setting changes made until the matching call to
+ *  otPlatSettingsCommitChange() may be staged by the platform
+ *  and written to the setting store together. Calls may be
+ *  nested; only the outermost commit writes the staged changes.
+ *
+ *  @param[in] aInstance
+ *             The OpenThread instance structure.
+ *
+ *  @retval OT_ERROR_NONE
+ *          The settings change was started successfully.
+ *  @retval OT_ERROR_NOT_IMPLEMENTED
+ *          This function is not implemented on this platform.
+ */
+otError otPlatSettingsBeginChange(otInstance *aInstance);
+
+/// Commits the changes made since the call to otPlatSettingsBeginChange()
+/** This function writes the setting changes staged since the
+ *  matching call to otPlatSettingsBeginChange() to the setting store.
+ *
+ *  @param[in] aInstance
+ *             The OpenThread instance structure.
+ *
+ *  @retval OT_ERROR_NONE
+ *          The changes were committed successfully.
+ *  @retval OT_ERROR_INVALID_STATE
+ *          No settings change was in progress.
+ *  @retval OT_ERROR_NO_BUFS
+ *          The setting store has no room for the staged changes,
+ *          which are discarded and the change ended.
+ *  @retval OT_ERROR_NOT_IMPLEMENTED
+ *          This function is not implemented on this platform.
+ */
+otError otPlatSettingsCommitChange(otInstance *aInstance);
+
+/// Discards the changes made since the call to otPlatSettingsBeginChange()
+/** This function drops all setting changes that are still
+ *  staged and ends the settings change, including any outer
+ *  nested ones.
+ *
+ *  @param[in] aInstance
+ *             The OpenThread instance structure.
+ *
+ *  @retval OT_ERROR_NONE
+ *          The staged changes were discarded.
+ *  @retval OT_ERROR_INVALID_STATE
+ *          No settings change was in progress.
+ *  @retval OT_ERROR_NOT_IMPLEMENTED
+ *          This function is not implemented on this platform.
+ */
+otError otPlatSettingsAbandonChange(otInstance *aInstance);
+
 /// Fetches the value of a setting
 /** This function fetches the value of the setting identified
  *  by aKey and write it to the memory pointed to by aValue.
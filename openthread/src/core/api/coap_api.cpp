@@ -93,6 +93,24 @@ otError otCoapMessageAppendObserveOption(otMessage *aMessage, uint32_t aObserve)
     return static_cast<Coap::Message *>(aMessage)->AppendObserveOption(aObserve);
 }
 
+otError otCoapMessageAppendBlockOption(otMessage *     aMessage,
+                                       uint16_t        aNumber,
+                                       uint32_t        aNum,
+                                       bool            aMore,
+                                       otCoapBlockSize aSize)
+{
+    return static_cast<Coap::Message *>(aMessage)->AppendBlockOption(aNumber, aNum, aMore, aSize);
+}
+
+otError otCoapMessageReadBlockOption(otMessage *      aMessage,
+                                     uint16_t         aNumber,
+                                     uint32_t *       aNum,
+                                     bool *           aMore,
+                                     otCoapBlockSize *aSize)
+{
+    return static_cast<Coap::Message *>(aMessage)->ReadBlockOption(aNumber, *aNum, *aMore, *aSize);
+}
+
 otError otCoapMessageAppendUriPathOptions(otMessage *aMessage, const char *aUriPath)
 {
     return static_cast<Coap::Message *>(aMessage)->AppendUriPathOptions(aUriPath);
@@ -224,4 +242,29 @@ otError otCoapSendResponse(otInstance *aInstance, otMessage *aMessage, const otM
                                                      *static_cast<const Ip6::MessageInfo *>(aMessageInfo));
 }
 
+otError otCoapProcessObserveRequest(otInstance *          aInstance,
+                                    const otCoapResource *aResource,
+                                    otMessage *           aRequest,
+                                    const otMessageInfo * aMessageInfo,
+                                    otMessage *           aResponse)
+{
+    Instance &instance = *static_cast<Instance *>(aInstance);
+
+    return instance.GetApplicationCoap().ProcessObserveRequest(
+        *static_cast<const Coap::Resource *>(aResource), *static_cast<Coap::Message *>(aRequest),
+        *static_cast<const Ip6::MessageInfo *>(aMessageInfo), *static_cast<Coap::Message *>(aResponse));
+}
+
+otError otCoapNotifyObservers(otInstance *          aInstance,
+                              const otCoapResource *aResource,
+                              uint16_t              aContentFormat,
+                              const void *          aPayload,
+                              uint16_t              aLength)
+{
+    Instance &instance = *static_cast<Instance *>(aInstance);
+
+    return instance.GetApplicationCoap().NotifyObservers(*static_cast<const Coap::Resource *>(aResource),
+                                                         aContentFormat, aPayload, aLength);
+}
+
 #endif // OPENTHREAD_ENABLE_APPLICATION_COAP
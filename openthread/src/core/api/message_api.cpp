@@ -112,6 +112,12 @@ int otMessageWrite(otMessage *aMessage, uint16_t aOffset, const void *aBuf, uint
     return message.Write(aOffset, aLength, aBuf);
 }
 
+otMessage *otMessageClone(const otMessage *aMessage)
+{
+    const Message &message = *static_cast<const Message *>(aMessage);
+    return message.Clone();
+}
+
 void otMessageQueueInit(otMessageQueue *aQueue)
 {
     aQueue->mData = NULL;
@@ -51,15 +51,16 @@ namespace Coap {
 CoapBase::CoapBase(Instance &aInstance, Sender aSender)
     : InstanceLocator(aInstance)
     , mRetransmissionTimer(aInstance, &Coap::HandleRetransmissionTimer, this)
-    , mResources(NULL)
     , mContext(NULL)
     , mInterceptor(NULL)
     , mResponsesQueue(aInstance)
     , mDefaultHandler(NULL)
     , mDefaultHandlerContext(NULL)
+    , mObserveSequence(0)
     , mSender(aSender)
 {
     mMessageId = Random::GetUint16();
+    memset(mResources, 0, sizeof(mResources));
 }
 
 void CoapBase::ClearRequestsAndResponses(void)
@@ -68,6 +69,8 @@ void CoapBase::ClearRequestsAndResponses(void)
     Message *    messageToRemove;
     CoapMetadata coapMetadata;
 
+    RemoveObservers(NULL);
+
     // Remove all pending messages.
     while (message != NULL)
     {
@@ -83,15 +86,31 @@ void CoapBase::ClearRequestsAndResponses(void)
 
 otError CoapBase::AddResource(Resource &aResource)
 {
-    otError error = OT_ERROR_NONE;
+    otError    error = OT_ERROR_NONE;
+    Resource **bucket;
+    Resource * last = NULL;
+
+    aResource.mUriHash = Resource::HashUriPath(Resource::kUriHashInit, aResource.mUriPath,
+                                               static_cast<uint16_t>(strlen(aResource.mUriPath)));
+    bucket             = &mResources[aResource.mUriHash % kResourceBuckets];
 
-    for (Resource *cur = mResources; cur; cur = cur->GetNext())
+    for (Resource *cur = *bucket; cur; cur = cur->GetNext())
     {
         VerifyOrExit(cur != &aResource, error = OT_ERROR_ALREADY);
+        last = cur;
     }
 
-    aResource.mNext = mResources;
-    mResources      = &aResource;
+    // appended at the tail, so of two resources with the same path the one added first keeps answering
+    aResource.mNext = NULL;
+
+    if (last == NULL)
+    {
+        *bucket = &aResource;
+    }
+    else
+    {
+        last->mNext = &aResource;
+    }
 
 exit:
     return error;
@@ -99,13 +118,15 @@ exit:
 
 void CoapBase::RemoveResource(Resource &aResource)
 {
-    if (mResources == &aResource)
+    Resource **bucket = &mResources[aResource.mUriHash % kResourceBuckets];
+
+    if (*bucket == &aResource)
     {
-        mResources = aResource.GetNext();
+        *bucket = aResource.GetNext();
     }
     else
     {
-        for (Resource *cur = mResources; cur; cur = cur->GetNext())
+        for (Resource *cur = *bucket; cur; cur = cur->GetNext())
         {
             if (cur->mNext == &aResource)
             {
@@ -117,6 +138,7 @@ void CoapBase::RemoveResource(Resource &aResource)
 
 exit:
     aResource.mNext = NULL;
+    RemoveObservers(&aResource);
 }
 
 void CoapBase::SetDefaultHandler(otCoapRequestHandler aHandler, void *aContext)
@@ -216,24 +238,22 @@ exit:
     return error;
 }
 
-otError CoapBase::SendHeaderResponse(Message::Code aCode, const Message &aRequest, const Ip6::MessageInfo &aMessageInfo)
+otError CoapBase::InitResponse(Message &aResponse, Message::Code aCode, const Message &aRequest)
 {
-    otError  error   = OT_ERROR_NONE;
-    Message *message = NULL;
+    otError error = OT_ERROR_NONE;
 
     VerifyOrExit(aRequest.IsRequest(), error = OT_ERROR_INVALID_ARGS);
-    VerifyOrExit((message = NewMessage()) != NULL, error = OT_ERROR_NO_BUFS);
 
     switch (aRequest.GetType())
     {
     case OT_COAP_TYPE_CONFIRMABLE:
-        message->Init(OT_COAP_TYPE_ACKNOWLEDGMENT, aCode);
-        message->SetMessageId(aRequest.GetMessageId());
+        aResponse.Init(OT_COAP_TYPE_ACKNOWLEDGMENT, aCode);
+        aResponse.SetMessageId(aRequest.GetMessageId());
         break;
 
     case OT_COAP_TYPE_NON_CONFIRMABLE:
-        message->Init(OT_COAP_TYPE_NON_CONFIRMABLE, aCode);
-        message->SetMessageId(mMessageId++);
+        aResponse.Init(OT_COAP_TYPE_NON_CONFIRMABLE, aCode);
+        aResponse.SetMessageId(mMessageId++);
         break;
 
     default:
@@ -241,8 +261,21 @@ otError CoapBase::SendHeaderResponse(Message::Code aCode, const Message &aReques
         break;
     }
 
-    message->SetToken(aRequest.GetToken(), aRequest.GetTokenLength());
+    aResponse.SetToken(aRequest.GetToken(), aRequest.GetTokenLength());
+
+exit:
+    return error;
+}
+
+otError CoapBase::SendHeaderResponse(Message::Code aCode, const Message &aRequest, const Ip6::MessageInfo &aMessageInfo)
+{
+    otError  error   = OT_ERROR_NONE;
+    Message *message = NULL;
+
+    VerifyOrExit(aRequest.IsRequest(), error = OT_ERROR_INVALID_ARGS);
+    VerifyOrExit((message = NewMessage()) != NULL, error = OT_ERROR_NO_BUFS);
 
+    SuccessOrExit(error = InitResponse(*message, aCode, aRequest));
     SuccessOrExit(error = SendMessage(*message, aMessageInfo));
 
 exit:
@@ -514,6 +547,12 @@ void CoapBase::ProcessReceivedResponse(Message &aMessage, const Ip6::MessageInfo
 
     if (request == NULL)
     {
+        if (aMessage.GetType() == OT_COAP_TYPE_RESET)
+        {
+            // The peer may reject a non-confirmable notification (RFC 7641, p. 3.6).
+            ProcessNotificationReset(aMessage, aMessageInfo);
+        }
+
         ExitNow();
     }
 
@@ -543,6 +582,11 @@ void CoapBase::ProcessReceivedResponse(Message &aMessage, const Ip6::MessageInfo
             {
                 DequeueMessage(*request);
             }
+            else if (!request->IsRequest())
+            {
+                // An acknowledged confirmable response (e.g. an Observe notification) completes the exchange.
+                FinalizeCoapTransaction(*request, coapMetadata, NULL, NULL, OT_ERROR_NONE);
+            }
         }
         else if (aMessage.IsResponse() && aMessage.IsTokenEqual(*request))
         {
@@ -581,10 +625,13 @@ exit:
 
 void CoapBase::ProcessReceivedRequest(Message &aMessage, const Ip6::MessageInfo &aMessageInfo)
 {
-    char     uriPath[Resource::kMaxReceivedUriPath];
-    char *   curUriPath     = uriPath;
-    Message *cachedResponse = NULL;
-    otError  error          = OT_ERROR_NOT_FOUND;
+    uint8_t         segment[Resource::kMaxReceivedUriSegment];
+    uint32_t        hash = Resource::kUriHashInit;
+    uint32_t        prefixHash[Resource::kMaxWildcardDepth];
+    uint8_t         segments       = 0;
+    const Resource *resource       = NULL;
+    Message *       cachedResponse = NULL;
+    otError         error          = OT_ERROR_NOT_FOUND;
 
     if (mInterceptor != NULL)
     {
@@ -611,15 +658,21 @@ void CoapBase::ProcessReceivedRequest(Message &aMessage, const Ip6::MessageInfo
         switch (option->mNumber)
         {
         case OT_COAP_OPTION_URI_PATH:
-            if (curUriPath != uriPath)
+            VerifyOrExit(option->mLength <= sizeof(segment));
+
+            if (segments < Resource::kMaxWildcardDepth)
             {
-                *curUriPath++ = '/';
+                prefixHash[segments] = hash;
             }
 
-            VerifyOrExit(option->mLength < sizeof(uriPath) - static_cast<size_t>(curUriPath + 1 - uriPath));
+            if (segments > 0)
+            {
+                hash = Resource::HashUriPath(hash, "/", 1);
+            }
 
-            aMessage.GetOptionValue(curUriPath);
-            curUriPath += option->mLength;
+            aMessage.GetOptionValue(segment);
+            hash = Resource::HashUriPath(hash, segment, option->mLength);
+            segments++;
             break;
 
         default:
@@ -627,16 +680,41 @@ void CoapBase::ProcessReceivedRequest(Message &aMessage, const Ip6::MessageInfo
         }
     }
 
-    curUriPath[0] = '\0';
+    resource = FindResource(aMessage, hash, segments, false);
 
-    for (const Resource *resource = mResources; resource; resource = resource->GetNext())
+    // Fall back to the deepest wildcard subtree enclosing the path.
+    for (uint8_t depth = (segments < Resource::kMaxWildcardDepth) ? segments
+                                                                   : static_cast<uint8_t>(Resource::kMaxWildcardDepth);
+         resource == NULL && depth > 0; depth--)
     {
-        if (strcmp(resource->mUriPath, uriPath) == 0)
+        uint8_t prefix = depth - 1;
+
+        hash     = Resource::HashUriPath(prefixHash[prefix], (prefix > 0) ? "/*" : "*", (prefix > 0) ? 2 : 1);
+        resource = FindResource(aMessage, hash, prefix, true);
+    }
+
+    if (resource != NULL)
+    {
+        if (resource->mTransmitHook != NULL && aMessage.GetCode() == OT_COAP_CODE_GET)
+        {
+            ProcessBlock2Request(*resource, aMessage, aMessageInfo);
+        }
+        else if (resource->mReceiveHook != NULL &&
+                 (aMessage.GetCode() == OT_COAP_CODE_PUT || aMessage.GetCode() == OT_COAP_CODE_POST))
+        {
+            ProcessBlock1Request(*resource, aMessage, aMessageInfo);
+        }
+        else if (resource->mHandler != NULL)
         {
             resource->HandleRequest(aMessage, aMessageInfo);
-            error = OT_ERROR_NONE;
-            ExitNow();
         }
+        else
+        {
+            SendHeaderResponse(OT_COAP_CODE_METHOD_NOT_ALLOWED, aMessage, aMessageInfo);
+        }
+
+        error = OT_ERROR_NONE;
+        ExitNow();
     }
 
     if (mDefaultHandler)
@@ -665,6 +743,435 @@ exit:
     return;
 }
 
+const Resource *CoapBase::FindResource(Message &aMessage, uint32_t aHash, uint8_t aSegments, bool aWildcard) const
+{
+    const Resource *resource;
+
+    for (resource = mResources[aHash % kResourceBuckets]; resource != NULL; resource = resource->GetNext())
+    {
+        if (resource->mUriHash == aHash && IsUriPathMatch(*resource, aMessage, aSegments, aWildcard))
+        {
+            break;
+        }
+    }
+
+    return resource;
+}
+
+bool CoapBase::IsUriPathMatch(const Resource &aResource, Message &aMessage, uint8_t aSegments, bool aWildcard)
+{
+    bool        match = false;
+    const char *cur   = aResource.mUriPath;
+    uint8_t     segment[Resource::kMaxReceivedUriSegment];
+    uint8_t     count = 0;
+
+    // Compare segment by segment, the first aSegments Uri-Path options against the resource path.
+    for (const otCoapOption *option = aMessage.GetFirstOption(); option != NULL && count < aSegments;
+         option = aMessage.GetNextOption())
+    {
+        if (option->mNumber != OT_COAP_OPTION_URI_PATH)
+        {
+            continue;
+        }
+
+        if (count > 0)
+        {
+            VerifyOrExit(*cur++ == '/');
+        }
+
+        VerifyOrExit(option->mLength <= sizeof(segment));
+        aMessage.GetOptionValue(segment);
+
+        for (uint16_t i = 0; i < option->mLength; i++)
+        {
+            VerifyOrExit(*cur != '\0' && *cur++ == static_cast<char>(segment[i]));
+        }
+
+        count++;
+    }
+
+    VerifyOrExit(count == aSegments);
+
+    if (aWildcard)
+    {
+        match = (strcmp(cur, (count > 0) ? "/*" : "*") == 0);
+    }
+    else
+    {
+        match = (*cur == '\0');
+    }
+
+exit:
+    return match;
+}
+
+void CoapBase::ProcessBlock1Request(const Resource &aResource, Message &aRequest, const Ip6::MessageInfo &aMessageInfo)
+{
+    uint8_t         block[kMaxBlockLength];
+    uint16_t        length = aRequest.GetLength() - aRequest.GetOffset();
+    uint32_t        num    = 0;
+    bool            more   = false;
+    otCoapBlockSize size   = static_cast<otCoapBlockSize>(kMaxBlockSize);
+    bool            blockWise;
+    Message::Code   code;
+
+    // A request without Block1 carries the whole body as its last block.
+    blockWise = (aRequest.ReadBlockOption(OT_COAP_OPTION_BLOCK1, num, more, size) == OT_ERROR_NONE);
+
+    if (length > sizeof(block))
+    {
+        // Ask the client to restart with blocks we can hold (RFC 7959, p. 2.9.3).
+        SendBlockResponse(OT_COAP_CODE_REQUEST_TOO_LARGE, aRequest, aMessageInfo, OT_COAP_OPTION_BLOCK1, num, more,
+                          static_cast<otCoapBlockSize>(kMaxBlockSize), NULL, 0);
+        ExitNow();
+    }
+
+    if (more && length != Message::GetBlockLength(size))
+    {
+        SendHeaderResponse(OT_COAP_CODE_BAD_REQUEST, aRequest, aMessageInfo);
+        ExitNow();
+    }
+
+    aRequest.Read(aRequest.GetOffset(), length, block);
+
+    switch (aResource.mReceiveHook(aResource.mContext, block, num * Message::GetBlockLength(size), length, more))
+    {
+    case OT_ERROR_NONE:
+        code = more ? OT_COAP_CODE_CONTINUE : OT_COAP_CODE_CHANGED;
+        break;
+
+    case OT_ERROR_INVALID_ARGS:
+        code = OT_COAP_CODE_REQUEST_INCOMPLETE;
+        break;
+
+    case OT_ERROR_NO_BUFS:
+        code = OT_COAP_CODE_REQUEST_TOO_LARGE;
+        break;
+
+    default:
+        code = OT_COAP_CODE_INTERNAL_ERROR;
+        break;
+    }
+
+    if (blockWise)
+    {
+        SendBlockResponse(code, aRequest, aMessageInfo, OT_COAP_OPTION_BLOCK1, num, more, size, NULL, 0);
+    }
+    else
+    {
+        SendHeaderResponse(code, aRequest, aMessageInfo);
+    }
+
+exit:
+    return;
+}
+
+void CoapBase::ProcessBlock2Request(const Resource &aResource, Message &aRequest, const Ip6::MessageInfo &aMessageInfo)
+{
+    uint8_t         block[kMaxBlockLength];
+    uint16_t        length;
+    uint32_t        num  = 0;
+    bool            more = false;
+    otCoapBlockSize size = static_cast<otCoapBlockSize>(kMaxBlockSize);
+
+    if (aRequest.ReadBlockOption(OT_COAP_OPTION_BLOCK2, num, more, size) == OT_ERROR_NONE &&
+        Message::GetBlockLength(size) > kMaxBlockLength)
+    {
+        // Serve the requested bytes in our smaller blocks (RFC 7959, p. 2.4).
+        num <<= size - kMaxBlockSize;
+        size = static_cast<otCoapBlockSize>(kMaxBlockSize);
+    }
+
+    length = Message::GetBlockLength(size);
+
+    switch (aResource.mTransmitHook(aResource.mContext, block, num * length, &length, &more))
+    {
+    case OT_ERROR_NONE:
+        SendBlockResponse(OT_COAP_CODE_CONTENT, aRequest, aMessageInfo, OT_COAP_OPTION_BLOCK2, num, more, size, block,
+                          length);
+        break;
+
+    case OT_ERROR_INVALID_ARGS:
+        SendHeaderResponse(OT_COAP_CODE_BAD_OPTION, aRequest, aMessageInfo);
+        break;
+
+    default:
+        SendHeaderResponse(OT_COAP_CODE_INTERNAL_ERROR, aRequest, aMessageInfo);
+        break;
+    }
+}
+
+otError CoapBase::SendBlockResponse(Message::Code           aCode,
+                                    const Message &         aRequest,
+                                    const Ip6::MessageInfo &aMessageInfo,
+                                    uint16_t                aNumber,
+                                    uint32_t                aNum,
+                                    bool                    aMore,
+                                    otCoapBlockSize         aSize,
+                                    const uint8_t *         aBlock,
+                                    uint16_t                aBlockLength)
+{
+    otError  error   = OT_ERROR_NONE;
+    Message *message = NULL;
+
+    VerifyOrExit((message = NewMessage()) != NULL, error = OT_ERROR_NO_BUFS);
+
+    SuccessOrExit(error = InitResponse(*message, aCode, aRequest));
+    SuccessOrExit(error = message->AppendBlockOption(aNumber, aNum, aMore, aSize));
+
+    if (aBlockLength > 0)
+    {
+        SuccessOrExit(error = message->SetPayloadMarker());
+        SuccessOrExit(error = message->Append(aBlock, aBlockLength));
+    }
+
+    SuccessOrExit(error = SendMessage(*message, aMessageInfo));
+
+exit:
+
+    if (error != OT_ERROR_NONE && message != NULL)
+    {
+        message->Free();
+    }
+
+    return error;
+}
+
+otError CoapBase::ProcessObserveRequest(const Resource &        aResource,
+                                        Message &               aRequest,
+                                        const Ip6::MessageInfo &aMessageInfo,
+                                        Message &               aResponse)
+{
+    otError   error    = OT_ERROR_NONE;
+    Observer *observer = NULL;
+    uint32_t  observe;
+    uint32_t  accept;
+
+    VerifyOrExit(aRequest.GetCode() == OT_COAP_CODE_GET);
+    VerifyOrExit(aRequest.ReadUintOption(OT_COAP_OPTION_OBSERVE, observe) == OT_ERROR_NONE);
+
+    observer = FindObserver(aResource, aMessageInfo);
+
+    switch (observe)
+    {
+    case kObserveRegister:
+        if (observer == NULL)
+        {
+            for (uint8_t i = 0; i < kMaxObservers; i++)
+            {
+                if (!mObservers[i].IsInUse())
+                {
+                    observer = &mObservers[i];
+                    break;
+                }
+            }
+
+            VerifyOrExit(observer != NULL, error = OT_ERROR_NO_BUFS);
+
+            observer->mResource          = &aResource;
+            observer->mNotificationCount = 0;
+            observer->mConfirming        = false;
+        }
+
+        // A registration from a known endpoint replaces its token (RFC 7641, p. 4.1).
+        observer->mMessageInfo = aMessageInfo;
+        observer->mMessageInfo.SetLinkInfo(NULL);
+        observer->mTokenLength = aRequest.GetTokenLength();
+        memcpy(observer->mToken, aRequest.GetToken(), observer->mTokenLength);
+
+        if (aRequest.ReadUintOption(OT_COAP_OPTION_ACCEPT, accept) != OT_ERROR_NONE)
+        {
+            accept = OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN;
+        }
+
+        observer->mContentFormat = static_cast<uint16_t>(accept);
+
+        if ((error = aResponse.AppendObserveOption(mObserveSequence)) != OT_ERROR_NONE)
+        {
+            RemoveObserver(*observer);
+        }
+
+        break;
+
+    case kObserveDeregister:
+        if (observer != NULL && observer->IsTokenEqual(aRequest))
+        {
+            RemoveObserver(*observer);
+        }
+
+        break;
+
+    default:
+        break;
+    }
+
+exit:
+    return error;
+}
+
+otError CoapBase::NotifyObservers(const Resource &aResource,
+                                  uint16_t        aContentFormat,
+                                  const void *    aPayload,
+                                  uint16_t        aLength)
+{
+    otError error = OT_ERROR_NONE;
+
+    mObserveSequence = (mObserveSequence + 1) & kObserveSequenceMask;
+
+    for (uint8_t i = 0; i < kMaxObservers; i++)
+    {
+        if (mObservers[i].mResource == &aResource && mObservers[i].mContentFormat == aContentFormat &&
+            SendNotification(mObservers[i], aPayload, aLength) != OT_ERROR_NONE)
+        {
+            error = OT_ERROR_NO_BUFS;
+        }
+    }
+
+    return error;
+}
+
+otError CoapBase::SendNotification(Observer &aObserver, const void *aPayload, uint16_t aLength)
+{
+    otError  error   = OT_ERROR_NONE;
+    Message *message = NULL;
+    bool     confirmable;
+
+    if (aObserver.mNotificationCount < kObserveConfirmPeriod)
+    {
+        aObserver.mNotificationCount++;
+    }
+
+    // Keep at most one confirmable notification in flight per observer.
+    confirmable = (aObserver.mNotificationCount >= kObserveConfirmPeriod) && !aObserver.mConfirming;
+
+    VerifyOrExit((message = NewMessage()) != NULL, error = OT_ERROR_NO_BUFS);
+
+    message->Init(confirmable ? OT_COAP_TYPE_CONFIRMABLE : OT_COAP_TYPE_NON_CONFIRMABLE, OT_COAP_CODE_CONTENT);
+    message->SetMessageId(mMessageId++);
+    message->SetToken(aObserver.mToken, aObserver.mTokenLength);
+    SuccessOrExit(error = message->AppendObserveOption(mObserveSequence));
+
+    if (aObserver.mContentFormat != OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN)
+    {
+        SuccessOrExit(error = message->AppendUintOption(OT_COAP_OPTION_CONTENT_FORMAT, aObserver.mContentFormat));
+    }
+
+    if (aLength > 0)
+    {
+        SuccessOrExit(error = message->SetPayloadMarker());
+        SuccessOrExit(error = message->Append(aPayload, aLength));
+    }
+
+    aObserver.mMessageId = message->GetMessageId();
+
+    if (confirmable)
+    {
+        SuccessOrExit(error = SendMessage(*message, aObserver.mMessageInfo, &CoapBase::HandleNotificationResponse,
+                                          &aObserver));
+        aObserver.mNotificationCount = 0;
+        aObserver.mConfirming        = true;
+    }
+    else
+    {
+        SuccessOrExit(error = SendMessage(*message, aObserver.mMessageInfo));
+    }
+
+exit:
+
+    if (error != OT_ERROR_NONE && message != NULL)
+    {
+        message->Free();
+    }
+
+    return error;
+}
+
+void CoapBase::HandleNotificationResponse(void *               aContext,
+                                          otMessage *          aMessage,
+                                          const otMessageInfo *aMessageInfo,
+                                          otError              aResult)
+{
+    Observer &observer = *static_cast<Observer *>(aContext);
+
+    OT_UNUSED_VARIABLE(aMessage);
+    OT_UNUSED_VARIABLE(aMessageInfo);
+
+    observer.mConfirming = false;
+
+    if (aResult != OT_ERROR_NONE)
+    {
+        // Not acknowledged or rejected: the observer is gone (RFC 7641, p. 4.5).
+        observer.Clear();
+    }
+}
+
+void CoapBase::ProcessNotificationReset(const Message &aMessage, const Ip6::MessageInfo &aMessageInfo)
+{
+    for (uint8_t i = 0; i < kMaxObservers; i++)
+    {
+        Observer &observer = mObservers[i];
+
+        if (observer.IsInUse() && observer.mMessageId == aMessage.GetMessageId() &&
+            observer.mMessageInfo.GetPeerAddr() == aMessageInfo.GetPeerAddr() &&
+            observer.mMessageInfo.GetPeerPort() == aMessageInfo.GetPeerPort())
+        {
+            RemoveObserver(observer);
+        }
+    }
+}
+
+Observer *CoapBase::FindObserver(const Resource &aResource, const Ip6::MessageInfo &aMessageInfo)
+{
+    Observer *observer = NULL;
+
+    for (uint8_t i = 0; i < kMaxObservers; i++)
+    {
+        if (mObservers[i].mResource == &aResource &&
+            mObservers[i].mMessageInfo.GetPeerAddr() == aMessageInfo.GetPeerAddr() &&
+            mObservers[i].mMessageInfo.GetPeerPort() == aMessageInfo.GetPeerPort())
+        {
+            observer = &mObservers[i];
+            break;
+        }
+    }
+
+    return observer;
+}
+
+void CoapBase::RemoveObserver(Observer &aObserver)
+{
+    // Drop a pending confirmable notification so that it cannot clear a reused entry later on.
+    if (aObserver.mConfirming)
+    {
+        AbortTransaction(&CoapBase::HandleNotificationResponse, &aObserver);
+    }
+
+    aObserver.Clear();
+}
+
+void CoapBase::RemoveObservers(const Resource *aResource)
+{
+    for (uint8_t i = 0; i < kMaxObservers; i++)
+    {
+        if (mObservers[i].IsInUse() && (aResource == NULL || mObservers[i].mResource == aResource))
+        {
+            RemoveObserver(mObservers[i]);
+        }
+    }
+}
+
+uint32_t Resource::HashUriPath(uint32_t aHash, const void *aData, uint16_t aLength)
+{
+    const uint8_t *data = static_cast<const uint8_t *>(aData);
+
+    for (uint16_t i = 0; i < aLength; i++)
+    {
+        aHash = (aHash ^ data[i]) * kUriHashPrime;
+    }
+
+    return aHash;
+}
+
 CoapMetadata::CoapMetadata(bool                    aConfirmable,
                            const Ip6::MessageInfo &aMessageInfo,
                            otCoapResponseHandler   aHandler,
@@ -84,6 +84,29 @@ enum
     kNonLifetime      = kMaxTransmitSpan + kMaxLatency
 };
 
+/**
+ * Observe Constants (RFC 7641).
+ *
+ */
+enum
+{
+    kObserveRegister      = 0,        ///< Observe option value of a registration.
+    kObserveDeregister    = 1,        ///< Observe option value of a deregistration.
+    kObserveSequenceMask  = 0xffffff, ///< Notification sequence numbers are 24 bits long.
+    kMaxObservers         = OPENTHREAD_CONFIG_COAP_SERVER_MAX_OBSERVERS,
+    kObserveConfirmPeriod = OPENTHREAD_CONFIG_COAP_OBSERVE_CONFIRMABLE_INTERVAL,
+};
+
+/**
+ * Block-wise Transfer Constants (RFC 7959).
+ *
+ */
+enum
+{
+    kMaxBlockSize   = OPENTHREAD_CONFIG_COAP_BLOCKWISE_MAX_BLOCK_SIZE, ///< Largest block size (SZX) served.
+    kMaxBlockLength = 16 << kMaxBlockSize,                             ///< Largest block length in bytes.
+};
+
 /**
  * This class implements metadata required for CoAP retransmission.
  *
@@ -203,7 +226,10 @@ class Resource : public otCoapResource
 public:
     enum
     {
-        kMaxReceivedUriPath = 32, ///< Maximum supported URI path on received messages.
+        kMaxReceivedUriSegment = 32,         ///< Maximum supported Uri-Path segment on received messages.
+        kMaxWildcardDepth      = 8,          ///< Deepest wildcard prefix tried for a received Uri-Path.
+        kUriHashInit           = 0x811c9dc5, ///< Initial value of a Uri-Path hash (32-bit FNV-1a).
+        kUriHashPrime          = 0x01000193, ///< Multiplier of a Uri-Path hash (32-bit FNV-1a).
     };
 
     /**
@@ -215,10 +241,13 @@ public:
      */
     Resource(const char *aUriPath, otCoapRequestHandler aHandler, void *aContext)
     {
-        mUriPath = aUriPath;
-        mHandler = aHandler;
-        mContext = aContext;
-        mNext    = NULL;
+        mUriPath      = aUriPath;
+        mHandler      = aHandler;
+        mContext      = aContext;
+        mReceiveHook  = NULL;
+        mTransmitHook = NULL;
+        mUriHash      = 0;
+        mNext         = NULL;
     }
 
     /**
@@ -237,6 +266,20 @@ public:
      */
     const char *GetUriPath(void) const { return mUriPath; };
 
+    /**
+     * This static method extends a Uri-Path hash with more bytes of the path.
+     *
+     * Hashing a path piece by piece, segments and '/' separators alike, yields the hash of the whole path string.
+     *
+     * @param[in]  aHash    The hash of the preceding part of the path, or `kUriHashInit`.
+     * @param[in]  aData    A pointer to the bytes to add.
+     * @param[in]  aLength  The number of bytes to add.
+     *
+     * @returns The extended hash.
+     *
+     */
+    static uint32_t HashUriPath(uint32_t aHash, const void *aData, uint16_t aLength);
+
 private:
     void HandleRequest(Message &aMessage, const Ip6::MessageInfo &aMessageInfo) const
     {
@@ -244,6 +287,78 @@ private:
     }
 };
 
+/**
+ * This class implements an entry of the CoAP Observe (RFC 7641) observer list.
+ *
+ */
+class Observer
+{
+    friend class CoapBase;
+
+public:
+    /**
+     * Default constructor for the object.
+     *
+     */
+    Observer(void)
+        : mResource(NULL)
+        , mMessageInfo()
+        , mTokenLength(0)
+        , mMessageId(0)
+        , mContentFormat(OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN)
+        , mNotificationCount(0)
+        , mConfirming(false)
+    {
+    }
+
+    /**
+     * This method indicates whether or not the entry holds a registration.
+     *
+     * @retval TRUE   If the entry holds a registration.
+     * @retval FALSE  If the entry is free.
+     *
+     */
+    bool IsInUse(void) const { return mResource != NULL; }
+
+    /**
+     * This method returns the resource observed by this entry.
+     *
+     * @returns A pointer to the observed resource or NULL if the entry is free.
+     *
+     */
+    const Resource *GetResource(void) const { return mResource; }
+
+    /**
+     * This method returns the message info used to send notifications to the observer.
+     *
+     * @returns The message info of the observer.
+     *
+     */
+    const Ip6::MessageInfo &GetMessageInfo(void) const { return mMessageInfo; }
+
+private:
+    void Clear(void)
+    {
+        mResource   = NULL;
+        mConfirming = false;
+    }
+
+    bool IsTokenEqual(const Message &aMessage) const
+    {
+        return ((mTokenLength == aMessage.GetTokenLength()) &&
+                (memcmp(mToken, aMessage.GetToken(), mTokenLength) == 0));
+    }
+
+    const Resource * mResource;
+    Ip6::MessageInfo mMessageInfo;
+    uint8_t          mToken[OT_COAP_MAX_TOKEN_LENGTH];
+    uint8_t          mTokenLength;
+    uint16_t         mMessageId;         ///< Message ID of the last notification, to match a reset to it.
+    uint16_t         mContentFormat;     ///< Accept option of the registration, text/plain without one.
+    uint8_t          mNotificationCount; ///< Notifications sent since the last confirmable one.
+    bool             mConfirming;        ///< A confirmable notification awaits its acknowledgment.
+};
+
 /**
  * This class implements metadata required for caching CoAP responses.
  *
@@ -460,7 +575,7 @@ public:
     typedef otError (*Interceptor)(const Message &aMessage, const Ip6::MessageInfo &aMessageInfo, void *aContext);
 
     /**
-     * This method clears requests and responses used by this CoAP agent.
+     * This method clears requests, responses and observers used by this CoAP agent.
      *
      */
     void ClearRequestsAndResponses(void);
@@ -618,6 +733,49 @@ public:
      */
     otError AbortTransaction(otCoapResponseHandler aHandler, void *aContext);
 
+    /**
+     * This method processes the Observe option of a GET request for an observable resource (RFC 7641).
+     *
+     * Observe 0 registers (or refreshes) the sender as an observer of @p aResource and appends an Observe option
+     * carrying the current sequence number to @p aResponse. The Accept option of the registration, text/plain if
+     * absent, selects which notifications the observer receives. Observe 1 removes the matching registration.
+     * Requests without an Observe option are ignored.
+     *
+     * @note The token of @p aResponse must be set and no option greater than Observe may have been appended yet.
+     *
+     * @param[in]  aResource     A reference to the resource addressed by @p aRequest.
+     * @param[in]  aRequest      A reference to the CoAP request.
+     * @param[in]  aMessageInfo  The message info corresponding to @p aRequest.
+     * @param[in]  aResponse     A reference to the CoAP response being prepared for @p aRequest.
+     *
+     * @retval OT_ERROR_NONE     Successfully processed the Observe option, if any.
+     * @retval OT_ERROR_NO_BUFS  The observer list is full or there is not enough buffer to append the option.
+     *
+     */
+    otError ProcessObserveRequest(const Resource &        aResource,
+                                  Message &               aRequest,
+                                  const Ip6::MessageInfo &aMessageInfo,
+                                  Message &               aResponse);
+
+    /**
+     * This method sends a notification with a new representation of a resource to its observers.
+     *
+     * Only observers that registered with an Accept of @p aContentFormat are notified; notifications in any format
+     * other than text/plain carry a Content-Format option. Every
+     * `OPENTHREAD_CONFIG_COAP_OBSERVE_CONFIRMABLE_INTERVAL`th notification to an observer is confirmable. An observer
+     * that does not acknowledge it, or answers any notification with a reset, is removed.
+     *
+     * @param[in]  aResource       A reference to the resource.
+     * @param[in]  aContentFormat  The content format of @p aPayload.
+     * @param[in]  aPayload        A pointer to the payload of the notification.
+     * @param[in]  aLength         The length of @p aPayload in bytes.
+     *
+     * @retval OT_ERROR_NONE     Successfully sent the notification to all matching observers (if any).
+     * @retval OT_ERROR_NO_BUFS  Insufficient buffers to notify one or more observers.
+     *
+     */
+    otError NotifyObservers(const Resource &aResource, uint16_t aContentFormat, const void *aPayload, uint16_t aLength);
+
     /**
      * This method sets interceptor to be called before processing a CoAP packet.
      *
@@ -688,6 +846,33 @@ private:
     otError SendCopy(const Message &aMessage, const Ip6::MessageInfo &aMessageInfo);
     otError SendEmptyMessage(Message::Type aType, const Message &aRequest, const Ip6::MessageInfo &aMessageInfo);
 
+    otError InitResponse(Message &aResponse, Message::Code aCode, const Message &aRequest);
+    void    ProcessBlock1Request(const Resource &aResource, Message &aRequest, const Ip6::MessageInfo &aMessageInfo);
+    void    ProcessBlock2Request(const Resource &aResource, Message &aRequest, const Ip6::MessageInfo &aMessageInfo);
+    otError SendBlockResponse(Message::Code           aCode,
+                              const Message &         aRequest,
+                              const Ip6::MessageInfo &aMessageInfo,
+                              uint16_t                aNumber,
+                              uint32_t                aNum,
+                              bool                    aMore,
+                              otCoapBlockSize         aSize,
+                              const uint8_t *         aBlock,
+                              uint16_t                aBlockLength);
+
+    const Resource *FindResource(Message &aMessage, uint32_t aHash, uint8_t aSegments, bool aWildcard) const;
+    static bool     IsUriPathMatch(const Resource &aResource, Message &aMessage, uint8_t aSegments, bool aWildcard);
+
+    Observer *FindObserver(const Resource &aResource, const Ip6::MessageInfo &aMessageInfo);
+    void      RemoveObserver(Observer &aObserver);
+    void      RemoveObservers(const Resource *aResource);
+    void      ProcessNotificationReset(const Message &aMessage, const Ip6::MessageInfo &aMessageInfo);
+    otError   SendNotification(Observer &aObserver, const void *aPayload, uint16_t aLength);
+
+    static void HandleNotificationResponse(void *               aContext,
+                                           otMessage *          aMessage,
+                                           const otMessageInfo *aMessageInfo,
+                                           otError              aResult);
+
     /**
      * This method sends a message.
      *
@@ -707,7 +892,12 @@ private:
     uint16_t          mMessageId;
     TimerMilliContext mRetransmissionTimer;
 
-    Resource *mResources;
+    enum
+    {
+        kResourceBuckets = OPENTHREAD_CONFIG_COAP_SERVER_RESOURCE_BUCKETS,
+    };
+
+    Resource *mResources[kResourceBuckets];
 
     void *         mContext;
     Interceptor    mInterceptor;
@@ -716,6 +906,9 @@ private:
     otCoapRequestHandler mDefaultHandler;
     void *               mDefaultHandlerContext;
 
+    Observer mObservers[kMaxObservers];
+    uint32_t mObserveSequence;
+
     Sender mSender;
 };
 
@@ -156,6 +156,18 @@ otError Message::AppendObserveOption(uint32_t aObserve)
     return AppendUintOption(OT_COAP_OPTION_OBSERVE, aObserve & 0xFFFFFF);
 }
 
+otError Message::AppendBlockOption(uint16_t aNumber, uint32_t aNum, bool aMore, otCoapBlockSize aSize)
+{
+    otError error = OT_ERROR_NONE;
+
+    VerifyOrExit(aNum <= kBlockNumMax, error = OT_ERROR_INVALID_ARGS);
+
+    error = AppendUintOption(aNumber, (aNum << kBlockNumOffset) | (aMore ? kBlockMoreFlag : 0) | aSize);
+
+exit:
+    return error;
+}
+
 otError Message::AppendUriPathOptions(const char *aUriPath)
 {
     otError     error = OT_ERROR_NONE;
@@ -302,6 +314,51 @@ exit:
     return error;
 }
 
+otError Message::ReadUintOption(uint16_t aNumber, uint32_t &aValue)
+{
+    otError             error = OT_ERROR_NOT_FOUND;
+    const otCoapOption *option;
+    uint8_t             value[sizeof(aValue)];
+
+    for (option = GetFirstOption(); option != NULL; option = GetNextOption())
+    {
+        if (option->mNumber == aNumber)
+        {
+            break;
+        }
+    }
+
+    VerifyOrExit(option != NULL);
+    VerifyOrExit(option->mLength <= sizeof(value), error = OT_ERROR_PARSE);
+    SuccessOrExit(error = GetOptionValue(value));
+
+    aValue = 0;
+
+    for (uint16_t i = 0; i < option->mLength; i++)
+    {
+        aValue = (aValue << 8) | value[i];
+    }
+
+exit:
+    return error;
+}
+
+otError Message::ReadBlockOption(uint16_t aNumber, uint32_t &aNum, bool &aMore, otCoapBlockSize &aSize)
+{
+    otError  error;
+    uint32_t value;
+
+    SuccessOrExit(error = ReadUintOption(aNumber, value));
+    VerifyOrExit((value & kBlockSizeMask) <= OT_COAP_BLOCK_SIZE_1024, error = OT_ERROR_PARSE);
+
+    aNum  = value >> kBlockNumOffset;
+    aMore = (value & kBlockMoreFlag) != 0;
+    aSize = static_cast<otCoapBlockSize>(value & kBlockSizeMask);
+
+exit:
+    return error;
+}
+
 otError Message::SetPayloadMarker(void)
 {
     otError error  = OT_ERROR_NONE;
@@ -431,6 +488,9 @@ const char *Message::CodeToString(void) const
     case OT_COAP_CODE_CHANGED:
         codeString = "Changed";
         break;
+    case OT_COAP_CODE_CONTINUE:
+        codeString = "Continue";
+        break;
     case OT_COAP_CODE_BAD_REQUEST:
         codeString = "BadRequest";
         break;
@@ -446,6 +506,9 @@ const char *Message::CodeToString(void) const
     case OT_COAP_CODE_NOT_ACCEPTABLE:
         codeString = "NotAcceptable";
         break;
+    case OT_COAP_CODE_REQUEST_INCOMPLETE:
+        codeString = "RequestIncomplete";
+        break;
     case OT_COAP_CODE_PRECONDITION_FAILED:
         codeString = "PreconditionFailed";
         break;
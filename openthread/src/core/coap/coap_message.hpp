@@ -302,6 +302,22 @@ public:
      */
     otError AppendObserveOption(uint32_t aObserve);
 
+    /**
+     * This method appends a Block1 or Block2 option (RFC 7959).
+     *
+     * @param[in]  aNumber  The option number, OT_COAP_OPTION_BLOCK1 or OT_COAP_OPTION_BLOCK2.
+     * @param[in]  aNum     The block number.
+     * @param[in]  aMore    TRUE if more blocks follow.
+     * @param[in]  aSize    The block size.
+     *
+     * @retval OT_ERROR_NONE          Successfully appended the option.
+     * @retval OT_ERROR_INVALID_ARGS  The option type is not equal or greater than the last option type, or the block
+     *                                number does not fit in 20 bits.
+     * @retval OT_ERROR_NO_BUFS       The option length exceeds the buffer size.
+     *
+     */
+    otError AppendBlockOption(uint16_t aNumber, uint32_t aNum, bool aMore, otCoapBlockSize aSize);
+
     /**
      * This method appends a Uri-Path option.
      *
@@ -381,6 +397,48 @@ public:
      */
     otError GetOptionValue(void *aValue) const;
 
+    /**
+     * This method reads the value of the first unsigned integer option with a given number.
+     *
+     * @note This method restarts the option iteration.
+     *
+     * @param[in]   aNumber  The CoAP Option number.
+     * @param[out]  aValue   The option value.
+     *
+     * @retval OT_ERROR_NONE       Successfully read the option.
+     * @retval OT_ERROR_NOT_FOUND  The message has no such option.
+     * @retval OT_ERROR_PARSE      The option is longer than four bytes.
+     *
+     */
+    otError ReadUintOption(uint16_t aNumber, uint32_t &aValue);
+
+    /**
+     * This method reads a Block1 or Block2 option (RFC 7959).
+     *
+     * @note This method restarts the option iteration.
+     *
+     * @param[in]   aNumber  The option number, OT_COAP_OPTION_BLOCK1 or OT_COAP_OPTION_BLOCK2.
+     * @param[out]  aNum     The block number.
+     * @param[out]  aMore    TRUE if more blocks follow.
+     * @param[out]  aSize    The block size.
+     *
+     * @retval OT_ERROR_NONE       Successfully read the option.
+     * @retval OT_ERROR_NOT_FOUND  The message has no such option.
+     * @retval OT_ERROR_PARSE      The option is malformed.
+     *
+     */
+    otError ReadBlockOption(uint16_t aNumber, uint32_t &aNum, bool &aMore, otCoapBlockSize &aSize);
+
+    /**
+     * This method returns the length of a block in bytes.
+     *
+     * @param[in]  aSize  The block size.
+     *
+     * @returns The number of bytes in a block of size @p aSize.
+     *
+     */
+    static uint16_t GetBlockLength(otCoapBlockSize aSize) { return static_cast<uint16_t>(16 << aSize); }
+
     /**
      * This method adds Payload Marker indicating beginning of the payload to the CoAP header.
      *
@@ -541,6 +599,11 @@ private:
         kOption1ByteExtensionOffset = 13,  ///< Delta/Length offset as specified (RFC 7252).
         kOption2ByteExtensionOffset = 269, ///< Delta/Length offset as specified (RFC 7252).
 
+        kBlockSizeMask  = 0x07,    ///< Block SZX mask as specified (RFC 7959).
+        kBlockMoreFlag  = 0x08,    ///< Block M flag as specified (RFC 7959).
+        kBlockNumOffset = 4,       ///< Block NUM offset as specified (RFC 7959).
+        kBlockNumMax    = 0xfffff, ///< Block NUM is at most 20 bits long (RFC 7959).
+
         kHelpDataAlignment = sizeof(uint16_t), ///< Alignment of help data.
     };
 
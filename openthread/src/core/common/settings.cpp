@@ -101,6 +101,36 @@ void Settings::Wipe(void)
     otLogInfoCore("Non-volatile: Wiped all info");
 }
 
+otError Settings::BeginChange(void)
+{
+    otError error = otPlatSettingsBeginChange(&GetInstance());
+
+    // a platform without grouped changes simply writes each setting as it is saved
+    if (error == OT_ERROR_NOT_IMPLEMENTED)
+    {
+        error = OT_ERROR_NONE;
+    }
+
+    return error;
+}
+
+otError Settings::CommitChange(void)
+{
+    otError error = otPlatSettingsCommitChange(&GetInstance());
+
+    if (error == OT_ERROR_NOT_IMPLEMENTED)
+    {
+        error = OT_ERROR_NONE;
+    }
+
+    return error;
+}
+
+void Settings::AbandonChange(void)
+{
+    IgnoreReturnValue(otPlatSettingsAbandonChange(&GetInstance()));
+}
+
 otError Settings::SaveOperationalDataset(bool aIsActive, const MeshCoP::Dataset &aDataset)
 {
     otError error = Save(aIsActive ? kKeyActiveDataset : kKeyPendingDataset, aDataset.GetBytes(), aDataset.GetSize());
@@ -184,6 +184,32 @@ public:
      */
     void Wipe(void);
 
+    /**
+     * This method starts a group of settings changes which the platform may write together.
+     *
+     * Every call must be matched by a call to `CommitChange()` or `AbandonChange()`. On a platform that does not
+     * group changes the settings saved in between are written one by one.
+     *
+     * @retval OT_ERROR_NONE              Successfully started the change, or the platform does not group changes.
+     *
+     */
+    otError BeginChange(void);
+
+    /**
+     * This method commits the settings changes made since `BeginChange()`.
+     *
+     * @retval OT_ERROR_NONE              Successfully committed the changes, or the platform does not group changes.
+     * @retval OT_ERROR_NO_BUFS           The platform has no room left for the changes.
+     *
+     */
+    otError CommitChange(void);
+
+    /**
+     * This method discards the settings changes made since `BeginChange()` that are not yet written.
+     *
+     */
+    void AbandonChange(void);
+
     /**
      * This method saves the Operational Dataset (active or pending).
      *
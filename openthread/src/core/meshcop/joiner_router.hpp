@@ -131,7 +131,7 @@ public:
      * Default constructor for the object.
      *
      */
-    DelayedJoinEntHeader(void) { memset(this, 0, sizeof(*this)); }
+    DelayedJoinEntHeader(void) { memset(reinterpret_cast<void *>(this), 0, sizeof(*this)); }
 
     /**
      * This constructor initializes the object with specific values.
@@ -523,6 +523,52 @@
 #define OPENTHREAD_CONFIG_COAP_SERVER_MAX_CACHED_RESPONSES 10
 #endif
 
+/**
+ * @def OPENTHREAD_CONFIG_COAP_SERVER_RESOURCE_BUCKETS
+ *
+ * Number of hash buckets a CoAP server spreads its resources over.
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_COAP_SERVER_RESOURCE_BUCKETS
+#define OPENTHREAD_CONFIG_COAP_SERVER_RESOURCE_BUCKETS 8
+#endif
+
+/**
+ * @def OPENTHREAD_CONFIG_COAP_SERVER_MAX_OBSERVERS
+ *
+ * Maximum number of CoAP Observe (RFC 7641) registrations held by a CoAP server, shared by all its resources.
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_COAP_SERVER_MAX_OBSERVERS
+#define OPENTHREAD_CONFIG_COAP_SERVER_MAX_OBSERVERS 4
+#endif
+
+/**
+ * @def OPENTHREAD_CONFIG_COAP_OBSERVE_CONFIRMABLE_INTERVAL
+ *
+ * Every Nth notification sent to an observer is confirmable, the others are non-confirmable.
+ *
+ * Confirmable notifications let the server detect and drop observers that went away (RFC 7641, section 4.5).
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_COAP_OBSERVE_CONFIRMABLE_INTERVAL
+#define OPENTHREAD_CONFIG_COAP_OBSERVE_CONFIRMABLE_INTERVAL 5
+#endif
+
+/**
+ * @def OPENTHREAD_CONFIG_COAP_BLOCKWISE_MAX_BLOCK_SIZE
+ *
+ * Largest block size used by a CoAP server for block-wise transfers (RFC 7959), given as the SZX exponent: blocks are
+ * 2^(SZX + 4) bytes long.
+ *
+ * Smaller blocks need fewer 6LoWPAN fragments each, so a lost frame costs less to retransmit. The default of 2 means
+ * 64-byte blocks.
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_COAP_BLOCKWISE_MAX_BLOCK_SIZE
+#define OPENTHREAD_CONFIG_COAP_BLOCKWISE_MAX_BLOCK_SIZE 2
+#endif
+
 /**
  * @def OPENTHREAD_CONFIG_DNS_RESPONSE_TIMEOUT
  *
@@ -449,6 +449,9 @@ otError Mle::Store(void)
 
     memset(&networkInfo, 0, sizeof(networkInfo));
 
+    // parent and network information are written to the platform store as one change
+    SuccessOrExit(error = settings.BeginChange());
+
     if (IsAttached())
     {
         // only update network information while we are attached to avoid losing information when a reboot occurs after
@@ -482,6 +485,7 @@ otError Mle::Store(void)
     networkInfo.mMacFrameCounter = keyManager.GetMacFrameCounter() + OPENTHREAD_CONFIG_STORE_FRAME_COUNTER_AHEAD;
 
     SuccessOrExit(error = settings.SaveNetworkInfo(networkInfo));
+    SuccessOrExit(error = settings.CommitChange());
 
     keyManager.SetStoredMleFrameCounter(networkInfo.mMleFrameCounter);
     keyManager.SetStoredMacFrameCounter(networkInfo.mMacFrameCounter);
@@ -489,6 +493,12 @@ otError Mle::Store(void)
     otLogDebgMle("Store Network Information");
 
 exit:
+
+    if (error != OT_ERROR_NONE)
+    {
+        settings.AbandonChange();
+    }
+
     return error;
 }
 
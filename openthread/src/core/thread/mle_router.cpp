@@ -3604,16 +3604,26 @@ otError MleRouter::StoreChild(const Child &aChild)
 
 otError MleRouter::RefreshStoredChildren(void)
 {
-    otError error = OT_ERROR_NONE;
+    Settings &settings = GetInstance().GetSettings();
+    otError   error    = OT_ERROR_NONE;
 
-    SuccessOrExit(error = GetInstance().GetSettings().DeleteChildInfo());
+    SuccessOrExit(error = settings.BeginChange());
+    SuccessOrExit(error = settings.DeleteChildInfo());
 
     for (ChildTable::Iterator iter(GetInstance(), ChildTable::kInStateAnyExceptInvalid); !iter.IsDone(); iter++)
     {
         SuccessOrExit(error = StoreChild(*iter.GetChild()));
     }
 
+    error = settings.CommitChange();
+
 exit:
+
+    if (error != OT_ERROR_NONE)
+    {
+        settings.AbandonChange();
+    }
+
     return error;
 }
 
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2018, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file implements the OpenThread platform abstraction for the alarm on top of the monotonic clock.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "openthread/platform/alarm-milli.h"
+#include "platform-posix.h"
+
+static uint64_t sStartTime;
+static uint32_t sAlarmTime;
+static bool     sAlarmPending = false;
+
+static uint64_t alarmGetNowUs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+void posixAlarmInit(void)
+{
+    sStartTime = alarmGetNowUs();
+}
+
+uint32_t otPlatAlarmMilliGetNow(void)
+{
+    return (uint32_t)((alarmGetNowUs() - sStartTime) / 1000);
+}
+
+void otPlatAlarmMilliStartAt(otInstance *aInstance, uint32_t aT0, uint32_t aDt)
+{
+    (void)aInstance;
+
+    sAlarmTime    = aT0 + aDt;
+    sAlarmPending = true;
+}
+
+void otPlatAlarmMilliStop(otInstance *aInstance)
+{
+    (void)aInstance;
+
+    sAlarmPending = false;
+}
+
+void posixAlarmUpdateTimeout(struct timeval *aTimeout)
+{
+    int32_t remaining;
+
+    if (!sAlarmPending)
+    {
+        return;
+    }
+
+    remaining = (int32_t)(sAlarmTime - otPlatAlarmMilliGetNow());
+
+    if (remaining < 0)
+    {
+        remaining = 0;
+    }
+
+    if (remaining / 1000 < aTimeout->tv_sec ||
+        (remaining / 1000 == aTimeout->tv_sec && (remaining % 1000) * 1000 < aTimeout->tv_usec))
+    {
+        aTimeout->tv_sec  = remaining / 1000;
+        aTimeout->tv_usec = (remaining % 1000) * 1000;
+    }
+}
+
+void posixAlarmProcess(otInstance *aInstance)
+{
+    if (sAlarmPending && (int32_t)(sAlarmTime - otPlatAlarmMilliGetNow()) <= 0)
+    {
+        sAlarmPending = false;
+        posixLoopCountEvent();
+        otPlatAlarmMilliFired(aInstance);
+    }
+}
@@ -0,0 +1,233 @@
+/*
+ *  Copyright (c) 2018, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file implements the demo CoAP resources of the firmware on the host, with the LED and the light sensor
+ *   replaced by stubs.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "coap_app.h"
+#include "platform-posix.h"
+
+static coapAppResource_t sTestResource;
+static coapAppResource_t sLedResource;
+static coapAppResource_t sLuxResource;
+
+// stand-ins for the LED GPIO and the ADC channel of the light sensor
+static bool     sLed;
+static uint32_t sLightLevel;
+static uint32_t sLightTrigger  = 500;
+static uint32_t sLightDeadzone = 200;
+
+static bool     sLedNotified;
+static uint32_t sLightLevelNotified;
+
+static void handleTest(const coapAppRequest_t *aRequest, coapAppResponse_t *aResponse)
+{
+    (void)aRequest;
+
+    coapAppWrite(aResponse, "hello\r\n");
+}
+
+static void writeLed(coapAppResponse_t *aResponse)
+{
+    senmlWriter_t writer;
+
+    if (aResponse->format == OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR)
+    {
+        coapAppSenmlBegin(aResponse, &writer, 1);
+        senmlWriteRecord(&writer, 2);
+        senmlWriteText(&writer, senmlLabel_Name, "led");
+        senmlWriteBool(&writer, senmlLabel_BoolValue, sLed);
+        coapAppSenmlEnd(aResponse, &writer);
+    }
+    else
+    {
+        coapAppWrite(aResponse, "led now is ");
+        coapAppWrite(aResponse, sLed ? " on" : "off");
+    }
+}
+
+static void handleLed(const coapAppRequest_t *aRequest, coapAppResponse_t *aResponse)
+{
+    uint32_t value;
+
+    for (uint8_t i = 0; i < aRequest->paramCount; i++)
+    {
+        const coapAppParam_t *param = &aRequest->params[i];
+
+        if (coapAppParamIs(param, "toggle"))
+        {
+            sLed = !sLed;
+        }
+        else if (coapAppParamIs(param, "on"))
+        {
+            sLed = true;
+        }
+        else if (coapAppParamIs(param, "off"))
+        {
+            sLed = false;
+        }
+        else if (coapAppParamIs(param, "led") && coapAppParamGetUint(param, &value))
+        {
+            sLed = (value != 0);
+        }
+    }
+
+    writeLed(aResponse);
+}
+
+static void writeLuxSenml(coapAppResponse_t *aResponse)
+{
+    senmlWriter_t writer;
+
+    coapAppSenmlBegin(aResponse, &writer, 3);
+    senmlWriteRecord(&writer, 2);
+    senmlWriteText(&writer, senmlLabel_Name, "lvl");
+    senmlWriteInt(&writer, senmlLabel_Value, static_cast<int32_t>(sLightTrigger));
+    senmlWriteRecord(&writer, 2);
+    senmlWriteText(&writer, senmlLabel_Name, "dz");
+    senmlWriteInt(&writer, senmlLabel_Value, static_cast<int32_t>(sLightDeadzone));
+    senmlWriteRecord(&writer, 2);
+    senmlWriteText(&writer, senmlLabel_BaseName, "adc");
+    senmlWriteInt(&writer, senmlLabel_Value, static_cast<int32_t>(sLightLevel));
+    coapAppSenmlEnd(aResponse, &writer);
+}
+
+// the representation a plain GET returns and observers are notified with
+static void writeLux(coapAppResponse_t *aResponse)
+{
+    if (aResponse->format == OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR)
+    {
+        writeLuxSenml(aResponse);
+    }
+    else
+    {
+        coapAppWrite(aResponse, "adc: ");
+        coapAppWriteUint(aResponse, sLightLevel);
+    }
+}
+
+static void handleLux(const coapAppRequest_t *aRequest, coapAppResponse_t *aResponse)
+{
+    const char *label = NULL;
+    uint32_t    value = 0;
+    uint32_t    number;
+
+    for (uint8_t i = 0; i < aRequest->paramCount; i++)
+    {
+        const coapAppParam_t *param = &aRequest->params[i];
+
+        if (coapAppParamIs(param, "lvl"))
+        {
+            if (coapAppParamGetUint(param, &number) && number != 0)
+            {
+                sLightTrigger = number;
+            }
+
+            label = "lvl: ";
+            value = sLightTrigger;
+        }
+        else if (coapAppParamIs(param, "dz"))
+        {
+            if (coapAppParamGetUint(param, &number) && number != 0)
+            {
+                sLightDeadzone = number;
+            }
+
+            label = "dz: ";
+            value = sLightDeadzone;
+        }
+        else if (coapAppParamIs(param, "raw"))
+        {
+            label = "adc: ";
+            value = sLightLevel;
+        }
+    }
+
+    if (label == NULL || aResponse->format == OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR)
+    {
+        writeLux(aResponse);
+    }
+    else
+    {
+        coapAppWrite(aResponse, label);
+        coapAppWriteUint(aResponse, value);
+    }
+}
+
+void posixAppInit(otInstance *aInstance)
+{
+    coapAppResourceAdd(aInstance, &sTestResource, "test", &handleTest, false, false);
+    coapAppResourceAdd(aInstance, &sLedResource, "led", &handleLed, true, true);
+    coapAppResourceAdd(aInstance, &sLuxResource, "lux", &handleLux, true, true);
+
+    sLedNotified        = sLed;
+    sLightLevelNotified = sLightLevel;
+}
+
+void posixAppSetLightLevel(uint32_t aLevel)
+{
+    sLightLevel = aLevel;
+}
+
+void posixAppProcess(void)
+{
+    coapAppResponse_t content;
+
+    if (sLightLevel != sLightLevelNotified)
+    {
+        sLightLevelNotified = sLightLevel;
+
+        coapAppResponseInit(&content, OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN);
+        writeLux(&content);
+        coapAppResourceNotify(&sLuxResource, &content);
+
+        coapAppResponseInit(&content, OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR);
+        writeLux(&content);
+        coapAppResourceNotify(&sLuxResource, &content);
+    }
+
+    if (sLed != sLedNotified)
+    {
+        sLedNotified = sLed;
+
+        coapAppResponseInit(&content, OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN);
+        writeLed(&content);
+        coapAppResourceNotify(&sLedResource, &content);
+
+        coapAppResponseInit(&content, OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR);
+        writeLed(&content);
+        coapAppResourceNotify(&sLedResource, &content);
+    }
+}
@@ -0,0 +1,50 @@
+#!/bin/sh
+#
+# Runs two simulated nodes that form a network and exchange CoAP requests, then
+# asks each one for its main loop counters. Fails when a node made more loop
+# passes than its radio, alarm and UART events account for, which is what a
+# main loop that polls instead of blocking looks like.
+#
+#   ./check-loop.sh [<ot-posix binary>]
+#
+
+BIN=$(cd "$(dirname "${1:-build/ot-posix}")" && pwd)/$(basename "${1:-build/ot-posix}")
+WORK=$(mktemp -d)
+RUN_SECONDS=15
+
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+run_node()
+{
+    {
+        printf 'panid 0x1234\nifconfig up\nthread start\ncoap start\n'
+        sleep 8
+        for i in 1 2 3; do
+            printf 'adc %u\ncoap get fdde:ad00:beef:0:0:ff:fe00:fc00 lux\n' "$i"
+            sleep 1
+        done
+        sleep $((RUN_SECONDS - 11))
+        printf 'loop\n'
+        sleep 1
+    } | timeout $((RUN_SECONDS + 5)) "$BIN" "$1" 2 > "node$1.log" 2>&1
+}
+
+run_node 1 &
+run_node 2 &
+wait
+
+status=0
+
+for node in 1 2; do
+    result=$(tr -d '\r' < "node$node.log" | grep -A2 '^passes:' | tr '\n' ' ')
+
+    echo "node $node: ${result:-no loop counters}"
+
+    case "$result" in
+    *Done*) ;;
+    *) status=1 ;;
+    esac
+done
+
+exit $status
@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2018, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file implements the flash interface used by settings.cpp on top of a per-node file.
+ *
+ */
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <openthread-core-config.h>
+#include <utils/code_utils.h>
+#include <utils/flash.h>
+
+#include "platform-posix.h"
+
+/**
+ * @def POSIX_FLASH_PATH
+ *
+ * The directory holding the flash files of the simulated nodes.
+ *
+ */
+#ifndef POSIX_FLASH_PATH
+#define POSIX_FLASH_PATH "tmp"
+#endif
+
+enum
+{
+    kFlashPageSize = SETTINGS_CONFIG_PAGE_SIZE,
+    kFlashSize     = SETTINGS_CONFIG_PAGE_SIZE * SETTINGS_CONFIG_PAGE_NUM,
+};
+
+static int sFlashFd = -1;
+
+otError utilsFlashInit(void)
+{
+    otError error = OT_ERROR_NONE;
+    char    fileName[sizeof(POSIX_FLASH_PATH) + 32];
+    bool    create;
+
+    otEXPECT(sFlashFd == -1);
+
+    mkdir(POSIX_FLASH_PATH, 0777);
+    snprintf(fileName, sizeof(fileName), POSIX_FLASH_PATH "/%u.flash", gNodeId);
+
+    create   = (access(fileName, F_OK) != 0);
+    sFlashFd = open(fileName, O_RDWR | O_CREAT, 0666);
+    otEXPECT_ACTION(sFlashFd >= 0, error = OT_ERROR_FAILED);
+
+    if (create)
+    {
+        for (uint32_t address = 0; address < kFlashSize; address += kFlashPageSize)
+        {
+            utilsFlashErasePage(address);
+        }
+    }
+
+exit:
+    return error;
+}
+
+uint32_t utilsFlashGetSize(void)
+{
+    return kFlashSize;
+}
+
+otError utilsFlashErasePage(uint32_t aAddress)
+{
+    otError  error = OT_ERROR_NONE;
+    uint8_t  page[kFlashPageSize];
+    uint32_t address;
+
+    otEXPECT_ACTION(sFlashFd >= 0 && aAddress < kFlashSize, error = OT_ERROR_INVALID_ARGS);
+
+    address = aAddress - (aAddress % kFlashPageSize);
+    memset(page, 0xff, sizeof(page));
+    otEXPECT_ACTION(pwrite(sFlashFd, page, sizeof(page), address) == sizeof(page), error = OT_ERROR_FAILED);
+
+exit:
+    return error;
+}
+
+otError utilsFlashStatusWait(uint32_t aTimeout)
+{
+    (void)aTimeout;
+    return OT_ERROR_NONE;
+}
+
+uint32_t utilsFlashWrite(uint32_t aAddress, uint8_t *aData, uint32_t aSize)
+{
+    uint32_t size = 0;
+    uint8_t  buffer[kFlashPageSize];
+
+    otEXPECT(sFlashFd >= 0 && aAddress + aSize <= kFlashSize && aSize <= sizeof(buffer));
+    otEXPECT(pread(sFlashFd, buffer, aSize, aAddress) == (ssize_t)aSize);
+
+    // like NOR flash, a write can only clear bits
+    for (uint32_t i = 0; i < aSize; i++)
+    {
+        buffer[i] &= aData[i];
+    }
+
+    otEXPECT(pwrite(sFlashFd, buffer, aSize, aAddress) == (ssize_t)aSize);
+    size = aSize;
+
+exit:
+    return size;
+}
+
+uint32_t utilsFlashRead(uint32_t aAddress, uint8_t *aData, uint32_t aSize)
+{
+    ssize_t rval = -1;
+
+    otEXPECT(sFlashFd >= 0 && aAddress + aSize <= kFlashSize);
+    rval = pread(sFlashFd, aData, aSize, aAddress);
+
+exit:
+    return rval < 0 ? 0 : (uint32_t)rval;
+}
@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2018, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file implements the host simulation node: the OpenThread CLI plus an MQTT-SN client.
+ *
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <openthread-core-config.h>
+#include <openthread/cli.h>
+#include <openthread/instance.h>
+#include <openthread/ip6.h>
+#include <openthread/tasklet.h>
+#include <openthread/thread.h>
+
+#include <app_timer.h>
+#include <mqttsn_client.h>
+#include <nrf_error.h>
+
+#include "platform-posix.h"
+#include "platform.h"
+
+#define MAIN_TASK_WAIT_MS 1000U
+
+static void cli_mqtt(int argc, char *argv[]);
+static void cli_adc(int argc, char *argv[]);
+static void cli_loop(int argc, char *argv[]);
+
+static otInstance      *sInstance;
+static mqttsn_client_t  sMqttClient;
+static mqttsn_remote_t  sMqttGateway;
+static uint8_t          sMqttGatewayId;
+static const otCliCommand cli_commands[] = {{"mqtt", &cli_mqtt}, {"adc", &cli_adc}, {"loop", &cli_loop}};
+
+static void mqtt_evt_handler(mqttsn_client_t *p_client, mqttsn_event_t *p_event)
+{
+    (void)p_client;
+
+    switch (p_event->event_id)
+    {
+    case MQTTSN_EVENT_GATEWAY_FOUND:
+        sMqttGateway   = *p_event->event_data.connected.p_gateway_addr;
+        sMqttGatewayId = p_event->event_data.connected.gateway_id;
+        otCliOutputFormat("mqtt: gateway %u found\r\n", sMqttGatewayId);
+        break;
+
+    case MQTTSN_EVENT_REGISTERED:
+        otCliOutputFormat("mqtt: registered topic id %u\r\n", p_event->event_data.registered.packet.topic.topic_id);
+        break;
+
+    case MQTTSN_EVENT_RECEIVED:
+        otCliOutputFormat("mqtt: received %u bytes on topic id %u\r\n", p_event->event_data.published.packet.len,
+                          p_event->event_data.published.packet.topic.topic_id);
+        break;
+
+    default:
+        otCliOutputFormat("mqtt: event %u\r\n", p_event->event_id);
+        break;
+    }
+}
+
+static void cli_mqtt(int argc, char *argv[])
+{
+    uint32_t err_code = NRF_ERROR_INVALID_PARAM;
+    uint16_t msg_id;
+
+    if (argc < 1)
+    {
+    }
+    else if (strcmp(argv[0], "search") == 0)
+    {
+        err_code = mqttsn_client_search_gateway(&sMqttClient, argc > 1 ? (uint32_t)atoi(argv[1]) : 15);
+    }
+    else if (strcmp(argv[0], "connect") == 0 && argc > 1)
+    {
+        mqttsn_connect_opt_t options;
+
+        memset(&options, 0, sizeof(options));
+        options.alive_duration = MQTTSN_DEFAULT_ALIVE_DURATION;
+        options.clean_session  = MQTTSN_DEFAULT_CLEAN_SESSION_FLAG;
+        options.client_id_len  = (uint16_t)strlen(argv[1]);
+
+        if (options.client_id_len <= MQTTSN_CLIENT_ID_MAX_LENGTH)
+        {
+            memcpy(options.p_client_id, argv[1], options.client_id_len);
+            err_code = mqttsn_client_connect(&sMqttClient, &sMqttGateway, sMqttGatewayId, &options);
+        }
+    }
+    else if (strcmp(argv[0], "register") == 0 && argc > 1)
+    {
+        err_code = mqttsn_client_topic_register(&sMqttClient, (const uint8_t *)argv[1], (uint16_t)strlen(argv[1]),
+                                                &msg_id);
+    }
+    else if (strcmp(argv[0], "publish") == 0 && argc > 2)
+    {
+        err_code = mqttsn_client_publish(&sMqttClient, (uint16_t)atoi(argv[1]), (const uint8_t *)argv[2],
+                                         (uint16_t)strlen(argv[2]), &msg_id);
+    }
+    else if (strcmp(argv[0], "disconnect") == 0)
+    {
+        err_code = mqttsn_client_disconnect(&sMqttClient);
+    }
+
+    if (err_code == NRF_SUCCESS)
+    {
+        otCliOutputFormat("Done\r\n");
+    }
+    else
+    {
+        otCliOutputFormat("Error %lu\r\n", (unsigned long)err_code);
+    }
+}
+
+static void cli_adc(int argc, char *argv[])
+{
+    if (argc > 0)
+    {
+        posixAppSetLightLevel((uint32_t)atoi(argv[0]));
+    }
+
+    otCliOutputFormat("Done\r\n");
+}
+
+static void cli_loop(int argc, char *argv[])
+{
+    uint32_t passes;
+    uint32_t events;
+    bool     bounded;
+
+    (void)argc;
+    (void)argv;
+
+    bounded = posixLoopCheck(&passes, &events);
+    otCliOutputFormat("passes: %lu\r\nevents: %lu\r\n", (unsigned long)passes, (unsigned long)events);
+    otCliOutputFormat(bounded ? "Done\r\n" : "Error: main loop spins\r\n");
+}
+
+int main(int argc, char *argv[])
+{
+pseudo_reset:
+
+    PlatformInit(argc, argv);
+    sInstance = otInstanceInitSingle();
+    assert(sInstance);
+    otCliUartInit(sInstance);
+    otCliSetUserCommands(cli_commands, sizeof(cli_commands) / sizeof(cli_commands[0]));
+    otIp6SetEnabled(sInstance, true);
+
+    posixAppInit(sInstance);
+    mqttsn_client_init(&sMqttClient, MQTTSN_DEFAULT_CLIENT_PORT, mqtt_evt_handler, sInstance);
+
+    while (!PlatformPseudoResetWasRequested())
+    {
+        otTaskletsProcess(sInstance);
+        PlatformProcessDrivers(sInstance);
+        app_timer_process();
+        posixAppProcess();
+        PlatformEventWait(app_timer_next_timeout_get(MAIN_TASK_WAIT_MS));
+    }
+
+    mqttsn_client_uninit(&sMqttClient);
+    otInstanceFinalize(sInstance);
+    PlatformDeinit();
+
+    goto pseudo_reset;
+}
@@ -0,0 +1,220 @@
+/*
+ *  Copyright (c) 2018, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file includes the platform-specific initializers of the host simulation platform.
+ *
+ */
+
+#ifndef PLATFORM_POSIX_H_
+#define PLATFORM_POSIX_H_
+
+#include <openthread/config.h>
+#include <openthread-core-config.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/select.h>
+#include <sys/time.h>
+
+#include "openthread/error.h"
+#include "openthread/instance.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The UDP port the first simulated node listens on. Node N listens on POSIX_AIR_PORT_BASE + N.
+ *
+ */
+#ifndef POSIX_AIR_PORT_BASE
+#define POSIX_AIR_PORT_BASE 9000
+#endif
+
+/**
+ * The default number of simulated nodes sharing the air, override with the second command line argument.
+ *
+ */
+#ifndef POSIX_AIR_NODE_NUM
+#define POSIX_AIR_NODE_NUM 34
+#endif
+
+/**
+ * The number of main loop passes allowed per event, see posixLoopCheck().
+ *
+ */
+#ifndef POSIX_LOOP_PASSES_PER_EVENT
+#define POSIX_LOOP_PASSES_PER_EVENT 2
+#endif
+
+/**
+ * The number of main loop passes allowed on top of POSIX_LOOP_PASSES_PER_EVENT per event, see posixLoopCheck().
+ *
+ */
+#ifndef POSIX_LOOP_PASS_SLACK
+#define POSIX_LOOP_PASS_SLACK 8
+#endif
+
+/**
+ * The node id of this process, taken from the first command line argument.
+ *
+ */
+extern uint32_t gNodeId;
+
+/**
+ * The number of nodes sharing the simulated air.
+ *
+ */
+extern uint32_t gNodeNum;
+
+/**
+ * This function initializes the alarm service used by OpenThread.
+ *
+ */
+void posixAlarmInit(void);
+
+/**
+ * This function returns the time until the next alarm fires.
+ *
+ * @param[out]  aTimeout  A pointer to the time until the next alarm, left untouched when no alarm is pending.
+ *
+ */
+void posixAlarmUpdateTimeout(struct timeval *aTimeout);
+
+/**
+ * This function performs alarm driver processing.
+ *
+ * @param[in]  aInstance  The OpenThread instance structure.
+ *
+ */
+void posixAlarmProcess(otInstance *aInstance);
+
+/**
+ * This function initializes the radio service used by OpenThread.
+ *
+ */
+void posixRadioInit(void);
+
+/**
+ * This function shuts down the radio service used by OpenThread.
+ *
+ */
+void posixRadioDeinit(void);
+
+/**
+ * This function adds the radio file descriptors to the select() sets.
+ *
+ * @param[inout]  aReadFdSet  A pointer to the read file descriptors.
+ * @param[inout]  aMaxFd      A pointer to the maximum file descriptor.
+ * @param[inout]  aTimeout    A pointer to the select() timeout, shortened while an ACK is awaited.
+ *
+ */
+void posixRadioUpdateFdSet(fd_set *aReadFdSet, int *aMaxFd, struct timeval *aTimeout);
+
+/**
+ * This function performs radio driver processing.
+ *
+ * @param[in]  aInstance   The OpenThread instance structure.
+ * @param[in]  aReadFdSet  A pointer to the readable file descriptors.
+ *
+ */
+void posixRadioProcess(otInstance *aInstance, const fd_set *aReadFdSet);
+
+/**
+ * This function initializes the random number service used by OpenThread.
+ *
+ */
+void posixRandomInit(void);
+
+/**
+ * This function adds the UART file descriptors to the select() sets.
+ *
+ * @param[inout]  aReadFdSet  A pointer to the read file descriptors.
+ * @param[inout]  aMaxFd      A pointer to the maximum file descriptor.
+ * @param[inout]  aTimeout    A pointer to the select() timeout, cleared while a send completion is pending.
+ *
+ */
+void posixUartUpdateFdSet(fd_set *aReadFdSet, int *aMaxFd, struct timeval *aTimeout);
+
+/**
+ * This function performs UART driver processing.
+ *
+ * @param[in]  aReadFdSet  A pointer to the readable file descriptors.
+ *
+ */
+void posixUartProcess(const fd_set *aReadFdSet);
+
+/**
+ * This function counts one radio, alarm or UART event handled by the main loop.
+ *
+ */
+void posixLoopCountEvent(void);
+
+/**
+ * This function checks that the main loop only runs when there is work for it.
+ *
+ * Every pass of the main loop ends in PlatformEventWait(). A pass is expected per radio, alarm or UART event, plus
+ * the passes running the tasklets those events post; a loop that spins makes passes without events.
+ *
+ * @param[out]  aPasses  The number of passes made so far.
+ * @param[out]  aEvents  The number of events handled so far.
+ *
+ * @retval TRUE   The passes stay within POSIX_LOOP_PASSES_PER_EVENT per event plus POSIX_LOOP_PASS_SLACK.
+ * @retval FALSE  The main loop made more passes than its events account for.
+ *
+ */
+bool posixLoopCheck(uint32_t *aPasses, uint32_t *aEvents);
+
+/**
+ * This function registers the demo CoAP resources of the firmware, with the LED and the light sensor simulated.
+ *
+ * @param[in]  aInstance  The OpenThread instance structure.
+ *
+ */
+void posixAppInit(otInstance *aInstance);
+
+/**
+ * This function sets the simulated light sensor reading reported by /lux.
+ *
+ * @param[in]  aLevel  The ADC reading.
+ *
+ */
+void posixAppSetLightLevel(uint32_t aLevel);
+
+/**
+ * This function notifies the /led and /lux observers of changed values.
+ *
+ */
+void posixAppProcess(void);
+
+#ifdef __cplusplus
+} // end of extern "C"
+#endif
+
+#endif // PLATFORM_POSIX_H_
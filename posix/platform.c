@@ -0,0 +1,190 @@
+/*
+ *  Copyright (c) 2018, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file includes the platform-specific initializers of the host simulation platform.
+ *
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <syslog.h>
+
+#include "openthread/error.h"
+#include "openthread/platform/alarm-milli.h"
+#include "openthread/platform/uart.h"
+#include "openthread/tasklet.h"
+
+#include "platform-posix.h"
+#include "platform.h"
+
+uint32_t gNodeId  = 1;
+uint32_t gNodeNum = POSIX_AIR_NODE_NUM;
+
+static bool     sEventPending;
+static uint32_t sLoopPasses;
+static uint32_t sLoopEvents;
+
+static int platformSelect(fd_set *aReadFdSet, struct timeval *aTimeout)
+{
+    int maxFd = -1;
+    int rval;
+
+    FD_ZERO(aReadFdSet);
+
+    posixUartUpdateFdSet(aReadFdSet, &maxFd, aTimeout);
+    posixRadioUpdateFdSet(aReadFdSet, &maxFd, aTimeout);
+    posixAlarmUpdateTimeout(aTimeout);
+
+    rval = select(maxFd + 1, aReadFdSet, NULL, NULL, aTimeout);
+
+    if (rval < 0)
+    {
+        if (errno != EINTR)
+        {
+            perror("select");
+            exit(EXIT_FAILURE);
+        }
+
+        FD_ZERO(aReadFdSet);
+    }
+
+    return rval;
+}
+
+void PlatformInit(int argc, char *argv[])
+{
+    char *endptr;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <node id> [<node number>]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    gNodeId = (uint32_t)strtoul(argv[1], &endptr, 0);
+
+    if (*endptr != '\0' || gNodeId == 0)
+    {
+        fprintf(stderr, "Invalid node id: %s\n", argv[1]);
+        exit(EXIT_FAILURE);
+    }
+
+    if (argc > 2)
+    {
+        gNodeNum = (uint32_t)strtoul(argv[2], &endptr, 0);
+
+        if (*endptr != '\0' || gNodeNum < gNodeId)
+        {
+            fprintf(stderr, "Invalid node number: %s\n", argv[2]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    openlog(argv[0], LOG_PID, LOG_USER);
+
+    posixAlarmInit();
+    posixRandomInit();
+    posixRadioInit();
+
+    otPlatUartEnable();
+}
+
+void PlatformDeinit(void)
+{
+    posixRadioDeinit();
+    closelog();
+}
+
+void PlatformProcessDrivers(otInstance *aInstance)
+{
+    fd_set         readFdSet;
+    struct timeval timeout = {0, 0};
+
+    platformSelect(&readFdSet, &timeout);
+
+    posixUartProcess(&readFdSet);
+    posixRadioProcess(aInstance, &readFdSet);
+    posixAlarmProcess(aInstance);
+}
+
+void PlatformEventSignalPending(void)
+{
+    sEventPending = true;
+}
+
+void PlatformEventWait(uint32_t aTimeout)
+{
+    fd_set         readFdSet;
+    struct timeval timeout;
+    uint32_t       start = otPlatAlarmMilliGetNow();
+
+    sLoopPasses++;
+
+    timeout.tv_sec  = aTimeout / 1000;
+    timeout.tv_usec = (aTimeout % 1000) * 1000;
+
+    if (sEventPending)
+    {
+        timeout.tv_sec  = 0;
+        timeout.tv_usec = 0;
+    }
+
+    sEventPending = false;
+
+    // ready descriptors are picked up again by PlatformProcessDrivers()
+    if (platformSelect(&readFdSet, &timeout) == 0 && aTimeout > 0 &&
+        (int32_t)(otPlatAlarmMilliGetNow() - start) >= (int32_t)aTimeout)
+    {
+        // the caller's own timeout ran out, which is a timer event of the main loop
+        sLoopEvents++;
+    }
+}
+
+void posixLoopCountEvent(void)
+{
+    sLoopEvents++;
+}
+
+bool posixLoopCheck(uint32_t *aPasses, uint32_t *aEvents)
+{
+    *aPasses = sLoopPasses;
+    *aEvents = sLoopEvents;
+
+    return sLoopPasses <= sLoopEvents * POSIX_LOOP_PASSES_PER_EVENT + POSIX_LOOP_PASS_SLACK;
+}
+
+void otTaskletsSignalPending(otInstance *aInstance)
+{
+    (void)aInstance;
+    PlatformEventSignalPending();
+}
@@ -0,0 +1,647 @@
+/*
+ *  Copyright (c) 2018, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file implements the OpenThread platform abstraction for the radio on top of a simulated UDP air.
+ *
+ *   Every node binds 127.0.0.1:POSIX_AIR_PORT_BASE + node id and a transmitted frame is sent to all other nodes.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openthread/platform/alarm-milli.h>
+#include <openthread/platform/radio.h>
+#include <utils/code_utils.h>
+
+#include "platform-posix.h"
+
+#define POSIX_RADIO_RSSI -20           /* Received signal strength reported for every frame [dBm]. */
+#define POSIX_RADIO_SENSITIVITY -100   /* Receive sensitivity [dBm]. */
+#define POSIX_RADIO_ACK_TIMEOUT_MS 16  /* Time to wait for an ACK, same as the OpenThread software ACK timeout. */
+#define POSIX_RADIO_SRC_MATCH_ENTRY_NUM 32
+
+enum
+{
+    kFcsSize = 2,
+    kAckPsduLength = 5,
+
+    kFcfFrameTypeMask    = 7 << 0,
+    kFcfFrameAck         = 2 << 0,
+    kFcfSecurityEnabled  = 1 << 3,
+    kFcfFramePending     = 1 << 4,
+    kFcfAckRequest       = 1 << 5,
+    kFcfPanidCompression = 1 << 6,
+    kFcfDstAddrMask      = 3 << 10,
+    kFcfDstAddrShort     = 2 << 10,
+    kFcfDstAddrExt       = 3 << 10,
+    kFcfSrcAddrMask      = 3 << 14,
+    kFcfSrcAddrShort     = 2 << 14,
+    kFcfSrcAddrExt       = 3 << 14,
+
+    kShortAddrBroadcast = 0xffff,
+    kPanIdBroadcast     = 0xffff,
+};
+
+OT_TOOL_PACKED_BEGIN
+struct posixRadioMessage
+{
+    uint8_t mChannel;
+    uint8_t mPsdu[OT_RADIO_FRAME_MAX_SIZE];
+} OT_TOOL_PACKED_END;
+
+static int          sSockFd = -1;
+static otRadioState sState  = OT_RADIO_STATE_DISABLED;
+static uint8_t      sChannel;
+static bool         sPromiscuous;
+
+static uint16_t     sPanId;
+static uint16_t     sShortAddress;
+static otExtAddress sExtAddress; /* OpenThread passes it in over-the-air (little-endian) byte order. */
+
+static struct posixRadioMessage sReceiveMessage;
+static struct posixRadioMessage sTransmitMessage;
+static struct posixRadioMessage sAckMessage;
+static otRadioFrame             sReceiveFrame;
+static otRadioFrame             sTransmitFrame;
+static bool                     sTxPending;
+static bool                     sAckWait;
+static uint32_t                 sAckDeadline;
+
+static bool         sSrcMatchEnabled;
+static uint16_t     sSrcMatchShort[POSIX_RADIO_SRC_MATCH_ENTRY_NUM];
+static uint8_t      sSrcMatchShortNum;
+static otExtAddress sSrcMatchExt[POSIX_RADIO_SRC_MATCH_ENTRY_NUM];
+static uint8_t      sSrcMatchExtNum;
+
+static uint16_t getFcf(const otRadioFrame *aFrame)
+{
+    return (uint16_t)(aFrame->mPsdu[0] | (aFrame->mPsdu[1] << 8));
+}
+
+static uint8_t getSequence(const otRadioFrame *aFrame)
+{
+    return aFrame->mPsdu[2];
+}
+
+static uint16_t getUint16(const uint8_t *aBuf)
+{
+    return (uint16_t)(aBuf[0] | (aBuf[1] << 8));
+}
+
+static uint8_t getAddrSize(uint16_t aMode)
+{
+    uint8_t size = 0;
+
+    if (aMode == kFcfDstAddrShort || aMode == kFcfSrcAddrShort)
+    {
+        size = sizeof(uint16_t);
+    }
+    else if (aMode == kFcfDstAddrExt || aMode == kFcfSrcAddrExt)
+    {
+        size = sizeof(otExtAddress);
+    }
+
+    return size;
+}
+
+static bool isFrameForUs(const otRadioFrame *aFrame)
+{
+    uint16_t       fcf     = getFcf(aFrame);
+    uint16_t       dstMode = fcf & kFcfDstAddrMask;
+    const uint8_t *cur     = &aFrame->mPsdu[3];
+    bool           rval    = false;
+
+    otEXPECT(dstMode != 0);
+    otEXPECT(getUint16(cur) == sPanId || getUint16(cur) == kPanIdBroadcast);
+    cur += sizeof(uint16_t);
+
+    if (dstMode == kFcfDstAddrShort)
+    {
+        rval = (getUint16(cur) == sShortAddress || getUint16(cur) == kShortAddrBroadcast);
+    }
+    else
+    {
+        rval = (memcmp(cur, sExtAddress.m8, sizeof(sExtAddress)) == 0);
+    }
+
+exit:
+    return rval;
+}
+
+static bool hasFramePending(const otRadioFrame *aFrame)
+{
+    uint16_t       fcf     = getFcf(aFrame);
+    uint16_t       srcMode = fcf & kFcfSrcAddrMask;
+    const uint8_t *cur     = &aFrame->mPsdu[3];
+    bool           rval    = true;
+
+    otEXPECT(sSrcMatchEnabled);
+    rval = false;
+
+    if ((fcf & kFcfDstAddrMask) != 0)
+    {
+        cur += sizeof(uint16_t) + getAddrSize(fcf & kFcfDstAddrMask);
+    }
+
+    if (!(fcf & kFcfPanidCompression))
+    {
+        cur += sizeof(uint16_t);
+    }
+
+    if (srcMode == kFcfSrcAddrShort)
+    {
+        for (uint8_t i = 0; i < sSrcMatchShortNum && !rval; i++)
+        {
+            rval = (sSrcMatchShort[i] == getUint16(cur));
+        }
+    }
+    else if (srcMode == kFcfSrcAddrExt)
+    {
+        for (uint8_t i = 0; i < sSrcMatchExtNum && !rval; i++)
+        {
+            rval = (memcmp(sSrcMatchExt[i].m8, cur, sizeof(otExtAddress)) == 0);
+        }
+    }
+
+exit:
+    return rval;
+}
+
+static void radioSendMessage(const struct posixRadioMessage *aMessage, uint8_t aPsduLength)
+{
+    struct sockaddr_in sockaddr;
+
+    memset(&sockaddr, 0, sizeof(sockaddr));
+    sockaddr.sin_family      = AF_INET;
+    sockaddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    for (uint32_t node = 1; node <= gNodeNum; node++)
+    {
+        if (node == gNodeId)
+        {
+            continue;
+        }
+
+        sockaddr.sin_port = htons((uint16_t)(POSIX_AIR_PORT_BASE + node));
+        sendto(sSockFd, aMessage, 1 + aPsduLength, 0, (struct sockaddr *)&sockaddr, sizeof(sockaddr));
+    }
+}
+
+static void radioSendAck(const otRadioFrame *aFrame)
+{
+    sAckMessage.mChannel  = aFrame->mChannel;
+    sAckMessage.mPsdu[0]  = kFcfFrameAck;
+    sAckMessage.mPsdu[1]  = 0;
+    sAckMessage.mPsdu[2]  = getSequence(aFrame);
+
+    if (hasFramePending(aFrame))
+    {
+        sAckMessage.mPsdu[0] |= kFcfFramePending;
+    }
+
+    radioSendMessage(&sAckMessage, kAckPsduLength);
+}
+
+static void radioTransmit(otInstance *aInstance)
+{
+    sTxPending = false;
+
+    sTransmitMessage.mChannel = sTransmitFrame.mChannel;
+    radioSendMessage(&sTransmitMessage, sTransmitFrame.mLength);
+    otPlatRadioTxStarted(aInstance, &sTransmitFrame);
+
+    if (getFcf(&sTransmitFrame) & kFcfAckRequest)
+    {
+        sAckWait     = true;
+        sAckDeadline = otPlatAlarmMilliGetNow() + POSIX_RADIO_ACK_TIMEOUT_MS;
+    }
+    else
+    {
+        sState = OT_RADIO_STATE_RECEIVE;
+        otPlatRadioTxDone(aInstance, &sTransmitFrame, NULL, OT_ERROR_NONE);
+    }
+}
+
+static void radioReceive(otInstance *aInstance)
+{
+    ssize_t length = recvfrom(sSockFd, &sReceiveMessage, sizeof(sReceiveMessage), 0, NULL, NULL);
+
+    otEXPECT(length > 1 + kFcsSize);
+    otEXPECT(sReceiveMessage.mChannel == sChannel);
+    otEXPECT(sState == OT_RADIO_STATE_RECEIVE || sState == OT_RADIO_STATE_TRANSMIT);
+
+    sReceiveFrame.mLength             = (uint8_t)(length - 1);
+    sReceiveFrame.mChannel            = sReceiveMessage.mChannel;
+    sReceiveFrame.mInfo.mRxInfo.mRssi = POSIX_RADIO_RSSI;
+    sReceiveFrame.mInfo.mRxInfo.mLqi  = OT_RADIO_LQI_NONE;
+
+    if ((getFcf(&sReceiveFrame) & kFcfFrameTypeMask) == kFcfFrameAck)
+    {
+        otEXPECT(sAckWait && getSequence(&sReceiveFrame) == getSequence(&sTransmitFrame));
+
+        sAckWait = false;
+        sState   = OT_RADIO_STATE_RECEIVE;
+        otPlatRadioTxDone(aInstance, &sTransmitFrame, &sReceiveFrame, OT_ERROR_NONE);
+    }
+    else if (sState == OT_RADIO_STATE_RECEIVE)
+    {
+        bool forUs = isFrameForUs(&sReceiveFrame);
+
+        otEXPECT(forUs || sPromiscuous);
+
+        if (forUs && (getFcf(&sReceiveFrame) & kFcfAckRequest))
+        {
+            radioSendAck(&sReceiveFrame);
+        }
+
+        otPlatRadioReceiveDone(aInstance, &sReceiveFrame, OT_ERROR_NONE);
+    }
+
+exit:
+    return;
+}
+
+void posixRadioInit(void)
+{
+    struct sockaddr_in sockaddr;
+
+    sSockFd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    if (sSockFd == -1)
+    {
+        perror("socket");
+        exit(EXIT_FAILURE);
+    }
+
+    memset(&sockaddr, 0, sizeof(sockaddr));
+    sockaddr.sin_family      = AF_INET;
+    sockaddr.sin_port        = htons((uint16_t)(POSIX_AIR_PORT_BASE + gNodeId));
+    sockaddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(sSockFd, (struct sockaddr *)&sockaddr, sizeof(sockaddr)) == -1)
+    {
+        perror("bind");
+        exit(EXIT_FAILURE);
+    }
+
+    sReceiveFrame.mPsdu  = sReceiveMessage.mPsdu;
+    sTransmitFrame.mPsdu = sTransmitMessage.mPsdu;
+}
+
+void posixRadioDeinit(void)
+{
+    if (sSockFd != -1)
+    {
+        close(sSockFd);
+        sSockFd = -1;
+    }
+}
+
+void posixRadioUpdateFdSet(fd_set *aReadFdSet, int *aMaxFd, struct timeval *aTimeout)
+{
+    FD_SET(sSockFd, aReadFdSet);
+
+    if (*aMaxFd < sSockFd)
+    {
+        *aMaxFd = sSockFd;
+    }
+
+    if (sTxPending)
+    {
+        aTimeout->tv_sec  = 0;
+        aTimeout->tv_usec = 0;
+    }
+    else if (sAckWait)
+    {
+        int32_t remaining = (int32_t)(sAckDeadline - otPlatAlarmMilliGetNow());
+
+        if (remaining < 0)
+        {
+            remaining = 0;
+        }
+
+        if (aTimeout->tv_sec > 0 || aTimeout->tv_usec > remaining * 1000)
+        {
+            aTimeout->tv_sec  = 0;
+            aTimeout->tv_usec = remaining * 1000;
+        }
+    }
+}
+
+void posixRadioProcess(otInstance *aInstance, const fd_set *aReadFdSet)
+{
+    if (FD_ISSET(sSockFd, aReadFdSet))
+    {
+        posixLoopCountEvent();
+        radioReceive(aInstance);
+    }
+
+    if (sTxPending)
+    {
+        posixLoopCountEvent();
+        radioTransmit(aInstance);
+    }
+
+    if (sAckWait && (int32_t)(sAckDeadline - otPlatAlarmMilliGetNow()) <= 0)
+    {
+        posixLoopCountEvent();
+        sAckWait = false;
+        sState   = OT_RADIO_STATE_RECEIVE;
+        otPlatRadioTxDone(aInstance, &sTransmitFrame, NULL, OT_ERROR_NO_ACK);
+    }
+}
+
+otRadioState otPlatRadioGetState(otInstance *aInstance)
+{
+    (void)aInstance;
+    return sState;
+}
+
+void otPlatRadioGetIeeeEui64(otInstance *aInstance, uint8_t *aIeeeEui64)
+{
+    (void)aInstance;
+
+    memset(aIeeeEui64, 0, OT_EXT_ADDRESS_SIZE);
+    aIeeeEui64[0] = 0x18;
+    aIeeeEui64[1] = 0xb4;
+    aIeeeEui64[2] = 0x30;
+    aIeeeEui64[4] = (uint8_t)(gNodeId >> 24);
+    aIeeeEui64[5] = (uint8_t)(gNodeId >> 16);
+    aIeeeEui64[6] = (uint8_t)(gNodeId >> 8);
+    aIeeeEui64[7] = (uint8_t)gNodeId;
+}
+
+void otPlatRadioSetPanId(otInstance *aInstance, uint16_t aPanId)
+{
+    (void)aInstance;
+    sPanId = aPanId;
+}
+
+void otPlatRadioSetExtendedAddress(otInstance *aInstance, const otExtAddress *aExtAddress)
+{
+    (void)aInstance;
+    sExtAddress = *aExtAddress;
+}
+
+void otPlatRadioSetShortAddress(otInstance *aInstance, uint16_t aShortAddress)
+{
+    (void)aInstance;
+    sShortAddress = aShortAddress;
+}
+
+otError otPlatRadioEnable(otInstance *aInstance)
+{
+    (void)aInstance;
+
+    if (sState == OT_RADIO_STATE_DISABLED)
+    {
+        sState = OT_RADIO_STATE_SLEEP;
+    }
+
+    return OT_ERROR_NONE;
+}
+
+otError otPlatRadioDisable(otInstance *aInstance)
+{
+    (void)aInstance;
+
+    sState     = OT_RADIO_STATE_DISABLED;
+    sTxPending = false;
+    sAckWait   = false;
+
+    return OT_ERROR_NONE;
+}
+
+bool otPlatRadioIsEnabled(otInstance *aInstance)
+{
+    (void)aInstance;
+    return sState != OT_RADIO_STATE_DISABLED;
+}
+
+otError otPlatRadioSleep(otInstance *aInstance)
+{
+    otError error = OT_ERROR_INVALID_STATE;
+
+    (void)aInstance;
+
+    if (sState == OT_RADIO_STATE_SLEEP || sState == OT_RADIO_STATE_RECEIVE)
+    {
+        error  = OT_ERROR_NONE;
+        sState = OT_RADIO_STATE_SLEEP;
+    }
+
+    return error;
+}
+
+otError otPlatRadioReceive(otInstance *aInstance, uint8_t aChannel)
+{
+    otError error = OT_ERROR_INVALID_STATE;
+
+    (void)aInstance;
+
+    if (sState != OT_RADIO_STATE_DISABLED)
+    {
+        error    = OT_ERROR_NONE;
+        sState   = OT_RADIO_STATE_RECEIVE;
+        sChannel = aChannel;
+    }
+
+    return error;
+}
+
+otRadioFrame *otPlatRadioGetTransmitBuffer(otInstance *aInstance)
+{
+    (void)aInstance;
+    return &sTransmitFrame;
+}
+
+otError otPlatRadioTransmit(otInstance *aInstance, otRadioFrame *aFrame)
+{
+    otError error = OT_ERROR_INVALID_STATE;
+
+    (void)aInstance;
+    (void)aFrame;
+
+    if (sState == OT_RADIO_STATE_RECEIVE)
+    {
+        error      = OT_ERROR_NONE;
+        sState     = OT_RADIO_STATE_TRANSMIT;
+        sTxPending = true;
+    }
+
+    return error;
+}
+
+int8_t otPlatRadioGetRssi(otInstance *aInstance)
+{
+    (void)aInstance;
+    return POSIX_RADIO_SENSITIVITY;
+}
+
+otRadioCaps otPlatRadioGetCaps(otInstance *aInstance)
+{
+    (void)aInstance;
+    return OT_RADIO_CAPS_ACK_TIMEOUT;
+}
+
+bool otPlatRadioGetPromiscuous(otInstance *aInstance)
+{
+    (void)aInstance;
+    return sPromiscuous;
+}
+
+void otPlatRadioSetPromiscuous(otInstance *aInstance, bool aEnable)
+{
+    (void)aInstance;
+    sPromiscuous = aEnable;
+}
+
+void otPlatRadioEnableSrcMatch(otInstance *aInstance, bool aEnable)
+{
+    (void)aInstance;
+    sSrcMatchEnabled = aEnable;
+}
+
+otError otPlatRadioAddSrcMatchShortEntry(otInstance *aInstance, uint16_t aShortAddress)
+{
+    otError error = OT_ERROR_NONE;
+
+    (void)aInstance;
+
+    otEXPECT_ACTION(sSrcMatchShortNum < POSIX_RADIO_SRC_MATCH_ENTRY_NUM, error = OT_ERROR_NO_BUFS);
+    sSrcMatchShort[sSrcMatchShortNum++] = aShortAddress;
+
+exit:
+    return error;
+}
+
+otError otPlatRadioAddSrcMatchExtEntry(otInstance *aInstance, const otExtAddress *aExtAddress)
+{
+    otError error = OT_ERROR_NONE;
+
+    (void)aInstance;
+
+    otEXPECT_ACTION(sSrcMatchExtNum < POSIX_RADIO_SRC_MATCH_ENTRY_NUM, error = OT_ERROR_NO_BUFS);
+    sSrcMatchExt[sSrcMatchExtNum++] = *aExtAddress;
+
+exit:
+    return error;
+}
+
+otError otPlatRadioClearSrcMatchShortEntry(otInstance *aInstance, uint16_t aShortAddress)
+{
+    otError error = OT_ERROR_NO_ADDRESS;
+
+    (void)aInstance;
+
+    for (uint8_t i = 0; i < sSrcMatchShortNum; i++)
+    {
+        if (sSrcMatchShort[i] == aShortAddress)
+        {
+            sSrcMatchShort[i] = sSrcMatchShort[--sSrcMatchShortNum];
+            error             = OT_ERROR_NONE;
+            break;
+        }
+    }
+
+    return error;
+}
+
+otError otPlatRadioClearSrcMatchExtEntry(otInstance *aInstance, const otExtAddress *aExtAddress)
+{
+    otError error = OT_ERROR_NO_ADDRESS;
+
+    (void)aInstance;
+
+    for (uint8_t i = 0; i < sSrcMatchExtNum; i++)
+    {
+        if (memcmp(sSrcMatchExt[i].m8, aExtAddress->m8, sizeof(otExtAddress)) == 0)
+        {
+            sSrcMatchExt[i] = sSrcMatchExt[--sSrcMatchExtNum];
+            error           = OT_ERROR_NONE;
+            break;
+        }
+    }
+
+    return error;
+}
+
+void otPlatRadioClearSrcMatchShortEntries(otInstance *aInstance)
+{
+    (void)aInstance;
+    sSrcMatchShortNum = 0;
+}
+
+void otPlatRadioClearSrcMatchExtEntries(otInstance *aInstance)
+{
+    (void)aInstance;
+    sSrcMatchExtNum = 0;
+}
+
+otError otPlatRadioEnergyScan(otInstance *aInstance, uint8_t aScanChannel, uint16_t aScanDuration)
+{
+    (void)aInstance;
+    (void)aScanChannel;
+    (void)aScanDuration;
+
+    return OT_ERROR_NOT_IMPLEMENTED;
+}
+
+otError otPlatRadioGetTransmitPower(otInstance *aInstance, int8_t *aPower)
+{
+    (void)aInstance;
+
+    *aPower = 0;
+
+    return OT_ERROR_NONE;
+}
+
+otError otPlatRadioSetTransmitPower(otInstance *aInstance, int8_t aPower)
+{
+    (void)aInstance;
+    (void)aPower;
+
+    return OT_ERROR_NONE;
+}
+
+int8_t otPlatRadioGetReceiveSensitivity(otInstance *aInstance)
+{
+    (void)aInstance;
+    return POSIX_RADIO_SENSITIVITY;
+}
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2018, The OpenThread Authors.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *   This file implements the OpenThread platform abstraction for UART communication on stdin/stdout.
+ *
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <openthread/platform/uart.h>
+#include <utils/code_utils.h>
+
+#include "platform-posix.h"
+
+static bool sEnabled;
+static bool sSendDonePending;
+
+otError otPlatUartEnable(void)
+{
+    sEnabled = true;
+    return OT_ERROR_NONE;
+}
+
+otError otPlatUartDisable(void)
+{
+    sEnabled = false;
+    return OT_ERROR_NONE;
+}
+
+otError otPlatUartSend(const uint8_t *aBuf, uint16_t aBufLength)
+{
+    otError error = OT_ERROR_NONE;
+
+    otEXPECT_ACTION(!sSendDonePending, error = OT_ERROR_BUSY);
+
+    while (aBufLength > 0)
+    {
+        ssize_t rval = write(STDOUT_FILENO, aBuf, aBufLength);
+
+        if (rval < 0)
+        {
+            otEXPECT_ACTION(errno == EINTR, error = OT_ERROR_FAILED);
+            continue;
+        }
+
+        aBuf += rval;
+        aBufLength -= (uint16_t)rval;
+    }
+
+    // completion is reported from posixUartProcess() so the caller is not re-entered
+    sSendDonePending = true;
+
+exit:
+    return error;
+}
+
+void posixUartUpdateFdSet(fd_set *aReadFdSet, int *aMaxFd, struct timeval *aTimeout)
+{
+    otEXPECT(sEnabled);
+
+    FD_SET(STDIN_FILENO, aReadFdSet);
+
+    if (*aMaxFd < STDIN_FILENO)
+    {
+        *aMaxFd = STDIN_FILENO;
+    }
+
+    if (sSendDonePending)
+    {
+        aTimeout->tv_sec  = 0;
+        aTimeout->tv_usec = 0;
+    }
+
+exit:
+    return;
+}
+
+void posixUartProcess(const fd_set *aReadFdSet)
+{
+    uint8_t buffer[256];
+    ssize_t rval;
+
+    otEXPECT(sEnabled);
+
+    if (sSendDonePending)
+    {
+        sSendDonePending = false;
+        posixLoopCountEvent();
+        otPlatUartSendDone();
+    }
+
+    otEXPECT(FD_ISSET(STDIN_FILENO, aReadFdSet));
+
+    rval = read(STDIN_FILENO, buffer, sizeof(buffer));
+    posixLoopCountEvent();
+
+    if (rval > 0)
+    {
+        otPlatUartReceived(buffer, (uint16_t)rval);
+    }
+    else if (rval == 0)
+    {
+        // stdin closed, keep running as a headless node
+        sEnabled = false;
+    }
+
+exit:
+    return;
+}
@@ -51,6 +51,7 @@
 #include <openthread/thread.h>
 #include <openthread/platform/logging.h>
 #include "platform.h"
+#include "platform-kw41z.h"
 #include <app_timer.h>
 #include <nrf_error.h>
 #include <nrf_log.h>
@@ -67,6 +68,7 @@
 #include "pin_mux.h"
 #include "fsl_adc16.h"
 #include <openthread/include/openthread/platform/uart.h>
+#include "coap_app.h"
 #include <openthread/src/core/common/logging.hpp>
 
 //
@@ -79,8 +81,14 @@
 #define DEMO_ADC16_BASE ADC0
 #define DEMO_ADC16_CHANNEL_GROUP 0U
 #define DEMO_ADC16_USER_CHANNEL 4U /* PTB18, ADC0_SE4 */
+#define LIGHT_POLL_PERIOD_MS 100U /* main task wakes at least this often to sample the light level */
+#define LIGHT_HISTORY_SIZE 3U /* past /lux notifications reported in SenML, with their age */
 #if ENABLE_RTT_CONSOLE
 #define DOWN_BUFFER_SIZE 100
+#define RTT_POLL_PERIOD_MS 10U /* RTT down buffer has no interrupt, so it is polled */
+#define MAIN_TASK_WAIT_MS RTT_POLL_PERIOD_MS
+#else
+#define MAIN_TASK_WAIT_MS LIGHT_POLL_PERIOD_MS
 #endif
 
 //
@@ -101,17 +109,24 @@ typedef enum
 	light_goes_up
 } lightTrigger_t;
 
+typedef struct
+{
+	uint32_t adc;
+	TickType_t ticks;
+} lightSample_t;
+
 //
 // Function prototypes
 //
 static void main_task(void *pvParameters);
 
-void coap_handler_test ( void * aContext,  otMessage * aMessage, const otMessageInfo *aMessageInfo);
-void coap_handler_led_on  ( void * aContext,  otMessage * aMessage, const otMessageInfo *aMessageInfo);
-void coap_handler_lux  ( void * aContext,  otMessage * aMessage, const otMessageInfo *aMessageInfo);
 void coapAppInit();
+static void cli_rxstats(int argc, char *argv[]);
 void getLightLevel();
 static void coapAppProcess(otInstance *sInstance);
+static void coapAppNotify(otInstance *sInstance);
+static void led_write(coapAppResponse_t *aResponse);
+static void lux_write(coapAppResponse_t *aResponse);
 
 //
 //  Variables
@@ -120,10 +135,10 @@ static appMode_t app_mode = appMode_Init;
 static otInstance *sInstance;
 adc16_config_t adc16ConfigStruct;
 adc16_channel_config_t adc16ChannelConfigStruct;
-otCoapResource cr_1; // coap resource 1
-otCoapResource cr_led; // coap resource for led
-otCoapResource cr_lux; // coap resource for lux
-otCoapResource cr_mode; // coap resource for mode
+coapAppResource_t cr_1; // coap resource 1
+coapAppResource_t cr_led; // coap resource for led
+coapAppResource_t cr_lux; // coap resource for lux
+coapAppResource_t cr_mode; // coap resource for mode
 otError error = OT_ERROR_NONE;
 uint32_t 	light_level_adc; // current light level in adc readings
 uint32_t	light_index = 0; // index of a device
@@ -134,11 +149,61 @@ uint32_t light_lvl_trigger = 500;
 uint32_t light_lvl_gyst = 200;
 uint32_t light_lvl_last;
 lightTrigger_t light_trigger = light_no_change;
+uint32_t light_lvl_notify_delta = 100; // adc change that is pushed to /lux observers
+uint32_t light_lvl_notified;
+lightTrigger_t light_trigger_notified = light_no_change;
+uint32_t led_notified;
+lightSample_t light_history[LIGHT_HISTORY_SIZE]; // last notified levels, newest first
+uint8_t light_history_count = 0;
 TickType_t  ticks, prev_ticks;
+static const otCliCommand cli_commands[] = {{"rxstats", &cli_rxstats}};
+
+static void coapAppNotify(otInstance *sInstance)
+{
+	coapAppResponse_t content;
+	uint32_t led_value;
+	uint32_t light_delta = (light_level_adc > light_lvl_notified) ? light_level_adc - light_lvl_notified
+	                                                               : light_lvl_notified - light_level_adc;
+
+	// push lux only when trigger state flips or the level drifts far enough
+	if (light_trigger != light_trigger_notified || light_delta >= light_lvl_notify_delta)
+	{
+		light_trigger_notified = light_trigger;
+		light_lvl_notified = light_level_adc;
+
+		coapAppResponseInit(&content, OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN);
+		lux_write(&content);
+		coapAppResourceNotify(&cr_lux, &content);
+
+		coapAppResponseInit(&content, OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR);
+		lux_write(&content);
+		coapAppResourceNotify(&cr_lux, &content);
+
+		memmove(&light_history[1], &light_history[0], sizeof(light_history) - sizeof(light_history[0]));
+		light_history[0].adc = light_level_adc;
+		light_history[0].ticks = xTaskGetTickCount();
+		if (light_history_count < LIGHT_HISTORY_SIZE) light_history_count++;
+	}
+
+	led_value = GPIO_ReadPinInput(BOARD_LED_GPIO, BOARD_LED_GPIO_PIN);
+	if (led_value != led_notified)
+	{
+		led_notified = led_value;
+
+		coapAppResponseInit(&content, OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN);
+		led_write(&content);
+		coapAppResourceNotify(&cr_led, &content);
+
+		coapAppResponseInit(&content, OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR);
+		led_write(&content);
+		coapAppResourceNotify(&cr_led, &content);
+	}
+}
 
 static void coapAppProcess(otInstance *sInstance)
 {
 	getLightLevel();
+	coapAppNotify(sInstance);
 	switch(app_mode)
 	{
 	case appMode_Init:
@@ -227,6 +292,7 @@ pseudo_reset:
     sInstance = otInstanceInitSingle();
     assert(sInstance);
     otCliUartInit(sInstance);
+    otCliSetUserCommands(cli_commands, sizeof(cli_commands) / sizeof(cli_commands[0]));
     otIp6SetEnabled(sInstance, true);
 
     coapAppInit(); // init COAP resources
@@ -253,442 +319,285 @@ pseudo_reset:
         	} else        	index++;
         }
 #endif
-        taskYIELD();
+        PlatformEventWait(MAIN_TASK_WAIT_MS);
     }
     otInstanceFinalize(sInstance);
     goto pseudo_reset;
 }
 
-void coap_handler_test ( void * aContext, otMessage * aMessage, const otMessageInfo *aMessageInfo)
+static void coap_handler_test(const coapAppRequest_t *aRequest, coapAppResponse_t *aResponse)
 {
-    otError      error = OT_ERROR_NONE;
-    otMessage *  responseMessage;
-    otCoapCode   responseCode    = OT_COAP_CODE_EMPTY;
-    char         responseContent[] = "hello\r\n";
-
-    if (otCoapMessageGetType(aMessage) == OT_COAP_TYPE_CONFIRMABLE ||
-        otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-    {
-        if (otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-        {
-            responseCode = OT_COAP_CODE_CONTENT;
-        }
-        else
-        {
-            responseCode = OT_COAP_CODE_VALID;
-        }
-
-        responseMessage = otCoapNewMessage(sInstance, NULL);
-        VerifyOrExit(responseMessage != NULL, error = OT_ERROR_NO_BUFS);
-
-        otCoapMessageInit(responseMessage, OT_COAP_TYPE_ACKNOWLEDGMENT, responseCode);
-        otCoapMessageSetMessageId(responseMessage, otCoapMessageGetMessageId(aMessage));
-        otCoapMessageSetToken(responseMessage, otCoapMessageGetToken(aMessage), otCoapMessageGetTokenLength(aMessage));
-
-        if (otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-        {
-            otCoapMessageSetPayloadMarker(responseMessage);
-            SuccessOrExit(error = otMessageAppend(responseMessage, &responseContent, sizeof(responseContent)));
-        }
-
-        SuccessOrExit(error = otCoapSendResponse(sInstance, responseMessage, aMessageInfo));
-    }
-
-exit:
-
-    if (error != OT_ERROR_NONE)
-    {
-        if (responseMessage != NULL)
-        {
-        	otLogInfoPlat("coap send response error %d: %s\r\n", error,
-                                               otThreadErrorToString(error));
-            otMessageFree(responseMessage);
-        }
-    }
-    else if (responseCode >= OT_COAP_CODE_RESPONSE_MIN)
-    {
-    	otLogInfoPlat("coap response sent successfully!\r\n");
-    }
+	coapAppWrite(aResponse, "hello\r\n");
 }
 
-void led_process_query(const char *option_value, uint16_t option_length)
+static void led_write(coapAppResponse_t *aResponse)
 {
-	otLogInfoPlat("Processing query %.*s\r\n", option_length, option_value);
+	uint32_t led_value = GPIO_ReadPinInput(BOARD_LED_GPIO, BOARD_LED_GPIO_PIN);
+	senmlWriter_t writer;
 
-	if (strncmp(option_value, "toggle", option_length) == 0)
-	{
-		otLogInfoPlat("toggle action");
-        GPIO_TogglePinsOutput(BOARD_LED_GPIO, 1u << BOARD_LED_GPIO_PIN);
-	};
-	if (strncmp(option_value, "on", option_length) == 0)
+	if (aResponse->format == OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR)
 	{
-		otLogInfoPlat("on action");
-        GPIO_SetPinsOutput(BOARD_LED_GPIO, 1u << BOARD_LED_GPIO_PIN);
-	};
-	if (strncmp(option_value, "off", option_length) == 0)
+		coapAppSenmlBegin(aResponse, &writer, 1);
+		senmlWriteRecord(&writer, 2);
+		senmlWriteText(&writer, senmlLabel_Name, "led");
+		senmlWriteBool(&writer, senmlLabel_BoolValue, led_value != 0);
+		coapAppSenmlEnd(aResponse, &writer);
+	}
+	else
 	{
-		otLogInfoPlat("off action");
-        GPIO_ClearPinsOutput(BOARD_LED_GPIO, 1u << BOARD_LED_GPIO_PIN);
-	};
+		coapAppWrite(aResponse, "led now is ");
+		coapAppWrite(aResponse, led_value ? " on" : "off");
+	}
 }
 
-void coap_handler_led  ( void * aContext, otMessage * aMessage, const otMessageInfo *aMessageInfo)
+static void coap_handler_led(const coapAppRequest_t *aRequest, coapAppResponse_t *aResponse)
 {
-    otError      error = OT_ERROR_NONE;
-    otMessage *  responseMessage;
-    otCoapCode   responseCode    = OT_COAP_CODE_EMPTY;
-    char         responseContent[14];
-    uint32_t     led_value;
-
-	const otCoapOption *option;
-	char option_value[100];
+	uint32_t value;
 
-	option = otCoapMessageGetFirstOption(aMessage);
-	while (error == OT_ERROR_NONE)
+	for (uint8_t i = 0; i < aRequest->paramCount; i++)
 	{
-		error = otCoapMessageGetOptionValue(aMessage, &option_value);
-		if (option->mNumber == OT_COAP_OPTION_URI_QUERY) led_process_query(option_value, option->mLength);
-	    option = otCoapMessageGetNextOption(aMessage);
-	    if (option->mLength > 255) break;
-	}
-
-    if (otCoapMessageGetType(aMessage) == OT_COAP_TYPE_CONFIRMABLE ||
-        otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-    {
-        if (otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-        {
-            responseCode = OT_COAP_CODE_CONTENT;
-        }
-        else
-        {
-            responseCode = OT_COAP_CODE_VALID;
-        }
+		const coapAppParam_t *param = &aRequest->params[i];
 
-        responseMessage = otCoapNewMessage(sInstance, NULL);
-        VerifyOrExit(responseMessage != NULL, error = OT_ERROR_NO_BUFS);
-
-        otCoapMessageInit(responseMessage, OT_COAP_TYPE_ACKNOWLEDGMENT, responseCode);
-        otCoapMessageSetMessageId(responseMessage, otCoapMessageGetMessageId(aMessage));
-        otCoapMessageSetToken(responseMessage, otCoapMessageGetToken(aMessage), otCoapMessageGetTokenLength(aMessage));
-
-        if (otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-        {
-            otCoapMessageSetPayloadMarker(responseMessage);
-            led_value = GPIO_ReadPinInput(BOARD_LED_GPIO, BOARD_LED_GPIO_PIN);
-            sprintf(responseContent, "led now is %s", led_value ? " on": "off");
-            SuccessOrExit(error = otMessageAppend(responseMessage, &responseContent, sizeof(responseContent)));
-        }
-
-        SuccessOrExit(error = otCoapSendResponse(sInstance, responseMessage, aMessageInfo));
-    }
-
-exit:
+		if (coapAppParamIs(param, "toggle"))
+		{
+			otLogInfoPlat("toggle action");
+			GPIO_TogglePinsOutput(BOARD_LED_GPIO, 1u << BOARD_LED_GPIO_PIN);
+		}
+		else if (coapAppParamIs(param, "on"))
+		{
+			otLogInfoPlat("on action");
+			GPIO_SetPinsOutput(BOARD_LED_GPIO, 1u << BOARD_LED_GPIO_PIN);
+		}
+		else if (coapAppParamIs(param, "off"))
+		{
+			otLogInfoPlat("off action");
+			GPIO_ClearPinsOutput(BOARD_LED_GPIO, 1u << BOARD_LED_GPIO_PIN);
+		}
+		else if (coapAppParamIs(param, "led") && coapAppParamGetUint(param, &value))
+		{
+			// SenML {"n": "led", "vb": true} or led=1
+			if (value != 0)
+			{
+				GPIO_SetPinsOutput(BOARD_LED_GPIO, 1u << BOARD_LED_GPIO_PIN);
+			}
+			else
+			{
+				GPIO_ClearPinsOutput(BOARD_LED_GPIO, 1u << BOARD_LED_GPIO_PIN);
+			}
+		}
+	}
 
-    if (error != OT_ERROR_NONE)
-    {
-        if (responseMessage != NULL)
-        {
-        	otLogInfoPlat("coap send response error %d: %s\r\n", error,
-                                               otThreadErrorToString(error));
-            otMessageFree(responseMessage);
-        }
-    }
-    else if (responseCode >= OT_COAP_CODE_RESPONSE_MIN)
-    {
-    	otLogInfoPlat("coap response sent successfully!\r\n");
-    }
+	led_write(aResponse);
 }
 
-void lux_process_query(const char *option_value, uint16_t option_length, char *responseContent)
+static void lux_write_senml(coapAppResponse_t *aResponse)
 {
-	char query[option_length+1];
-	strncpy(query, option_value, option_length);
-	query[option_length] = '\0';
-	otLogInfoPlat("Processing query %s\r\n", query);
-
-//	char *key;
-//	char *value;
-//	char *st = query;
-//
-//	key = strsep(&st, "=");
-//	value = st;
-
+	senmlWriter_t writer;
+	TickType_t now = xTaskGetTickCount();
+	uint8_t history = light_history_count;
 
-	if (strncmp(query, "lvl=", 4) == 0)
+	// [{"n": "lvl"}, {"n": "dz"}, {"bn": "adc"}, then past "adc" readings with a relative "t"],
+	// dropping the oldest readings until the records fit the payload
+	do
 	{
-		uint32_t trigger_lvl = strtol(&query[4], NULL, 10);
-		if (trigger_lvl != 0) {
-			light_lvl_trigger = trigger_lvl;
-			otLogInfoPlat("set trigger level to %lu", light_lvl_trigger);
-		    sprintf(responseContent, "lvl: %lu", light_lvl_trigger);
-		}
-	};
-	if (strncmp(query, "dz=", 3) == 0)
-	{
-		otLogInfoPlat("get deadzone");
-		uint32_t deadzone_val = strtol(&query[3], NULL, 10);
-		if (deadzone_val != 0) {
-			light_lvl_gyst = deadzone_val;
-			otLogInfoPlat("set deadzone value to %lu", light_lvl_gyst);
-		    sprintf(responseContent, "dz: %lu", light_lvl_gyst);
+		coapAppSenmlBegin(aResponse, &writer, 3 + history);
+		senmlWriteRecord(&writer, 2);
+		senmlWriteText(&writer, senmlLabel_Name, "lvl");
+		senmlWriteInt(&writer, senmlLabel_Value, (int32_t)light_lvl_trigger);
+		senmlWriteRecord(&writer, 2);
+		senmlWriteText(&writer, senmlLabel_Name, "dz");
+		senmlWriteInt(&writer, senmlLabel_Value, (int32_t)light_lvl_gyst);
+		senmlWriteRecord(&writer, 2);
+		senmlWriteText(&writer, senmlLabel_BaseName, "adc");
+		senmlWriteInt(&writer, senmlLabel_Value, (int32_t)light_level_adc);
+
+		for (uint8_t i = 0; i < history; i++)
+		{
+			senmlWriteRecord(&writer, 2);
+			senmlWriteInt(&writer, senmlLabel_Value, (int32_t)light_history[i].adc);
+			senmlWriteInt(&writer, senmlLabel_Time, -(int32_t)((now - light_history[i].ticks) / configTICK_RATE_HZ));
 		}
-	};
-
-	if (strncmp(query, "raw", option_length) == 0)
-	{
-	    otLogInfoPlat("LUX ADC  Value: %d\r\n", light_level_adc);
-	    sprintf(responseContent, "adc: %lu", light_level_adc);
-	};
-
-	if (strncmp(query, "lvl", option_length) == 0)
-	{
-	    otLogInfoPlat("LUX trigger  Value: %d\r\n", light_lvl_trigger);
-	    sprintf(responseContent, "lvl: %lu", light_lvl_trigger);
-	};
-
-	if (strncmp(query, "dz", option_length) == 0)
-	{
-	    otLogInfoPlat("LUX Deadzone  Value: %d\r\n", light_lvl_gyst);
-	    sprintf(responseContent, "dz: %lu", light_lvl_gyst);
-	};
+	} while (!senmlWriterIsValid(&writer) && history-- > 0);
 
+	coapAppSenmlEnd(aResponse, &writer);
 }
 
-void coap_handler_lux  ( void * aContext, otMessage * aMessage, const otMessageInfo *aMessageInfo)
+// the representation a plain GET returns and observers are notified with
+static void lux_write(coapAppResponse_t *aResponse)
 {
-    otError      error = OT_ERROR_NONE;
-    otMessage *  responseMessage;
-    otCoapCode   responseCode    = OT_COAP_CODE_EMPTY;
-    char         responseContent[30] = "0";
-
-    //parse options
-
-	const otCoapOption *option;
-	char option_value[100];
-
-
-	option = otCoapMessageGetFirstOption(aMessage);
-	while (error == OT_ERROR_NONE)
+	if (aResponse->format == OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR)
 	{
-		error = otCoapMessageGetOptionValue(aMessage, &option_value);
-		 if (option->mNumber == OT_COAP_OPTION_URI_QUERY)
-		{
-			otLogInfoPlat("URI query is %.*s\r\n", option->mLength, &option_value);
-			lux_process_query(option_value, option->mLength, responseContent);
-		}
-	    option = otCoapMessageGetNextOption(aMessage);
-	    if (option->mLength > 255) break;
+		lux_write_senml(aResponse);
+	}
+	else
+	{
+		coapAppWrite(aResponse, "adc: ");
+		coapAppWriteUint(aResponse, light_level_adc);
 	}
-
-    if (otCoapMessageGetType(aMessage) == OT_COAP_TYPE_CONFIRMABLE ||
-        otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-    {
-        if (otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-        {
-            responseCode = OT_COAP_CODE_CONTENT;
-        }
-        else
-        {
-            responseCode = OT_COAP_CODE_VALID;
-        }
-
-        responseMessage = otCoapNewMessage(sInstance, NULL);
-        VerifyOrExit(responseMessage != NULL, error = OT_ERROR_NO_BUFS);
-
-        otCoapMessageInit(responseMessage, OT_COAP_TYPE_ACKNOWLEDGMENT, responseCode);
-        otCoapMessageSetMessageId(responseMessage, otCoapMessageGetMessageId(aMessage));
-        otCoapMessageSetToken(responseMessage, otCoapMessageGetToken(aMessage), otCoapMessageGetTokenLength(aMessage));
-
-        if (otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-        {
-            otCoapMessageSetPayloadMarker(responseMessage);
-            SuccessOrExit(error = otMessageAppend(responseMessage, &responseContent, sizeof(responseContent)));
-        }
-
-        SuccessOrExit(error = otCoapSendResponse(sInstance, responseMessage, aMessageInfo));
-    }
-
-exit:
-
-    if (error != OT_ERROR_NONE)
-    {
-        if (responseMessage != NULL)
-        {
-        	otLogInfoPlat("coap send response error %d: %s\r\n", error,
-                                               otThreadErrorToString(error));
-            otMessageFree(responseMessage);
-        }
-    }
-    else if (responseCode >= OT_COAP_CODE_RESPONSE_MIN)
-    {
-    	otLogInfoPlat("coap response sent successfully!\r\n");
-    }
 }
 
-void mode_process_query(const char *option_value, uint16_t option_length, char *responseContent)
+static void coap_handler_lux(const coapAppRequest_t *aRequest, coapAppResponse_t *aResponse)
 {
-	char query[option_length+1];
-	strncpy(query, option_value, option_length);
-	query[option_length] = '\0';
-	otLogInfoPlat("Processing query %s\r\n", query);
+	const char *label = NULL;
+	uint32_t value = 0;
+	uint32_t number;
 
-	if (strncmp(query, "mode", option_length) == 0)
+	// the last recognised parameter decides what is reported back
+	for (uint8_t i = 0; i < aRequest->paramCount; i++)
 	{
-		switch(app_mode)
-		{
-		case appMode_Manual:
+		const coapAppParam_t *param = &aRequest->params[i];
+
+		if (coapAppParamIs(param, "lvl"))
 		{
-		    sprintf(responseContent, "mode: off");
-			break;
+			if (coapAppParamGetUint(param, &number) && number != 0)
+			{
+				light_lvl_trigger = number;
+				otLogInfoPlat("set trigger level to %lu", light_lvl_trigger);
+			}
+			label = "lvl: ";
+			value = light_lvl_trigger;
 		}
-		case appMode_Single:
+		else if (coapAppParamIs(param, "dz"))
 		{
-		    sprintf(responseContent, "mode: single");
-			break;
+			if (coapAppParamGetUint(param, &number) && number != 0)
+			{
+				light_lvl_gyst = number;
+				otLogInfoPlat("set deadzone value to %lu", light_lvl_gyst);
+			}
+			label = "dz: ";
+			value = light_lvl_gyst;
 		}
-		case appMode_Multiple:
+		else if (coapAppParamIs(param, "raw"))
 		{
-		    sprintf(responseContent, "mode: multi");
-			break;
+			label = "adc: ";
+			value = light_level_adc;
 		}
-		default:
-			break;
-		}
-	};
+	}
 
-	if (strncmp(query, "index", option_length) == 0)
+	if (label == NULL || aResponse->format == OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR)
 	{
-	    sprintf(responseContent, "index: %lu", light_index);
-	};
-
-
-	if (strncmp(query, "index=", 6) == 0)
+		lux_write(aResponse);
+	}
+	else
 	{
-		uint32_t number = strtol(&query[6], NULL, 10);
-		if (number != 0) {
-			light_index = number;
-			otLogInfoPlat("set device index to %lu", light_index);
-		    sprintf(responseContent, "index: %lu", light_index);
-		}
-	};
+		coapAppWrite(aResponse, label);
+		coapAppWriteUint(aResponse, value);
+	}
+}
 
-	if (strncmp(query, "mode=", 5) == 0)
+static const char *mode_to_string(appMode_t mode)
+{
+	switch (mode)
 	{
-		char mode_str[sizeof(query) - sizeof("mode=")+1];
-		strcpy(mode_str, &query[5]);
-		mode_str[sizeof(query) - sizeof("mode=")] = '\0';
-		otLogInfoPlat("mode_str %s\r\n", mode_str);
-		if (strcmp(mode_str, "off") == 0)
-		{
-			app_mode = appMode_Manual;
-			otLogInfoPlat("set device mode to off");
-			sprintf(responseContent, "mode: off");
-		}
-		else if (strcmp(mode_str, "single") == 0)
-		{
-			app_mode = appMode_Single;
-			otLogInfoPlat("set device mode to single");
-			sprintf(responseContent, "mode: single");
-		}
-		else if (strcmp(mode_str, "multi") == 0)
-		{
-			app_mode = appMode_Multiple;
-			otLogInfoPlat("set device mode to multi");
-			sprintf(responseContent, "mode: multi");
-		}
+	case appMode_Manual:
+		return "off";
+	case appMode_Single:
+		return "single";
+	case appMode_Multiple:
+		return "multi";
+	default:
+		return NULL;
 	}
 }
 
-void coap_handler_mode  ( void * aContext, otMessage * aMessage, const otMessageInfo *aMessageInfo)
+static void coap_handler_mode(const coapAppRequest_t *aRequest, coapAppResponse_t *aResponse)
 {
-    otError      error = OT_ERROR_NONE;
-    otMessage *  responseMessage;
-    otCoapCode   responseCode    = OT_COAP_CODE_EMPTY;
-    char         responseContent[30] = "0";
-
-    //parse options
-
-	const otCoapOption *option;
-	char option_value[100];
+	bool show_index = false;
+	bool show_mode = false;
+	uint32_t number;
 
-
-	option = otCoapMessageGetFirstOption(aMessage);
-	while (error == OT_ERROR_NONE)
+	for (uint8_t i = 0; i < aRequest->paramCount; i++)
 	{
-		error = otCoapMessageGetOptionValue(aMessage, &option_value);
-		if (option->mNumber == OT_COAP_OPTION_URI_QUERY)
+		const coapAppParam_t *param = &aRequest->params[i];
+
+		if (coapAppParamIs(param, "mode"))
+		{
+			if (coapAppParamValueIs(param, "off"))
+			{
+				app_mode = appMode_Manual;
+			}
+			else if (coapAppParamValueIs(param, "single"))
+			{
+				app_mode = appMode_Single;
+			}
+			else if (coapAppParamValueIs(param, "multi"))
+			{
+				app_mode = appMode_Multiple;
+			}
+			show_mode = true;
+			show_index = false;
+		}
+		else if (coapAppParamIs(param, "index"))
 		{
-			otLogInfoPlat("URI query is %.*s\r\n", option->mLength, &option_value);
-			mode_process_query(option_value, option->mLength, responseContent);
-			break;
+			if (coapAppParamGetUint(param, &number) && number != 0)
+			{
+				light_index = number;
+				otLogInfoPlat("set device index to %lu", light_index);
+			}
+			show_index = true;
+			show_mode = false;
 		}
-	    option = otCoapMessageGetNextOption(aMessage);
-	    if (option->mLength > 255) break;
 	}
 
-    if (otCoapMessageGetType(aMessage) == OT_COAP_TYPE_CONFIRMABLE ||
-        otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-    {
-        if (otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-        {
-            responseCode = OT_COAP_CODE_CONTENT;
-        }
-        else
-        {
-            responseCode = OT_COAP_CODE_VALID;
-        }
-
-        responseMessage = otCoapNewMessage(sInstance, NULL);
-        VerifyOrExit(responseMessage != NULL, error = OT_ERROR_NO_BUFS);
-
-        otCoapMessageInit(responseMessage, OT_COAP_TYPE_ACKNOWLEDGMENT, responseCode);
-        otCoapMessageSetMessageId(responseMessage, otCoapMessageGetMessageId(aMessage));
-        otCoapMessageSetToken(responseMessage, otCoapMessageGetToken(aMessage), otCoapMessageGetTokenLength(aMessage));
-
-        if (otCoapMessageGetCode(aMessage) == OT_COAP_CODE_GET)
-        {
-            otCoapMessageSetPayloadMarker(responseMessage);
-            SuccessOrExit(error = otMessageAppend(responseMessage, &responseContent, sizeof(responseContent)));
-        }
-
-        SuccessOrExit(error = otCoapSendResponse(sInstance, responseMessage, aMessageInfo));
-    }
-
-exit:
+	if (aResponse->format == OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR)
+	{
+		senmlWriter_t writer;
 
-    if (error != OT_ERROR_NONE)
-    {
-        if (responseMessage != NULL)
-        {
-        	otLogInfoPlat("coap send response error %d: %s\r\n", error,
-                                               otThreadErrorToString(error));
-            otMessageFree(responseMessage);
-        }
-    }
-    else if (responseCode >= OT_COAP_CODE_RESPONSE_MIN)
-    {
-    	otLogInfoPlat("coap response sent successfully!\r\n");
-    }
+		coapAppSenmlBegin(aResponse, &writer, mode_to_string(app_mode) != NULL ? 2 : 1);
+		if (mode_to_string(app_mode) != NULL)
+		{
+			senmlWriteRecord(&writer, 2);
+			senmlWriteText(&writer, senmlLabel_Name, "mode");
+			senmlWriteText(&writer, senmlLabel_StringValue, mode_to_string(app_mode));
+		}
+		senmlWriteRecord(&writer, 2);
+		senmlWriteText(&writer, senmlLabel_Name, "index");
+		senmlWriteInt(&writer, senmlLabel_Value, (int32_t)light_index);
+		coapAppSenmlEnd(aResponse, &writer);
+	}
+	else if (show_mode && mode_to_string(app_mode) != NULL)
+	{
+		coapAppWrite(aResponse, "mode: ");
+		coapAppWrite(aResponse, mode_to_string(app_mode));
+	}
+	else if (show_index)
+	{
+		coapAppWrite(aResponse, "index: ");
+		coapAppWriteUint(aResponse, light_index);
+	}
+	else
+	{
+		coapAppWrite(aResponse, "0");
+	}
 }
 
 void coapAppInit()
 {
 	//    error = otCoapStart(sInstance, OT_DEFAULT_COAP_PORT);
-	    cr_1.mUriPath = "test";
-	    cr_1.mHandler = &coap_handler_test;
-	    error = otCoapAddResource(sInstance, &cr_1);
+	    error = coapAppResourceAdd(sInstance, &cr_1, "test", &coap_handler_test, false, false);
+	    error = coapAppResourceAdd(sInstance, &cr_led, "led", &coap_handler_led, true, true);
+	    error = coapAppResourceAdd(sInstance, &cr_lux, "lux", &coap_handler_lux, true, true);
+	    error = coapAppResourceAdd(sInstance, &cr_mode, "device", &coap_handler_mode, false, true);
+}
 
-	    cr_led.mUriPath = "led";
-	    cr_led.mHandler = &coap_handler_led;
-	    error = otCoapAddResource(sInstance, &cr_led);
+static void cli_rxstats(int argc, char *argv[])
+{
+	kw41zRadioRxStats stats;
 
-	    cr_lux.mUriPath = "lux";
-	    cr_lux.mHandler = &coap_handler_lux;
-	    error = otCoapAddResource(sInstance, &cr_lux);
+	if (argc > 0 && strcmp(argv[0], "reset") == 0)
+	{
+		kw41zRadioResetRxStats();
+	}
+	else
+	{
+		kw41zRadioGetRxStats(&stats);
+		otCliOutputFormat("received: %lu\r\n", stats.mReceived);
+		otCliOutputFormat("dropped: %lu\r\n", stats.mDropped);
+		otCliOutputFormat("invalid: %lu\r\n", stats.mInvalid);
+		otCliOutputFormat("max pending: %u/%u\r\n", stats.mMaxPending, RADIO_CONFIG_RX_FRAME_NUM);
+	}
 
-	    cr_mode.mUriPath = "device";
-	    cr_mode.mHandler = &coap_handler_mode;
-	    error = otCoapAddResource(sInstance, &cr_mode);
+	otCliOutputFormat("Done\r\n");
 }
 
 void getLightLevel()
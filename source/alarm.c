@@ -25,24 +25,99 @@
  *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  *  POSSIBILITY OF SUCH DAMAGE.
  */
-
 /**
  * @file
  *   This file implements the OpenThread platform abstraction for the alarm.
  *
+ *   PIT channel 0 is used as a 1 ms prescaler and channel 1 is chained to it.
+ *   Channel 1 is reloaded with the time left until the next alarm deadline, so
+ *   the interrupt fires only when the alarm expires (or the 32-bit period wraps).
+ *
  */
 
 #include "fsl_clock.h"
 #include "fsl_device_registers.h"
 #include "fsl_pit.h"
+#include <stdbool.h>
 #include <stdint.h>
 
+#include "platform.h"
+
 //#include "openthread/openthread.h"
 #include "openthread/platform/alarm-milli.h"
 #include "openthread/platform/diag.h"
 
-static volatile uint32_t sTime      = 0;
-static uint32_t          sAlarmTime = 0;
+enum
+{
+    kMaxPeriod = 0xFFFFFFFF,
+};
+
+static uint32_t          sTimeBase     = 0; /* time in ms when the current channel 1 period has started */
+static volatile uint32_t sAlarmTime    = 0;
+static volatile bool     sAlarmPending = false;
+static volatile bool     sAlarmFired   = false;
+
+/* Must be called with interrupts disabled */
+static uint32_t alarmGetNow(void)
+{
+    uint32_t load  = PIT->CHANNEL[kPIT_Chnl_1].LDVAL;
+    uint32_t count = PIT_GetCurrentTimerCount(PIT, kPIT_Chnl_1);
+    uint32_t now   = sTimeBase + (load - count);
+
+    if (PIT_GetStatusFlags(PIT, kPIT_Chnl_1) & kPIT_TimerFlag)
+    {
+        /* Period has expired but the interrupt is not handled yet, counter is already reloaded */
+        count = PIT_GetCurrentTimerCount(PIT, kPIT_Chnl_1);
+        now   = sTimeBase + load + 1 + (load - count);
+    }
+
+    return now;
+}
+
+/*
+ * Must be called with interrupts disabled. Returns true when the alarm fired, the caller signals the main task
+ * once interrupts are enabled again: from task context the notification exits a FreeRTOS critical section, which
+ * would unmask interrupts in the middle of the caller's masked region.
+ */
+static bool alarmReload(void)
+{
+    uint32_t now    = alarmGetNow();
+    uint32_t period = kMaxPeriod;
+    uint32_t prescale;
+    bool     fired  = false;
+
+    if (sAlarmPending)
+    {
+        int32_t remaining = (int32_t)(sAlarmTime - now);
+
+        if (remaining <= 0)
+        {
+            sAlarmPending = false;
+            sAlarmFired   = true;
+            fired         = true;
+        }
+        else
+        {
+            period = (uint32_t)remaining - 1;
+        }
+    }
+
+    /* Restart channel 1 only, channel 0 keeps its phase so no time is lost */
+    prescale  = PIT_GetCurrentTimerCount(PIT, kPIT_Chnl_0);
+    sTimeBase = now;
+    PIT_StopTimer(PIT, kPIT_Chnl_1);
+    PIT_ClearStatusFlags(PIT, kPIT_Chnl_1, kPIT_TimerFlag);
+    PIT_SetTimerPeriod(PIT, kPIT_Chnl_1, period);
+    PIT_StartTimer(PIT, kPIT_Chnl_1);
+
+    if (PIT_GetCurrentTimerCount(PIT, kPIT_Chnl_0) > prescale)
+    {
+        /* Channel 0 expired while channel 1 was stopped */
+        sTimeBase++;
+    }
+
+    return fired;
+}
 
 void kw41zAlarmInit(void)
 {
@@ -51,19 +126,25 @@ void kw41zAlarmInit(void)
 
     PIT_GetDefaultConfig(&config);
     PIT_Init(PIT, &config);
+
     PIT_SetTimerPeriod(PIT, kPIT_Chnl_0, count);
+    PIT_SetTimerPeriod(PIT, kPIT_Chnl_1, kMaxPeriod);
+    PIT_SetTimerChainMode(PIT, kPIT_Chnl_1, true);
+    PIT_EnableInterrupts(PIT, kPIT_Chnl_1, kPIT_TimerInterruptEnable);
+
+    sTimeBase = 0;
+    PIT_StartTimer(PIT, kPIT_Chnl_1);
     PIT_StartTimer(PIT, kPIT_Chnl_0);
 
-    PIT_EnableInterrupts(PIT, kPIT_Chnl_0, kPIT_TimerInterruptEnable);
     NVIC_ClearPendingIRQ(PIT_IRQn);
     NVIC_EnableIRQ(PIT_IRQn);
 }
 
 void kw41zAlarmProcess(otInstance *aInstance)
 {
-    if ((sAlarmTime != 0) && (sTime >= sAlarmTime))
+    if (sAlarmFired)
     {
-        sAlarmTime = 0;
+        sAlarmFired = false;
 #if OPENTHREAD_ENABLE_DIAG
 
         if (otPlatDiagModeGet())
@@ -80,23 +161,54 @@ void kw41zAlarmProcess(otInstance *aInstance)
 
 void otPlatAlarmMilliStartAt(otInstance *aInstance, uint32_t aT0, uint32_t aDt)
 {
+    uint32_t primask = DisableGlobalIRQ();
+    bool     fired;
+
     (void)aInstance;
-    sAlarmTime = aT0 + aDt;
+    sAlarmTime    = aT0 + aDt;
+    sAlarmPending = true;
+    sAlarmFired   = false;
+    fired         = alarmReload();
+
+    EnableGlobalIRQ(primask);
+
+    if (fired)
+    {
+        PlatformEventSignalPending();
+    }
 }
 
 void otPlatAlarmMilliStop(otInstance *aInstance)
 {
     (void)aInstance;
-    sAlarmTime = 0;
+    sAlarmPending = false;
+    sAlarmFired   = false;
 }
 
 uint32_t otPlatAlarmMilliGetNow(void)
 {
-    return sTime;
+    uint32_t primask = DisableGlobalIRQ();
+    uint32_t now     = alarmGetNow();
+
+    EnableGlobalIRQ(primask);
+
+    return now;
 }
 
 void PIT_IRQHandler(void)
 {
-    PIT_ClearStatusFlags(PIT, kPIT_Chnl_0, kPIT_TimerFlag);
-    sTime++;
+    uint32_t primask = DisableGlobalIRQ();
+    bool     fired   = false;
+
+    if (PIT_GetStatusFlags(PIT, kPIT_Chnl_1) & kPIT_TimerFlag)
+    {
+        fired = alarmReload();
+    }
+
+    EnableGlobalIRQ(primask);
+
+    if (fired)
+    {
+        PlatformEventSignalPending();
+    }
 }
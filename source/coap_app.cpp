@@ -0,0 +1,381 @@
+/*
+ * coap_app.cpp
+ *
+ *  Typed CoAP resources for the demo application.
+ */
+
+#include "coap_app.h"
+
+#include <string.h>
+
+#include <openthread/error.h>
+#include <openthread/message.h>
+#include <openthread/platform/logging.h>
+
+#include "common/code_utils.hpp"
+#include "common/logging.hpp"
+
+static bool coapAppMatch(const char *aData, uint8_t aLength, const char *aText)
+{
+	size_t length = strlen(aText);
+
+	return aLength == length && memcmp(aData, aText, length) == 0;
+}
+
+static uint16_t coapAppReadFormat(otMessage *aMessage, const otCoapOption *aOption)
+{
+	uint8_t value[2];
+
+	// content formats are at most two bytes long, anything longer is unsupported
+	if (aOption->mLength > sizeof(value) || otCoapMessageGetOptionValue(aMessage, value) != OT_ERROR_NONE)
+	{
+		return UINT16_MAX;
+	}
+
+	return (aOption->mLength == 0) ? 0 : (aOption->mLength == 1) ? value[0] : (uint16_t)((value[0] << 8) | value[1]);
+}
+
+static coapAppParam_t *coapAppAddParam(coapAppRequest_t *aRequest, const char *aKey, uint8_t aKeyLength)
+{
+	coapAppParam_t *param;
+
+	if (aRequest->paramCount == COAP_APP_MAX_QUERY_PARAMS)
+	{
+		return NULL;
+	}
+
+	param = &aRequest->params[aRequest->paramCount++];
+	memset(param, 0, sizeof(*param));
+	param->key = aKey;
+	param->keyLength = aKeyLength;
+
+	return param;
+}
+
+static otCoapCode coapAppParseSenml(otMessage *aMessage, coapAppRequest_t *aRequest, char *aCursor)
+{
+	uint16_t length = otMessageGetLength(aMessage) - otMessageGetOffset(aMessage);
+	const char *end = aRequest->buffer + sizeof(aRequest->buffer);
+	senmlReader_t reader;
+	senmlRecord_t record;
+	coapAppParam_t *param;
+
+	if (length > sizeof(aRequest->payload))
+	{
+		return OT_COAP_CODE_REQUEST_TOO_LARGE;
+	}
+
+	otMessageRead(aMessage, otMessageGetOffset(aMessage), aRequest->payload, length);
+
+	if (!senmlReaderInit(&reader, aRequest->payload, length))
+	{
+		return OT_COAP_CODE_BAD_REQUEST;
+	}
+
+	while (senmlReadRecord(&reader, &record))
+	{
+		if (record.baseNameLength == 0)
+		{
+			param = coapAppAddParam(aRequest, record.name, record.nameLength);
+		}
+		else if (record.baseNameLength + record.nameLength <= end - aCursor)
+		{
+			// only a base name forces a copy, the full name is base name + name
+			memcpy(aCursor, record.baseName, record.baseNameLength);
+			memcpy(aCursor + record.baseNameLength, record.name, record.nameLength);
+			param = coapAppAddParam(aRequest, aCursor, (uint8_t)(record.baseNameLength + record.nameLength));
+			aCursor += record.baseNameLength + record.nameLength;
+		}
+		else
+		{
+			param = NULL;
+		}
+
+		if (param == NULL)
+		{
+			return OT_COAP_CODE_REQUEST_TOO_LARGE;
+		}
+
+		if (record.valueType == senmlValue_String)
+		{
+			param->value = record.stringValue;
+			param->valueLength = record.stringValueLength;
+		}
+		else if (record.valueType != senmlValue_None)
+		{
+			param->numeric = true;
+			param->number = record.value;
+		}
+	}
+
+	return reader.valid ? OT_COAP_CODE_EMPTY : OT_COAP_CODE_BAD_REQUEST;
+}
+
+static otCoapCode coapAppParseRequest(const coapAppResource_t *aResource, otMessage *aMessage,
+                                      coapAppRequest_t *aRequest)
+{
+	const otCoapOption *option;
+	char *cursor = aRequest->buffer;
+	const char *sep;
+	coapAppParam_t *param;
+	uint16_t contentFormat = OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN;
+
+	aRequest->code = otCoapMessageGetCode(aMessage);
+	aRequest->accept = OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN;
+	aRequest->paramCount = 0;
+
+	for (option = otCoapMessageGetFirstOption(aMessage); option != NULL;
+	     option = otCoapMessageGetNextOption(aMessage))
+	{
+		if (option->mNumber == OT_COAP_OPTION_ACCEPT)
+		{
+			aRequest->accept = coapAppReadFormat(aMessage, option);
+			continue;
+		}
+
+		if (option->mNumber == OT_COAP_OPTION_CONTENT_FORMAT)
+		{
+			contentFormat = coapAppReadFormat(aMessage, option);
+			continue;
+		}
+
+		if (option->mNumber != OT_COAP_OPTION_URI_QUERY ||
+		    option->mLength > sizeof(aRequest->buffer) - (size_t)(cursor - aRequest->buffer))
+		{
+			continue;
+		}
+
+		// one read per option into the shared buffer, the views below never copy again
+		if (otCoapMessageGetOptionValue(aMessage, cursor) != OT_ERROR_NONE)
+		{
+			continue;
+		}
+
+		sep = (const char *)memchr(cursor, '=', option->mLength);
+		param = coapAppAddParam(aRequest, cursor, (uint8_t)((sep != NULL) ? sep - cursor : option->mLength));
+
+		if (param == NULL)
+		{
+			continue;
+		}
+
+		if (sep != NULL)
+		{
+			param->value = sep + 1;
+			param->valueLength = (uint8_t)(option->mLength - param->keyLength - 1);
+		}
+
+		cursor += option->mLength;
+	}
+
+	if (aRequest->code == OT_COAP_CODE_GET)
+	{
+		// the Accept option only matters for the representation sent back
+		if (aRequest->accept != OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN &&
+		    (aRequest->accept != OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR || !aResource->senml))
+		{
+			return OT_COAP_CODE_NOT_ACCEPTABLE;
+		}
+
+		return OT_COAP_CODE_EMPTY;
+	}
+
+	switch (contentFormat)
+	{
+	case OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN:
+		// text bodies were never interpreted, the query carries the arguments
+		return OT_COAP_CODE_EMPTY;
+
+	case OT_COAP_OPTION_CONTENT_FORMAT_SENML_CBOR:
+		return aResource->senml ? coapAppParseSenml(aMessage, aRequest, cursor) : OT_COAP_CODE_UNSUPPORTED_FORMAT;
+
+	default:
+		return OT_COAP_CODE_UNSUPPORTED_FORMAT;
+	}
+}
+
+static void coapAppHandleRequest(void *aContext, otMessage *aMessage, const otMessageInfo *aMessageInfo)
+{
+	coapAppResource_t *resource = (coapAppResource_t *)aContext;
+	coapAppRequest_t request;
+	coapAppResponse_t response;
+	otMessage *message = NULL;
+	otError error = OT_ERROR_NONE;
+	bool confirmable = otCoapMessageGetType(aMessage) == OT_COAP_TYPE_CONFIRMABLE;
+	bool isGet;
+	otCoapCode code;
+
+	code = coapAppParseRequest(resource, aMessage, &request);
+	isGet = request.code == OT_COAP_CODE_GET;
+
+	if (code == OT_COAP_CODE_EMPTY)
+	{
+		coapAppResponseInit(&response, isGet ? request.accept : OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN);
+		response.code = isGet ? OT_COAP_CODE_CONTENT : OT_COAP_CODE_VALID;
+		resource->handler(&request, &response);
+	}
+	else
+	{
+		coapAppResponseInit(&response, OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN);
+		response.code = code;
+	}
+
+	// non-confirmable requests other than GET are not answered
+	VerifyOrExit(confirmable || isGet);
+
+	message = otCoapNewMessage(resource->instance, NULL);
+	VerifyOrExit(message != NULL, error = OT_ERROR_NO_BUFS);
+
+	if (confirmable)
+	{
+		otCoapMessageInit(message, OT_COAP_TYPE_ACKNOWLEDGMENT, response.code);
+		otCoapMessageSetMessageId(message, otCoapMessageGetMessageId(aMessage));
+	}
+	else
+	{
+		otCoapMessageInit(message, OT_COAP_TYPE_NON_CONFIRMABLE, response.code);
+	}
+
+	otCoapMessageSetToken(message, otCoapMessageGetToken(aMessage), otCoapMessageGetTokenLength(aMessage));
+
+	if (isGet && response.code == OT_COAP_CODE_CONTENT)
+	{
+		if (resource->observable)
+		{
+			otCoapProcessObserveRequest(resource->instance, &resource->resource, aMessage, aMessageInfo, message);
+		}
+
+		if (response.format != OT_COAP_OPTION_CONTENT_FORMAT_TEXT_PLAIN)
+		{
+			SuccessOrExit(error = otCoapMessageAppendContentFormatOption(
+			                  message, (otCoapOptionContentFormat)response.format));
+		}
+
+		if (response.length > 0)
+		{
+			SuccessOrExit(error = otCoapMessageSetPayloadMarker(message));
+			SuccessOrExit(error = otMessageAppend(message, response.payload, response.length));
+		}
+	}
+
+	SuccessOrExit(error = otCoapSendResponse(resource->instance, message, aMessageInfo));
+
+exit:
+
+	if (error != OT_ERROR_NONE && message != NULL)
+	{
+		otLogInfoPlat("coap send response error %d: %s\r\n", error, otThreadErrorToString(error));
+		otMessageFree(message);
+	}
+}
+
+otError coapAppResourceAdd(otInstance *aInstance, coapAppResource_t *aResource, const char *aUriPath,
+                           coapAppHandler_t aHandler, bool aObservable, bool aSenml)
+{
+	memset(&aResource->resource, 0, sizeof(aResource->resource));
+	aResource->resource.mUriPath = aUriPath;
+	aResource->resource.mHandler = &coapAppHandleRequest;
+	aResource->resource.mContext = aResource;
+	aResource->handler = aHandler;
+	aResource->instance = aInstance;
+	aResource->observable = aObservable;
+	aResource->senml = aSenml;
+
+	return otCoapAddResource(aInstance, &aResource->resource);
+}
+
+otError coapAppResourceNotify(coapAppResource_t *aResource, const coapAppResponse_t *aContent)
+{
+	return otCoapNotifyObservers(aResource->instance, &aResource->resource, aContent->format, aContent->payload,
+	                             aContent->length);
+}
+
+bool coapAppParamIs(const coapAppParam_t *aParam, const char *aKey)
+{
+	return coapAppMatch(aParam->key, aParam->keyLength, aKey);
+}
+
+bool coapAppParamValueIs(const coapAppParam_t *aParam, const char *aValue)
+{
+	return aParam->value != NULL && coapAppMatch(aParam->value, aParam->valueLength, aValue);
+}
+
+bool coapAppParamGetUint(const coapAppParam_t *aParam, uint32_t *aValue)
+{
+	uint32_t value = 0;
+	uint8_t i;
+
+	if (aParam->numeric)
+	{
+		*aValue = (uint32_t)aParam->number;
+		return aParam->number >= 0;
+	}
+
+	if (aParam->value == NULL)
+	{
+		return false;
+	}
+
+	for (i = 0; i < aParam->valueLength && aParam->value[i] >= '0' && aParam->value[i] <= '9'; i++)
+	{
+		value = value * 10 + (uint32_t)(aParam->value[i] - '0');
+	}
+
+	*aValue = value;
+	return i > 0;
+}
+
+void coapAppResponseInit(coapAppResponse_t *aResponse, uint16_t aFormat)
+{
+	aResponse->code = OT_COAP_CODE_CONTENT;
+	aResponse->format = aFormat;
+	aResponse->length = 0;
+}
+
+void coapAppWrite(coapAppResponse_t *aResponse, const char *aText)
+{
+	size_t length = strlen(aText);
+
+	if (length > sizeof(aResponse->payload) - aResponse->length)
+	{
+		length = sizeof(aResponse->payload) - aResponse->length;
+	}
+
+	memcpy(&aResponse->payload[aResponse->length], aText, length);
+	aResponse->length += (uint8_t)length;
+}
+
+void coapAppWriteUint(coapAppResponse_t *aResponse, uint32_t aValue)
+{
+	char digits[11];
+	char *cursor = &digits[sizeof(digits) - 1];
+
+	*cursor = '\0';
+
+	do
+	{
+		*--cursor = (char)('0' + aValue % 10);
+		aValue /= 10;
+	} while (aValue != 0);
+
+	coapAppWrite(aResponse, cursor);
+}
+
+void coapAppSenmlBegin(coapAppResponse_t *aResponse, senmlWriter_t *aWriter, uint8_t aRecordCount)
+{
+	senmlWriterInit(aWriter, aResponse->payload, sizeof(aResponse->payload), aRecordCount);
+}
+
+void coapAppSenmlEnd(coapAppResponse_t *aResponse, const senmlWriter_t *aWriter)
+{
+	// a truncated CBOR item would be unreadable, so an overflow sends no payload at all
+	if (senmlWriterIsValid(aWriter))
+	{
+		aResponse->length = (uint8_t)aWriter->length;
+	}
+	else
+	{
+		aResponse->code = OT_COAP_CODE_INTERNAL_ERROR;
+		aResponse->length = 0;
+	}
+}
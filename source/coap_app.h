@@ -0,0 +1,82 @@
+/*
+ * coap_app.h
+ *
+ *  Typed CoAP resources for the demo application: the request query is
+ *  parsed once into a key/value view, handlers only fill a response writer
+ *  and the piggybacked answer is built by shared code.
+ *
+ *  Responses are text/plain unless the request asks for SenML+CBOR with an
+ *  Accept option; SenML+CBOR request payloads are decoded into the same
+ *  key/value view as the query, keyed by the record names. Both only apply to
+ *  resources added with SenML support, the others answer 4.06 and 4.15.
+ */
+
+#ifndef COAP_APP_H_
+#define COAP_APP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <openthread/coap.h>
+
+#include "senml.h"
+
+#define COAP_APP_MAX_QUERY_PARAMS 4
+#define COAP_APP_QUERY_BUFFER_SIZE 48 /* all Uri-Query options of one request */
+#define COAP_APP_MAX_PAYLOAD 64       /* keeps a response inside one 802.15.4 frame */
+
+/* One Uri-Query option split at '=', or one SenML record; views point into the request. */
+typedef struct
+{
+	const char *key;
+	const char *value; /* NULL for a bare "key" without '=' and for numeric records */
+	uint8_t keyLength;
+	uint8_t valueLength;
+	bool numeric; /* a SenML number or bool (1/0) is held in number */
+	int32_t number;
+} coapAppParam_t;
+
+typedef struct
+{
+	otCoapCode code;
+	uint16_t accept; /* text/plain when the request has no Accept option */
+	uint8_t paramCount;
+	coapAppParam_t params[COAP_APP_MAX_QUERY_PARAMS];
+	char buffer[COAP_APP_QUERY_BUFFER_SIZE];
+	uint8_t payload[COAP_APP_MAX_PAYLOAD];
+} coapAppRequest_t;
+
+typedef struct
+{
+	otCoapCode code;  /* preset to 2.05 for GET and 2.03 otherwise */
+	uint16_t format;  /* content format to write, the negotiated Accept for GET */
+	uint8_t length;
+	uint8_t payload[COAP_APP_MAX_PAYLOAD];
+} coapAppResponse_t;
+
+typedef void (*coapAppHandler_t)(const coapAppRequest_t *aRequest, coapAppResponse_t *aResponse);
+
+typedef struct
+{
+	otCoapResource resource;
+	coapAppHandler_t handler;
+	otInstance *instance;
+	bool observable;
+	bool senml; /* the handler writes and reads SenML+CBOR as well as text */
+} coapAppResource_t;
+
+otError coapAppResourceAdd(otInstance *aInstance, coapAppResource_t *aResource, const char *aUriPath,
+                           coapAppHandler_t aHandler, bool aObservable, bool aSenml);
+otError coapAppResourceNotify(coapAppResource_t *aResource, const coapAppResponse_t *aContent);
+
+bool coapAppParamIs(const coapAppParam_t *aParam, const char *aKey);
+bool coapAppParamValueIs(const coapAppParam_t *aParam, const char *aValue);
+bool coapAppParamGetUint(const coapAppParam_t *aParam, uint32_t *aValue);
+
+void coapAppResponseInit(coapAppResponse_t *aResponse, uint16_t aFormat);
+void coapAppWrite(coapAppResponse_t *aResponse, const char *aText);
+void coapAppWriteUint(coapAppResponse_t *aResponse, uint32_t aValue);
+void coapAppSenmlBegin(coapAppResponse_t *aResponse, senmlWriter_t *aWriter, uint8_t aRecordCount);
+void coapAppSenmlEnd(coapAppResponse_t *aResponse, const senmlWriter_t *aWriter);
+
+#endif /* COAP_APP_H_ */
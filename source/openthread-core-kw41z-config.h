@@ -122,6 +122,24 @@
  */
 #define RADIO_CONFIG_SRC_MATCH_ENTRY_NUM                        128
 
+/**
+ * @def RADIO_CONFIG_RX_FRAME_NUM
+ *
+ * The number of received frames buffered between the radio interrupt and the driver processing.
+ * Must be a power of two.
+ *
+ */
+#define RADIO_CONFIG_RX_FRAME_NUM                               4
+
+/**
+ * @def RADIO_CONFIG_RX_WORD_COPY
+ *
+ * Define to 1 to copy received frames out of the radio packet buffer one word at a time.
+ * Define to 0 to fall back to byte copies.
+ *
+ */
+#define RADIO_CONFIG_RX_WORD_COPY                               1
+
 /**
  * @def OPENTHREAD_CONFIG_ENABLE_SOFTWARE_RETRANSMIT
  *
@@ -130,4 +148,12 @@
  */
 #define OPENTHREAD_CONFIG_ENABLE_SOFTWARE_RETRANSMIT            1
 
+/**
+ * @def OPENTHREAD_CONFIG_ENABLE_PLATFORM_USEC_TIMER
+ *
+ * Define to 1 if you want to enable microsecond backoff timer implemented in platform.
+ *
+ */
+#define OPENTHREAD_CONFIG_ENABLE_PLATFORM_USEC_TIMER            1
+
 #endif  // OPENTHREAD_CORE_KW41Z_CONFIG_H_
@@ -41,6 +41,11 @@
 
 #include "openthread/error.h"
 #include "openthread/instance.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * This function initializes the alarm service used by OpenThread.
  *
@@ -69,6 +74,32 @@ void kw41zRadioInit(void);
  */
 void kw41zRadioProcess(otInstance *aInstance);
 
+/**
+ * This structure represents the radio receive counters.
+ *
+ */
+typedef struct kw41zRadioRxStats
+{
+    uint32_t mReceived;   ///< Number of frames queued to the RX frame ring.
+    uint32_t mDropped;    ///< Number of frames dropped because the RX frame ring was full.
+    uint32_t mInvalid;    ///< Number of frames dropped because of an invalid length.
+    uint8_t  mMaxPending; ///< Maximum number of frames waiting in the RX frame ring.
+} kw41zRadioRxStats;
+
+/**
+ * This function gets the radio receive counters.
+ *
+ * @param[out]  aStats  A pointer to the counters.
+ *
+ */
+void kw41zRadioGetRxStats(kw41zRadioRxStats *aStats);
+
+/**
+ * This function resets the radio receive counters.
+ *
+ */
+void kw41zRadioResetRxStats(void);
+
 /**
  * This function initializes the random number service used by OpenThread.
  *
@@ -93,4 +124,14 @@ void kw41zLogInit(void);
  */
 void kw41zLogDeinit(void);
 
+/**
+ * This function initializes the LPTMR used by the FreeRTOS tickless idle mode.
+ *
+ */
+void kw41zLowPowerTimerInit(void);
+
+#ifdef __cplusplus
+} // end of extern "C"
+#endif
+
 #endif  // PLATFORM_KW41Z_H_
@@ -37,9 +37,22 @@
 #include "fsl_device_registers.h"
 #include "fsl_port.h"
 #include "platform-kw41z.h"
+#include "platform.h"
 #include <stdint.h>
 #include "openthread/platform/uart.h"
 #include "openthread/error.h"
+#include "openthread/tasklet.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if configUSE_TICKLESS_IDLE
+#include "fsl_lptmr.h"
+
+extern void vPortLptmrIsr(void);
+#endif
+
+static TaskHandle_t sMainTask = NULL;
 
 
 void PlatformInit(int argc, char *argv[])
@@ -98,6 +111,12 @@ void PlatformInit(int argc, char *argv[])
 
     otPlatUartEnable();
 
+#if configUSE_TICKLESS_IDLE
+    kw41zLowPowerTimerInit();
+#endif
+
+    sMainTask = xTaskGetCurrentTaskHandle();
+
     (void)argc;
     (void)argv;
 }
@@ -122,6 +141,64 @@ void PlatformProcessDrivers(otInstance *aInstance)
     kw41zAlarmProcess(aInstance);
 }
 
+void PlatformEventSignalPending(void)
+{
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+    if (sMainTask == NULL)
+    {
+        return;
+    }
+
+    if (__get_IPSR() != 0)
+    {
+        vTaskNotifyGiveFromISR(sMainTask, &higherPriorityTaskWoken);
+        portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    }
+    else
+    {
+        xTaskNotifyGive(sMainTask);
+    }
+}
+
+void PlatformEventWait(uint32_t aTimeout)
+{
+    (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(aTimeout));
+}
+
+void otTaskletsSignalPending(otInstance *aInstance)
+{
+    (void)aInstance;
+    PlatformEventSignalPending();
+}
+
+#if configUSE_TICKLESS_IDLE
+void kw41zLowPowerTimerInit(void)
+{
+    lptmr_config_t config;
+
+    /* Default configuration runs LPTMR from the 1 kHz LPO, see configLPTMR_CLOCK_HZ */
+    LPTMR_GetDefaultConfig(&config);
+    LPTMR_Init(LPTMR0, &config);
+    LPTMR_EnableInterrupts(LPTMR0, kLPTMR_TimerInterruptEnable);
+}
+
+LPTMR_Type *vPortGetLptrmBase(void)
+{
+    return LPTMR0;
+}
+
+IRQn_Type vPortGetLptmrIrqn(void)
+{
+    return LPTMR0_IRQn;
+}
+
+void LPTMR0_IRQHandler(void)
+{
+    vPortLptmrIsr();
+}
+#endif
+
 void NMI_Handler(void)
 {
     /* Change NMI Pin MUX */
@@ -35,7 +35,10 @@
 #ifndef PLATFORM_H_
 #define PLATFORM_H_
 
+#include <stdint.h>
+
 #include <openthread/error.h>
+#include <openthread/instance.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -72,9 +75,23 @@ void PlatformProcessDrivers(otInstance *aInstance);
 /**
  * This function is called whenever platform drivers needs processing.
  *
+ * It may be called both from thread and from interrupt context and wakes up
+ * the task blocked in PlatformEventWait().
+ *
  */
 extern void PlatformEventSignalPending(void);
 
+/**
+ * This function blocks the calling task until a platform event is signaled
+ * with PlatformEventSignalPending() or until the timeout expires.
+ *
+ * The calling task must be the one that called PlatformInit().
+ *
+ * @param[in]  aTimeout  The maximum time to wait in milliseconds.
+ *
+ */
+void PlatformEventWait(uint32_t aTimeout);
+
 #ifdef __cplusplus
 } // end of extern "C"
 #endif
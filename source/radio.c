@@ -32,6 +32,7 @@
  *
  */
 
+#include "fsl_common.h"
 #include "fsl_device_registers.h"
 #include "fsl_xcvr.h"
 #include "openthread-core-kw41z-config.h"
@@ -39,12 +40,18 @@
 #include <string.h>
 
 #include <utils/code_utils.h>
+#include <openthread/platform/alarm-micro.h>
 #include <openthread/platform/alarm-milli.h>
 #include <openthread/platform/diag.h>
 #include <openthread/platform/radio.h>
+#include <openthread/platform/time.h>
+
+#include "platform-kw41z.h"
+#include "platform.h"
 
 // clang-format off
 #define DOUBLE_BUFFERING             (1)
+#define RX_BUFFER_WORDS              ((OT_RADIO_FRAME_MAX_SIZE + 3) / 4)
 #define DEFAULT_CHANNEL              (11)
 #define DEFAULT_CCA_MODE             (XCVR_CCA_MODE1_c)
 #define IEEE802154_ACK_REQUEST       (1 << 5)
@@ -63,6 +70,11 @@
                                       ZLL_IRQSTS_TMR2MSK_MASK | \
                                       ZLL_IRQSTS_TMR3MSK_MASK | \
                                       ZLL_IRQSTS_TMR4MSK_MASK )
+#define EVENT_TMR_MASK               (0xFFFFFF)
+#define EVENT_TMR_US_SHIFT           (4)  /* event timer runs at 1 symbol (16us) */
+#define EVENT_TMR_WRAP_US_SHIFT      (24 + EVENT_TMR_US_SHIFT)
+#define EVENT_TMR_MAX_DELAY          (EVENT_TMR_MASK >> 1)
+#define XTAL_ACCURACY_PPM            (40)
 #define ZLL_DEFAULT_RX_FILTERING     (ZLL_RX_FRAME_FILTER_FRM_VER_FILTER(3) | \
                                       ZLL_RX_FRAME_FILTER_CMD_FT_MASK | \
                                       ZLL_RX_FRAME_FILTER_DATA_FT_MASK | \
@@ -70,6 +82,14 @@
                                       ZLL_RX_FRAME_FILTER_BEACON_FT_MASK)
 // clang-format on
 
+#if (RADIO_CONFIG_RX_FRAME_NUM & (RADIO_CONFIG_RX_FRAME_NUM - 1)) || (RADIO_CONFIG_RX_FRAME_NUM > 128)
+#error "RADIO_CONFIG_RX_FRAME_NUM must be a power of two not greater than 128"
+#endif
+
+#if !DOUBLE_BUFFERING && (RADIO_CONFIG_RX_FRAME_NUM > 1)
+#error "RX frame ring requires DOUBLE_BUFFERING"
+#endif
+
 typedef enum xcvr_state_tag
 {
     XCVR_Idle_c,
@@ -97,18 +117,35 @@ static int8_t       sAutoTxPwrLevel = 0;
 
 /* ISR Signaling Flags */
 static bool    sTxDone     = false;
-static bool    sRxDone     = false;
 static bool    sEdScanDone = false;
 static otError sTxStatus;
 
-static otRadioFrame sTxFrame;
-static otRadioFrame sRxFrame;
-static uint8_t      sTxData[OT_RADIO_FRAME_MAX_SIZE];
+/* RX frame ring, filled by Radio_1_IRQHandler and drained by kw41zRadioProcess */
+static volatile uint8_t  sRxHead = 0; /* written by kw41zRadioProcess only */
+static volatile uint8_t  sRxTail = 0; /* written by Radio_1_IRQHandler only */
+static kw41zRadioRxStats sRxStats;
+
+static otRadioFrame  sTxFrame;
+static otRadioFrame  sAckFrame;
+static otRadioFrame  sRxFrame[RADIO_CONFIG_RX_FRAME_NUM];
+static otRadioIeInfo sTxIeInfo;
+static otRadioIeInfo sAckIeInfo;
+static otRadioIeInfo sRxIeInfo[RADIO_CONFIG_RX_FRAME_NUM];
+static uint8_t       sTxData[OT_RADIO_FRAME_MAX_SIZE];
 #if DOUBLE_BUFFERING
-static uint8_t sRxData[OT_RADIO_FRAME_MAX_SIZE];
+/* Word arrays keep every PSDU word aligned for rf_copy_rx_frame() */
+static uint32_t sAckData[RX_BUFFER_WORDS];
+static uint32_t sRxData[RADIO_CONFIG_RX_FRAME_NUM][RX_BUFFER_WORDS];
 #endif
 static otInstance *sInstance = NULL;
 
+/* Microsecond timebase, extended from the 24-bit event timer */
+static uint32_t      sEventTmrEpoch     = 0;
+static uint32_t      sEventTmrLast      = 0;
+static uint32_t      sAlarmMicroTime    = 0;
+static volatile bool sAlarmMicroPending = false;
+static volatile bool sAlarmMicroFired   = false;
+
 /* Private functions */
 static void         rf_abort(void);
 static xcvr_state_t rf_get_state(void);
@@ -117,12 +154,17 @@ static void         rf_set_tx_power(int8_t tx_power);
 static uint8_t      rf_lqi_adjust(uint8_t hwLqi);
 static int8_t       rf_lqi_to_rssi(uint8_t lqi);
 static uint32_t     rf_get_timestamp(void);
+static uint64_t     rf_timestamp_to_us(uint32_t timestamp);
 static void         rf_set_timeout(uint32_t abs_timeout);
+static bool         rf_alarm_micro_update(void);
 static uint16_t     rf_get_addr_checksum(uint8_t *pAddr, bool ExtendedAddr, uint16_t PanId);
 static otError      rf_add_addr_table_entry(uint16_t checksum, bool extendedAddr);
 static otError      rf_remove_addr_table_entry(uint16_t checksum);
 static otError      rf_remove_addr_table_entry_index(uint8_t index);
-static bool         rf_process_rx_frame(void);
+static bool         rf_process_rx_frame(otRadioFrame *aFrame);
+#if DOUBLE_BUFFERING
+static void         rf_copy_rx_frame(uint8_t *aPsdu, uint8_t aLength);
+#endif
 
 otRadioState otPlatRadioGetState(otInstance *aInstance)
 {
@@ -190,8 +232,6 @@ otError otPlatRadioEnable(otInstance *aInstance)
 
     sInstance = aInstance;
     ZLL->PHY_CTRL &= ~ZLL_PHY_CTRL_TRCV_MSK_MASK;
-    NVIC_ClearPendingIRQ(Radio_1_IRQn);
-    NVIC_EnableIRQ(Radio_1_IRQn);
 
     sState = OT_RADIO_STATE_SLEEP;
 
@@ -203,7 +243,7 @@ otError otPlatRadioDisable(otInstance *aInstance)
 {
     otEXPECT(otPlatRadioIsEnabled(aInstance));
 
-    NVIC_DisableIRQ(Radio_1_IRQn);
+    /* Radio IRQ stays enabled, it also serves the microsecond alarm */
     rf_abort();
     sState = OT_RADIO_STATE_DISABLED;
 
@@ -252,7 +292,6 @@ otError otPlatRadioReceive(otInstance *aInstance, uint8_t aChannel)
         /* Set Power level for auto TX */
         rf_set_tx_power(sAutoTxPwrLevel);
         rf_set_channel(aChannel);
-        sRxFrame.mChannel = aChannel;
 
         /* Filter ACK frames during RX sequence */
         ZLL->RX_FRAME_FILTER &= ~(ZLL_RX_FRAME_FILTER_ACK_FT_MASK);
@@ -759,10 +798,84 @@ static void rf_set_timeout(uint32_t abs_timeout)
     ZLL->PHY_CTRL |= ZLL_PHY_CTRL_TMR3CMP_EN_MASK;
 }
 
-static bool rf_process_rx_frame(void)
+/* Converts an event timer value from the recent past to microseconds. Must be called with interrupts disabled. */
+static uint64_t rf_timestamp_to_us(uint32_t timestamp)
+{
+    uint32_t now   = rf_get_timestamp() & EVENT_TMR_MASK;
+    uint32_t epoch;
+
+    if (now < sEventTmrLast)
+    {
+        sEventTmrEpoch++;
+    }
+
+    sEventTmrLast = now;
+    epoch         = sEventTmrEpoch;
+    timestamp &= EVENT_TMR_MASK;
+
+    /* Timestamp was captured before the last wrap of the event timer */
+    if (timestamp > now)
+    {
+        epoch--;
+    }
+
+    return ((uint64_t)epoch << EVENT_TMR_WRAP_US_SHIFT) | ((uint64_t)timestamp << EVENT_TMR_US_SHIFT);
+}
+
+/*
+ * Programs TMR1 for the next microsecond alarm. Must be called with interrupts disabled. Returns true when the
+ * alarm fired; the caller signals the main task, outside of any masked region when running in task context.
+ */
+static bool rf_alarm_micro_update(void)
+{
+    uint32_t now   = (uint32_t)rf_timestamp_to_us(rf_get_timestamp());
+    uint32_t delay = EVENT_TMR_MAX_DELAY;
+    uint32_t irqSts;
+    int32_t  remaining;
+    bool     fired = false;
+
+    if (sAlarmMicroPending)
+    {
+        remaining = (int32_t)(sAlarmMicroTime - now);
+
+        if (remaining <= 0)
+        {
+            sAlarmMicroPending = false;
+            sAlarmMicroFired   = true;
+            fired              = true;
+        }
+        else if (((uint32_t)remaining >> EVENT_TMR_US_SHIFT) < delay)
+        {
+            delay = ((uint32_t)remaining + (1 << EVENT_TMR_US_SHIFT) - 1) >> EVENT_TMR_US_SHIFT;
+        }
+    }
+
+    /* TMR1 fires at least twice per event timer period even without an alarm, so no wrap is missed */
+    ZLL->PHY_CTRL &= ~ZLL_PHY_CTRL_TMR1CMP_EN_MASK;
+    ZLL->T1CMP = (sEventTmrLast + delay) & EVENT_TMR_MASK;
+    irqSts     = ZLL->IRQSTS & ZLL_IRQSTS_TMR_ALL_MSK_MASK;
+    irqSts &= ~ZLL_IRQSTS_TMR1MSK_MASK;
+    irqSts |= ZLL_IRQSTS_TMR1IRQ_MASK;
+    ZLL->IRQSTS = irqSts;
+    ZLL->PHY_CTRL |= ZLL_PHY_CTRL_TMR1CMP_EN_MASK;
+
+    /* The compare value may have passed while TMR1 was being programmed */
+    if (sAlarmMicroPending && ((int32_t)(sAlarmMicroTime - (uint32_t)rf_timestamp_to_us(rf_get_timestamp())) <= 0))
+    {
+        sAlarmMicroPending = false;
+        sAlarmMicroFired   = true;
+        fired              = true;
+    }
+
+    return fired;
+}
+
+static bool rf_process_rx_frame(otRadioFrame *aFrame)
 {
-    uint8_t temp;
-    bool    status = true;
+    uint8_t  temp;
+    bool     status = true;
+    uint64_t sfdTime;
+    uint32_t age;
 
     /* Get Rx length */
     temp = (ZLL->IRQSTS & ZLL_IRQSTS_RX_FRAME_LENGTH_MASK) >> ZLL_IRQSTS_RX_FRAME_LENGTH_SHIFT;
@@ -770,38 +883,68 @@ static bool rf_process_rx_frame(void)
     /* Check if frame is valid */
     otEXPECT_ACTION((IEEE802154_MIN_LENGTH <= temp) && (temp <= IEEE802154_MAX_LENGTH), status = false);
 
-    if (otPlatRadioGetPromiscuous(sInstance))
-    {
-        // Timestamp
-        sRxFrame.mInfo.mRxInfo.mMsec = otPlatAlarmMilliGetNow();
-        sRxFrame.mInfo.mRxInfo.mUsec = 0; // Don't support microsecond timer for now.
-    }
+    /* SFD timestamp, mMsec/mUsec are based on the millisecond alarm */
+    sfdTime = rf_timestamp_to_us(ZLL->TIMESTAMP);
+    age     = (uint32_t)(rf_timestamp_to_us(rf_get_timestamp()) - sfdTime);
+    aFrame->mIeInfo->mTimestamp = sfdTime;
+    aFrame->mInfo.mRxInfo.mMsec = otPlatAlarmMilliGetNow() - (age / 1000) - ((age % 1000) ? 1 : 0);
+    aFrame->mInfo.mRxInfo.mUsec = (age % 1000) ? (1000 - (age % 1000)) : 0;
 
-    sRxFrame.mLength = temp;
+    aFrame->mLength  = temp;
+    aFrame->mChannel = sChannel;
     temp             = (ZLL->LQI_AND_RSSI & ZLL_LQI_AND_RSSI_LQI_VALUE_MASK) >> ZLL_LQI_AND_RSSI_LQI_VALUE_SHIFT;
-    sRxFrame.mInfo.mRxInfo.mLqi  = rf_lqi_adjust(temp);
-    sRxFrame.mInfo.mRxInfo.mRssi = rf_lqi_to_rssi(sRxFrame.mInfo.mRxInfo.mLqi);
+    aFrame->mInfo.mRxInfo.mLqi  = rf_lqi_adjust(temp);
+    aFrame->mInfo.mRxInfo.mRssi = rf_lqi_to_rssi(aFrame->mInfo.mRxInfo.mLqi);
 #if DOUBLE_BUFFERING
+    rf_copy_rx_frame(aFrame->mPsdu, aFrame->mLength - 2);
+#endif
+
+exit:
+    return status;
+}
+
+#if DOUBLE_BUFFERING
+static void rf_copy_rx_frame(uint8_t *aPsdu, uint8_t aLength)
+{
+#if RADIO_CONFIG_RX_WORD_COPY
+    /* The packet buffer and aPsdu are word aligned, the tail of the last word is don't care */
+    const volatile uint32_t *src   = (const volatile uint32_t *)ZLL->PKT_BUFFER_RX;
+    uint32_t *               dst   = (uint32_t *)aPsdu;
+    uint8_t                  words = (aLength + 3) >> 2;
 
-    for (temp = 0; temp < sRxFrame.mLength - 2; temp++)
+    while (words--)
     {
-        sRxData[temp] = ((uint8_t *)ZLL->PKT_BUFFER_RX)[temp];
+        *dst++ = *src++;
     }
+#else
 
-#endif
+    for (uint8_t i = 0; i < aLength; i++)
+    {
+        aPsdu[i] = ((uint8_t *)ZLL->PKT_BUFFER_RX)[i];
+    }
 
-exit:
-    return status;
+#endif
 }
+#endif
 
 void Radio_1_IRQHandler(void)
 {
     xcvr_state_t state     = rf_get_state();
     uint32_t     irqStatus = ZLL->IRQSTS;
     int8_t       temp;
+    uint8_t      pending;
 
     ZLL->IRQSTS = irqStatus;
 
+    /* TMR1 IRQ - microsecond alarm */
+    if ((irqStatus & ZLL_IRQSTS_TMR1IRQ_MASK) && (!(irqStatus & ZLL_IRQSTS_TMR1MSK_MASK)))
+    {
+        if (rf_alarm_micro_update())
+        {
+            PlatformEventSignalPending();
+        }
+    }
+
     /* TMR3 IRQ - time-out */
     if ((irqStatus & ZLL_IRQSTS_TMR3IRQ_MASK) && (!(irqStatus & ZLL_IRQSTS_TMR3MSK_MASK)))
     {
@@ -833,7 +976,27 @@ void Radio_1_IRQHandler(void)
         switch (state)
         {
         case XCVR_RX_c:
-            sRxDone = rf_process_rx_frame();
+            pending = (uint8_t)(sRxTail - sRxHead);
+
+            if (pending >= RADIO_CONFIG_RX_FRAME_NUM)
+            {
+                sRxStats.mDropped++;
+            }
+            else if (rf_process_rx_frame(&sRxFrame[sRxTail % RADIO_CONFIG_RX_FRAME_NUM]))
+            {
+                sRxTail++;
+                sRxStats.mReceived++;
+
+                if (pending + 1 > sRxStats.mMaxPending)
+                {
+                    sRxStats.mMaxPending = pending + 1;
+                }
+            }
+            else
+            {
+                sRxStats.mInvalid++;
+            }
+
             break;
 
         case XCVR_TR_c:
@@ -845,14 +1008,22 @@ void Radio_1_IRQHandler(void)
             {
                 sTxStatus = OT_ERROR_CHANNEL_ACCESS_FAILURE;
             }
-            else if (!(irqStatus & ZLL_IRQSTS_RXIRQ_MASK) || (rf_process_rx_frame() == false) ||
-                     (sRxFrame.mLength != IEEE802154_ACK_LENGTH) ||
-                     ((sRxFrame.mPsdu[IEEE802154_FRM_CTL_LO_OFFSET] & IEEE802154_FRM_TYPE_MASK) !=
+            else if (!(irqStatus & ZLL_IRQSTS_RXIRQ_MASK) || (rf_process_rx_frame(&sAckFrame) == false) ||
+                     (sAckFrame.mLength != IEEE802154_ACK_LENGTH) ||
+                     ((sAckFrame.mPsdu[IEEE802154_FRM_CTL_LO_OFFSET] & IEEE802154_FRM_TYPE_MASK) !=
                       IEEE802154_FRM_TYPE_ACK) ||
-                     (sRxFrame.mPsdu[IEEE802154_DSN_OFFSET] != sTxFrame.mPsdu[IEEE802154_DSN_OFFSET]))
+                     (sAckFrame.mPsdu[IEEE802154_DSN_OFFSET] != sTxFrame.mPsdu[IEEE802154_DSN_OFFSET]))
             {
                 sTxStatus = OT_ERROR_NO_ACK;
             }
+            else
+            {
+                /* Back off from the ACK SFD: turnaround, ACK SHR and the transmitted PHR + PSDU */
+                sTxIeInfo.mTimestamp =
+                    sAckIeInfo.mTimestamp - ((IEEE802154_TURNAROUND_LEN + IEEE802154_PHY_SHR_LEN +
+                                             (1 + sTxFrame.mLength) * OT_RADIO_SYMBOLS_PER_OCTET)
+                                            << EVENT_TMR_US_SHIFT);
+            }
 
             sState  = OT_RADIO_STATE_RECEIVE;
             sTxDone = true;
@@ -863,6 +1034,12 @@ void Radio_1_IRQHandler(void)
             {
                 sTxStatus = OT_ERROR_CHANNEL_ACCESS_FAILURE;
             }
+            else
+            {
+                /* Sequence ends right after the PSDU, back off the transmitted PHR + PSDU */
+                sTxIeInfo.mTimestamp = rf_timestamp_to_us(rf_get_timestamp()) -
+                                       (((1 + sTxFrame.mLength) * OT_RADIO_SYMBOLS_PER_OCTET) << EVENT_TMR_US_SHIFT);
+            }
 
             sState  = OT_RADIO_STATE_RECEIVE;
             sTxDone = true;
@@ -909,6 +1086,11 @@ void Radio_1_IRQHandler(void)
         ZLL->PHY_CTRL |= XCVR_RX_c;
         ZLL->PHY_CTRL &= ~ZLL_PHY_CTRL_SEQMSK_MASK;
     }
+
+    if (sTxDone || (sRxHead != sRxTail) || sEdScanDone)
+    {
+        PlatformEventSignalPending();
+    }
 }
 
 void kw41zRadioInit(void)
@@ -959,23 +1141,53 @@ void kw41zRadioInit(void)
     rf_set_channel(DEFAULT_CHANNEL);
     rf_set_tx_power(0);
 
-    sTxFrame.mLength = 0;
-    sTxFrame.mPsdu   = sTxData;
-    sRxFrame.mLength = 0;
+    sTxFrame.mLength  = 0;
+    sTxFrame.mPsdu    = sTxData;
+    sTxFrame.mIeInfo  = &sTxIeInfo;
+    sAckFrame.mLength = 0;
+    sAckFrame.mIeInfo = &sAckIeInfo;
+#if DOUBLE_BUFFERING
+    sAckFrame.mPsdu = (uint8_t *)sAckData;
+#else
+    sAckFrame.mPsdu = (uint8_t *)ZLL->PKT_BUFFER_RX;
+#endif
+
+    for (uint8_t i = 0; i < RADIO_CONFIG_RX_FRAME_NUM; i++)
+    {
+        sRxFrame[i].mLength = 0;
+        sRxFrame[i].mIeInfo = &sRxIeInfo[i];
 #if DOUBLE_BUFFERING
-    sRxFrame.mPsdu = sRxData;
+        sRxFrame[i].mPsdu = (uint8_t *)sRxData[i];
 #else
-    sRxFrame.mPsdu = (uint8_t *)ZLL->PKT_BUFFER_RX;
+        sRxFrame[i].mPsdu = (uint8_t *)ZLL->PKT_BUFFER_RX;
 #endif
+    }
+
+    /* Unmask the transceiver IRQ now, TMR1 serves the microsecond alarm even while the radio is disabled */
+    ZLL->PHY_CTRL &= ~ZLL_PHY_CTRL_TRCV_MSK_MASK;
+
+    if (rf_alarm_micro_update())
+    {
+        PlatformEventSignalPending();
+    }
+
+    NVIC_ClearPendingIRQ(Radio_1_IRQn);
+    NVIC_EnableIRQ(Radio_1_IRQn);
 }
 
 void kw41zRadioProcess(otInstance *aInstance)
 {
+    if (sAlarmMicroFired)
+    {
+        sAlarmMicroFired = false;
+        otPlatAlarmMicroFired(aInstance);
+    }
+
     if (sTxDone)
     {
         if (sTxFrame.mPsdu[IEEE802154_FRM_CTL_LO_OFFSET] & IEEE802154_ACK_REQUEST)
         {
-            otPlatRadioTxDone(aInstance, &sTxFrame, &sRxFrame, sTxStatus);
+            otPlatRadioTxDone(aInstance, &sTxFrame, &sAckFrame, sTxStatus);
         }
         else
         {
@@ -985,21 +1197,24 @@ void kw41zRadioProcess(otInstance *aInstance)
         sTxDone = false;
     }
 
-    if (sRxDone)
+    /* Drain all frames received since the last call */
+    while (sRxHead != sRxTail)
     {
+        otRadioFrame *frame = &sRxFrame[sRxHead % RADIO_CONFIG_RX_FRAME_NUM];
+
 #if OPENTHREAD_ENABLE_DIAG
 
         if (otPlatDiagModeGet())
         {
-            otPlatDiagRadioReceiveDone(aInstance, &sRxFrame, OT_ERROR_NONE);
+            otPlatDiagRadioReceiveDone(aInstance, frame, OT_ERROR_NONE);
         }
         else
 #endif
         {
-            otPlatRadioReceiveDone(aInstance, &sRxFrame, OT_ERROR_NONE);
+            otPlatRadioReceiveDone(aInstance, frame, OT_ERROR_NONE);
         }
 
-        sRxDone = false;
+        sRxHead++;
     }
 
     if (sEdScanDone)
@@ -1008,3 +1223,70 @@ void kw41zRadioProcess(otInstance *aInstance)
         sEdScanDone = false;
     }
 }
+
+void kw41zRadioGetRxStats(kw41zRadioRxStats *aStats)
+{
+    uint32_t primask = DisableGlobalIRQ();
+
+    *aStats = sRxStats;
+
+    EnableGlobalIRQ(primask);
+}
+
+void kw41zRadioResetRxStats(void)
+{
+    uint32_t primask = DisableGlobalIRQ();
+
+    memset(&sRxStats, 0, sizeof(sRxStats));
+
+    EnableGlobalIRQ(primask);
+}
+
+void otPlatAlarmMicroStartAt(otInstance *aInstance, uint32_t aT0, uint32_t aDt)
+{
+    uint32_t primask = DisableGlobalIRQ();
+    bool     fired;
+
+    OT_UNUSED_VARIABLE(aInstance);
+
+    sAlarmMicroTime    = aT0 + aDt;
+    sAlarmMicroPending = true;
+    sAlarmMicroFired   = false;
+    fired              = rf_alarm_micro_update();
+
+    EnableGlobalIRQ(primask);
+
+    /* Signalling from task context exits a critical section, which would unmask interrupts above */
+    if (fired)
+    {
+        PlatformEventSignalPending();
+    }
+}
+
+void otPlatAlarmMicroStop(otInstance *aInstance)
+{
+    OT_UNUSED_VARIABLE(aInstance);
+
+    sAlarmMicroPending = false;
+    sAlarmMicroFired   = false;
+}
+
+uint32_t otPlatAlarmMicroGetNow(void)
+{
+    return (uint32_t)otPlatTimeGet();
+}
+
+uint64_t otPlatTimeGet(void)
+{
+    uint32_t primask = DisableGlobalIRQ();
+    uint64_t now     = rf_timestamp_to_us(rf_get_timestamp());
+
+    EnableGlobalIRQ(primask);
+
+    return now;
+}
+
+uint16_t otPlatTimeGetXtalAccuracy(void)
+{
+    return XTAL_ACCURACY_PPM;
+}
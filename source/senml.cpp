@@ -0,0 +1,396 @@
+/*
+ * senml.cpp
+ *
+ *  Minimal SenML (RFC 8428) CBOR encoder and decoder for the demo application.
+ */
+
+#include "senml.h"
+
+#include <string.h>
+
+#define CBOR_MAJOR_UINT 0
+#define CBOR_MAJOR_NINT 1
+#define CBOR_MAJOR_BYTES 2
+#define CBOR_MAJOR_TEXT 3
+#define CBOR_MAJOR_ARRAY 4
+#define CBOR_MAJOR_MAP 5
+#define CBOR_MAJOR_SIMPLE 7
+
+#define CBOR_INFO_FALSE 20
+#define CBOR_INFO_TRUE 21
+#define CBOR_INFO_HALF 25
+#define CBOR_INFO_FLOAT 26
+#define CBOR_INFO_DOUBLE 27
+#define CBOR_INFO_INDEFINITE 31
+#define CBOR_BREAK 0xff
+
+//
+// Encoder
+//
+
+static void senmlPut(senmlWriter_t *aWriter, uint8_t aByte)
+{
+	if (aWriter->length < aWriter->size)
+	{
+		aWriter->buffer[aWriter->length] = aByte;
+	}
+
+	aWriter->length++;
+}
+
+static void senmlPutHead(senmlWriter_t *aWriter, uint8_t aMajor, uint32_t aArgument)
+{
+	uint8_t count;
+
+	if (aArgument < 24)
+	{
+		senmlPut(aWriter, (uint8_t)((aMajor << 5) | aArgument));
+		return;
+	}
+
+	// shortest form as required for deterministic CBOR
+	count = (aArgument <= 0xff) ? 1 : (aArgument <= 0xffff) ? 2 : 4;
+	senmlPut(aWriter, (uint8_t)((aMajor << 5) | (count == 1 ? 24 : count == 2 ? 25 : 26)));
+
+	while (count-- > 0)
+	{
+		senmlPut(aWriter, (uint8_t)(aArgument >> (8 * count)));
+	}
+}
+
+static void senmlPutInt(senmlWriter_t *aWriter, int32_t aValue)
+{
+	if (aValue >= 0)
+	{
+		senmlPutHead(aWriter, CBOR_MAJOR_UINT, (uint32_t)aValue);
+	}
+	else
+	{
+		senmlPutHead(aWriter, CBOR_MAJOR_NINT, (uint32_t)(-1 - aValue));
+	}
+}
+
+void senmlWriterInit(senmlWriter_t *aWriter, uint8_t *aBuffer, uint16_t aSize, uint8_t aRecordCount)
+{
+	aWriter->buffer = aBuffer;
+	aWriter->size = aSize;
+	aWriter->length = 0;
+	senmlPutHead(aWriter, CBOR_MAJOR_ARRAY, aRecordCount);
+}
+
+void senmlWriteRecord(senmlWriter_t *aWriter, uint8_t aFieldCount)
+{
+	senmlPutHead(aWriter, CBOR_MAJOR_MAP, aFieldCount);
+}
+
+void senmlWriteText(senmlWriter_t *aWriter, senmlLabel_t aLabel, const char *aText)
+{
+	size_t length = strlen(aText);
+
+	senmlPutInt(aWriter, aLabel);
+	senmlPutHead(aWriter, CBOR_MAJOR_TEXT, (uint32_t)length);
+
+	for (size_t i = 0; i < length; i++)
+	{
+		senmlPut(aWriter, (uint8_t)aText[i]);
+	}
+}
+
+void senmlWriteInt(senmlWriter_t *aWriter, senmlLabel_t aLabel, int32_t aValue)
+{
+	senmlPutInt(aWriter, aLabel);
+	senmlPutInt(aWriter, aValue);
+}
+
+void senmlWriteBool(senmlWriter_t *aWriter, senmlLabel_t aLabel, bool aValue)
+{
+	senmlPutInt(aWriter, aLabel);
+	senmlPut(aWriter, (uint8_t)((CBOR_MAJOR_SIMPLE << 5) | (aValue ? CBOR_INFO_TRUE : CBOR_INFO_FALSE)));
+}
+
+bool senmlWriterIsValid(const senmlWriter_t *aWriter)
+{
+	return aWriter->length <= aWriter->size;
+}
+
+//
+// Decoder
+//
+
+static bool senmlGetHead(senmlReader_t *aReader, uint8_t *aMajor, uint8_t *aInfo, uint64_t *aArgument)
+{
+	uint8_t count;
+
+	if (aReader->offset >= aReader->length)
+	{
+		return false;
+	}
+
+	*aMajor = aReader->data[aReader->offset] >> 5;
+	*aInfo = aReader->data[aReader->offset] & 0x1f;
+	*aArgument = *aInfo;
+	aReader->offset++;
+
+	if (*aInfo < 24 || *aInfo == CBOR_INFO_INDEFINITE)
+	{
+		return true;
+	}
+
+	if (*aInfo > 27)
+	{
+		return false;
+	}
+
+	count = (uint8_t)(1 << (*aInfo - 24));
+
+	if (aReader->length - aReader->offset < count)
+	{
+		return false;
+	}
+
+	*aArgument = 0;
+
+	while (count-- > 0)
+	{
+		*aArgument = (*aArgument << 8) | aReader->data[aReader->offset++];
+	}
+
+	return true;
+}
+
+static bool senmlGetText(senmlReader_t *aReader, uint8_t aMajor, uint8_t aInfo, uint64_t aArgument,
+                         const char **aText, uint8_t *aLength)
+{
+	if (aMajor != CBOR_MAJOR_TEXT || aInfo == CBOR_INFO_INDEFINITE || aArgument > 0xff ||
+	    aArgument > (uint64_t)(aReader->length - aReader->offset))
+	{
+		return false;
+	}
+
+	*aText = (const char *)&aReader->data[aReader->offset];
+	*aLength = (uint8_t)aArgument;
+	aReader->offset += (uint16_t)aArgument;
+
+	return true;
+}
+
+static bool senmlGetNumber(uint8_t aMajor, uint8_t aInfo, uint64_t aArgument, int32_t *aValue)
+{
+	double value;
+
+	if (aInfo == CBOR_INFO_INDEFINITE)
+	{
+		return false;
+	}
+
+	switch (aMajor)
+	{
+	case CBOR_MAJOR_UINT:
+		value = (double)aArgument;
+		break;
+
+	case CBOR_MAJOR_NINT:
+		value = -1.0 - (double)aArgument;
+		break;
+
+	case CBOR_MAJOR_SIMPLE:
+		if (aInfo == CBOR_INFO_HALF)
+		{
+			uint16_t exponent = (aArgument >> 10) & 0x1f;
+			uint16_t mantissa = aArgument & 0x3ff;
+
+			if (exponent == 0x1f)
+			{
+				return false;
+			}
+
+			// 2^-24 and 2^-25 scale the subnormal and normal significands, no libm needed
+			value = (exponent == 0) ? mantissa / 16777216.0
+			                        : (double)(mantissa + 0x400) * (double)(1UL << exponent) / 33554432.0;
+			value = (aArgument & 0x8000) ? -value : value;
+		}
+		else if (aInfo == CBOR_INFO_FLOAT)
+		{
+			uint32_t bits = (uint32_t)aArgument;
+			float single;
+
+			memcpy(&single, &bits, sizeof(single));
+			value = single;
+		}
+		else if (aInfo == CBOR_INFO_DOUBLE)
+		{
+			memcpy(&value, &aArgument, sizeof(value));
+		}
+		else
+		{
+			return false;
+		}
+		break;
+
+	default:
+		return false;
+	}
+
+	// rejects NaN too
+	if (!(value > -2147483649.0 && value < 2147483648.0))
+	{
+		return false;
+	}
+
+	*aValue = (int32_t)value;
+	return true;
+}
+
+static bool senmlGetField(senmlReader_t *aReader, senmlRecord_t *aRecord)
+{
+	uint8_t major;
+	uint8_t info;
+	uint64_t argument;
+	int32_t label;
+
+	if (!senmlGetHead(aReader, &major, &info, &argument) || !senmlGetNumber(major, info, argument, &label) ||
+	    major == CBOR_MAJOR_SIMPLE || !senmlGetHead(aReader, &major, &info, &argument))
+	{
+		return false;
+	}
+
+	switch (label)
+	{
+	case senmlLabel_BaseName:
+		return senmlGetText(aReader, major, info, argument, &aReader->baseName, &aReader->baseNameLength);
+
+	case senmlLabel_Name:
+		return senmlGetText(aReader, major, info, argument, &aRecord->name, &aRecord->nameLength);
+
+	case senmlLabel_StringValue:
+		aRecord->valueType = senmlValue_String;
+		return senmlGetText(aReader, major, info, argument, &aRecord->stringValue, &aRecord->stringValueLength);
+
+	case senmlLabel_Value:
+		aRecord->valueType = senmlValue_Number;
+		return senmlGetNumber(major, info, argument, &aRecord->value);
+
+	case senmlLabel_BoolValue:
+		aRecord->valueType = senmlValue_Bool;
+		aRecord->value = (info == CBOR_INFO_TRUE);
+		return major == CBOR_MAJOR_SIMPLE && (info == CBOR_INFO_TRUE || info == CBOR_INFO_FALSE);
+
+	default:
+		break;
+	}
+
+	// other fields (times, units, sums...) are scalars or strings and are skipped
+	if (major == CBOR_MAJOR_BYTES || major == CBOR_MAJOR_TEXT)
+	{
+		if (info == CBOR_INFO_INDEFINITE || argument > (uint64_t)(aReader->length - aReader->offset))
+		{
+			return false;
+		}
+
+		aReader->offset += (uint16_t)argument;
+		return true;
+	}
+
+	return info != CBOR_INFO_INDEFINITE &&
+	       (major == CBOR_MAJOR_UINT || major == CBOR_MAJOR_NINT || major == CBOR_MAJOR_SIMPLE);
+}
+
+static bool senmlAtBreak(senmlReader_t *aReader)
+{
+	if (aReader->offset < aReader->length && aReader->data[aReader->offset] == CBOR_BREAK)
+	{
+		aReader->offset++;
+		return true;
+	}
+
+	return false;
+}
+
+bool senmlReaderInit(senmlReader_t *aReader, const uint8_t *aData, uint16_t aLength)
+{
+	uint8_t major;
+	uint8_t info;
+	uint64_t argument;
+
+	aReader->data = aData;
+	aReader->length = aLength;
+	aReader->offset = 0;
+	aReader->remaining = 0;
+	aReader->baseName = NULL;
+	aReader->baseNameLength = 0;
+	aReader->valid = false;
+
+	if (!senmlGetHead(aReader, &major, &info, &argument) || major != CBOR_MAJOR_ARRAY || argument >= SENML_INDEFINITE)
+	{
+		return false;
+	}
+
+	aReader->remaining = (info == CBOR_INFO_INDEFINITE) ? SENML_INDEFINITE : (uint16_t)argument;
+	aReader->valid = true;
+
+	return true;
+}
+
+bool senmlReadRecord(senmlReader_t *aReader, senmlRecord_t *aRecord)
+{
+	uint8_t major;
+	uint8_t info;
+	uint64_t argument;
+	uint16_t fields;
+
+	if (!aReader->valid || aReader->remaining == 0)
+	{
+		return false;
+	}
+
+	if (aReader->remaining == SENML_INDEFINITE)
+	{
+		if (senmlAtBreak(aReader))
+		{
+			aReader->remaining = 0;
+			return false;
+		}
+	}
+	else
+	{
+		aReader->remaining--;
+	}
+
+	memset(aRecord, 0, sizeof(*aRecord));
+
+	if (!senmlGetHead(aReader, &major, &info, &argument) || major != CBOR_MAJOR_MAP || argument >= SENML_INDEFINITE)
+	{
+		goto error;
+	}
+
+	fields = (info == CBOR_INFO_INDEFINITE) ? SENML_INDEFINITE : (uint16_t)argument;
+
+	while (fields != 0)
+	{
+		if (fields == SENML_INDEFINITE)
+		{
+			if (senmlAtBreak(aReader))
+			{
+				break;
+			}
+		}
+		else
+		{
+			fields--;
+		}
+
+		if (!senmlGetField(aReader, aRecord))
+		{
+			goto error;
+		}
+	}
+
+	aRecord->baseName = aReader->baseName;
+	aRecord->baseNameLength = aReader->baseNameLength;
+
+	return true;
+
+error:
+	aReader->valid = false;
+	return false;
+}
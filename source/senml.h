@@ -0,0 +1,78 @@
+/*
+ * senml.h
+ *
+ *  Minimal SenML (RFC 8428) CBOR encoder and decoder for the demo application.
+ *  Records use the integer labels of the CBOR representation and definite
+ *  length containers; times are relative (negative seconds into the past).
+ */
+
+#ifndef SENML_H_
+#define SENML_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+	senmlLabel_BaseTime = -3,
+	senmlLabel_BaseName = -2,
+	senmlLabel_Name = 0,
+	senmlLabel_Unit = 1,
+	senmlLabel_Value = 2,
+	senmlLabel_StringValue = 3,
+	senmlLabel_BoolValue = 4,
+	senmlLabel_Time = 6
+} senmlLabel_t;
+
+typedef enum
+{
+	senmlValue_None,
+	senmlValue_Number,
+	senmlValue_Bool,
+	senmlValue_String
+} senmlValueType_t;
+
+typedef struct
+{
+	uint8_t *buffer;
+	uint16_t size;
+	uint16_t length; /* keeps counting past size, see senmlWriterIsValid() */
+} senmlWriter_t;
+
+/* One decoded record; strings point into the decoded payload. */
+typedef struct
+{
+	const char *baseName; /* the base name in effect for this record */
+	const char *name;
+	const char *stringValue;
+	uint8_t baseNameLength;
+	uint8_t nameLength;
+	uint8_t stringValueLength;
+	senmlValueType_t valueType;
+	int32_t value; /* number (truncated) or bool */
+} senmlRecord_t;
+
+typedef struct
+{
+	const uint8_t *data;
+	uint16_t length;
+	uint16_t offset;
+	uint16_t remaining; /* records left, SENML_INDEFINITE for an indefinite array */
+	const char *baseName;
+	uint8_t baseNameLength;
+	bool valid; /* cleared on a malformed payload */
+} senmlReader_t;
+
+#define SENML_INDEFINITE 0xffff
+
+void senmlWriterInit(senmlWriter_t *aWriter, uint8_t *aBuffer, uint16_t aSize, uint8_t aRecordCount);
+void senmlWriteRecord(senmlWriter_t *aWriter, uint8_t aFieldCount);
+void senmlWriteText(senmlWriter_t *aWriter, senmlLabel_t aLabel, const char *aText);
+void senmlWriteInt(senmlWriter_t *aWriter, senmlLabel_t aLabel, int32_t aValue);
+void senmlWriteBool(senmlWriter_t *aWriter, senmlLabel_t aLabel, bool aValue);
+bool senmlWriterIsValid(const senmlWriter_t *aWriter);
+
+bool senmlReaderInit(senmlReader_t *aReader, const uint8_t *aData, uint16_t aLength);
+bool senmlReadRecord(senmlReader_t *aReader, senmlRecord_t *aRecord);
+
+#endif /* SENML_H_ */
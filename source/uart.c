@@ -30,33 +30,45 @@
  * @file
  *   This file implements the OpenThread platform abstraction for UART communication.
  *
+ *   Transmitted data is queued in a ring buffer which is drained by eDMA, so
+ *   otPlatUartSend() does not have to wait for the previous output to leave the wire.
+ *
  */
 
 #include "fsl_device_registers.h"
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <utils/code_utils.h>
 #include "openthread/platform/uart.h"
 #include "openthread/error.h"
 
 #include "fsl_clock.h"
+#include "fsl_dmamux.h"
+#include "fsl_edma.h"
 #include "fsl_lpuart.h"
+#include "fsl_lpuart_edma.h"
 #include "fsl_port.h"
+#include "platform.h"
 #define ENABLE_RTT
 enum
 {
     kPlatformClock     = 32000000,
     kBaudRate          = 115200,
-    kReceiveBufferSize = 256,
+    kReceiveBufferSize  = 256,
+    kTransmitBufferSize = 512,
+    kTransmitDmaChannel = 0,
 };
 
 static void processReceive();
 static void processTransmit();
+static void queueTransmit(void);
+static void startTransmit(void);
 
+/* Data passed to otPlatUartSend() that did not fit into the transmit ring yet */
 static const uint8_t *sTransmitBuffer = NULL;
 static uint16_t       sTransmitLength = 0;
-static bool           sTransmitDone   = false;
 
 typedef struct RecvBuffer
 {
@@ -70,12 +82,36 @@ typedef struct RecvBuffer
 
 static RecvBuffer sReceive;
 
+typedef struct SendBuffer
+{
+    // The data buffer
+    uint8_t mBuffer[kTransmitBufferSize];
+    // The offset of the first byte not yet sent.
+    volatile uint16_t mHead;
+    // The number of bytes queued, including the ones owned by DMA.
+    volatile uint16_t mLength;
+    // The number of bytes owned by the running DMA transfer.
+    volatile uint16_t mSending;
+} SendBuffer;
+
+static SendBuffer           sTransmit;
+static edma_handle_t        sTransmitDmaHandle;
+static lpuart_edma_handle_t sUartDmaHandle;
+
+static void transmitDmaCallback(LPUART_Type *aBase, lpuart_edma_handle_t *aHandle, status_t aStatus, void *aUserData);
+
 otError otPlatUartEnable(void)
 {
     lpuart_config_t config;
+    edma_config_t   dmaConfig;
 
-    sReceive.mHead = 0;
-    sReceive.mTail = 0;
+    sReceive.mHead     = 0;
+    sReceive.mTail     = 0;
+    sTransmit.mHead    = 0;
+    sTransmit.mLength  = 0;
+    sTransmit.mSending = 0;
+    sTransmitBuffer    = NULL;
+    sTransmitLength    = 0;
 
     /* Pin MUX */
     CLOCK_EnableClock(kCLOCK_PortC);
@@ -95,6 +131,15 @@ otError otPlatUartEnable(void)
     LPUART_Init(LPUART0, &config, kPlatformClock);
     LPUART_EnableInterrupts(LPUART0, kLPUART_RxDataRegFullInterruptEnable);
 
+    /* Route LPUART0 TX requests to the eDMA channel */
+    DMAMUX_Init(DMAMUX0);
+    DMAMUX_SetSource(DMAMUX0, kTransmitDmaChannel, kDmaRequestMux0LPUART0Tx);
+    DMAMUX_EnableChannel(DMAMUX0, kTransmitDmaChannel);
+    EDMA_GetDefaultConfig(&dmaConfig);
+    EDMA_Init(DMA0, &dmaConfig);
+    EDMA_CreateHandle(&sTransmitDmaHandle, DMA0, kTransmitDmaChannel);
+    LPUART_TransferCreateHandleEDMA(LPUART0, &sUartDmaHandle, transmitDmaCallback, NULL, &sTransmitDmaHandle, NULL);
+
     NVIC_ClearPendingIRQ(LPUART0_IRQn);
     NVIC_EnableIRQ(LPUART0_IRQn);
 
@@ -104,6 +149,8 @@ otError otPlatUartEnable(void)
 otError otPlatUartDisable(void)
 {
     NVIC_DisableIRQ(LPUART0_IRQn);
+    LPUART_TransferAbortSendEDMA(LPUART0, &sUartDmaHandle);
+    sTransmit.mSending = 0;
     return OT_ERROR_NONE;
 }
 
@@ -113,29 +160,134 @@ otError otPlatUartSend(const uint8_t *aBuf, uint16_t aBufLength)
 
     otEXPECT_ACTION(sTransmitBuffer == NULL, error = OT_ERROR_BUSY);
 
-    sTransmitBuffer = aBuf + 1;
-    sTransmitLength = aBufLength - 1;
-    sTransmitDone   = false;
-    LPUART_WriteByte(LPUART0, *aBuf);
-    LPUART_ClearStatusFlags(LPUART0, kLPUART_TxDataRegEmptyFlag);
-    LPUART_EnableInterrupts(LPUART0, kLPUART_TxDataRegEmptyInterruptEnable);
+    sTransmitBuffer = aBuf;
+    sTransmitLength = aBufLength;
+
+    /* Queue as much as fits now, otPlatUartSendDone() is reported from kw41zUartProcess() */
+    queueTransmit();
+    PlatformEventSignalPending();
 
 exit:
     return error;
 }
 
+static void queueTransmit(void)
+{
+    uint16_t head;
+    uint16_t length;
+    uint16_t tail;
+    uint16_t count;
+    uint32_t primask;
+
+    otEXPECT(sTransmitBuffer != NULL);
+
+    while (sTransmitLength > 0)
+    {
+        /* The DMA callback moves mHead and mLength in two stores, read them as a pair */
+        primask = DisableGlobalIRQ();
+        head    = sTransmit.mHead;
+        length  = sTransmit.mLength;
+        EnableGlobalIRQ(primask);
+
+        if (length >= kTransmitBufferSize)
+        {
+            break;
+        }
+
+        tail  = (head + length) % kTransmitBufferSize;
+        count = kTransmitBufferSize - length;
+
+        /* Copy up to the end of the ring, the next pass wraps around */
+        if (count > kTransmitBufferSize - tail)
+        {
+            count = kTransmitBufferSize - tail;
+        }
+
+        if (count > sTransmitLength)
+        {
+            count = sTransmitLength;
+        }
+
+        memcpy(&sTransmit.mBuffer[tail], sTransmitBuffer, count);
+        sTransmitBuffer += count;
+        sTransmitLength -= count;
+
+        primask = DisableGlobalIRQ();
+        sTransmit.mLength += count;
+        EnableGlobalIRQ(primask);
+    }
+
+    primask = DisableGlobalIRQ();
+    startTransmit();
+    EnableGlobalIRQ(primask);
+
+exit:
+    return;
+}
+
+/* Must be called with interrupts disabled */
+static void startTransmit(void)
+{
+    lpuart_transfer_t xfer;
+    uint16_t          count;
+
+    if (sTransmit.mSending == 0 && sTransmit.mLength > 0)
+    {
+        count = sTransmit.mLength;
+
+        /* DMA sends a contiguous segment, the wrapped part goes in the next transfer */
+        if (count > kTransmitBufferSize - sTransmit.mHead)
+        {
+            count = kTransmitBufferSize - sTransmit.mHead;
+        }
+
+        xfer.data     = &sTransmit.mBuffer[sTransmit.mHead];
+        xfer.dataSize = count;
+
+        if (LPUART_SendEDMA(LPUART0, &sUartDmaHandle, &xfer) == kStatus_Success)
+        {
+            sTransmit.mSending = count;
+        }
+    }
+}
+
 static void processTransmit(void)
 {
-    if (sTransmitBuffer && sTransmitDone)
+    otEXPECT(sTransmitBuffer != NULL);
+
+    queueTransmit();
+
+    if (sTransmitLength == 0)
     {
-        sTransmitDone   = false;
         sTransmitBuffer = NULL;
         otPlatUartSendDone();
     }
 
+exit:
     return;
 }
 
+static void transmitDmaCallback(LPUART_Type *aBase, lpuart_edma_handle_t *aHandle, status_t aStatus, void *aUserData)
+{
+    (void)aBase;
+    (void)aHandle;
+    (void)aUserData;
+
+    if (aStatus == kStatus_LPUART_TxIdle)
+    {
+        sTransmit.mHead = (sTransmit.mHead + sTransmit.mSending) % kTransmitBufferSize;
+        sTransmit.mLength -= sTransmit.mSending;
+        sTransmit.mSending = 0;
+        startTransmit();
+
+        /* Ring space was released, pending output can be queued */
+        if (sTransmitBuffer != NULL)
+        {
+            PlatformEventSignalPending();
+        }
+    }
+}
+
 void kw41zUartProcess(void)
 {
     processReceive();
@@ -166,8 +318,8 @@ static void processReceive(void)
 
 void LPUART0_IRQHandler(void)
 {
-    uint32_t interrupts = LPUART_GetEnabledInterrupts(LPUART0);
-    uint8_t  rx_data;
+    uint8_t rx_data;
+    bool    signal = false;
 
     /* Check if data was received */
     while (LPUART_GetStatusFlags(LPUART0) & (kLPUART_RxDataRegFullFlag))
@@ -180,26 +332,17 @@ void LPUART0_IRQHandler(void)
             sReceive.mBuffer[sReceive.mTail] = rx_data;
             sReceive.mTail                   = (sReceive.mTail + 1) % kReceiveBufferSize;
         }
-    }
 
-    /* Check if data Tx has end */
-    if ((LPUART_GetStatusFlags(LPUART0) & kLPUART_TxDataRegEmptyFlag) &&
-        (interrupts & kLPUART_TxDataRegEmptyInterruptEnable))
-    {
-        if (sTransmitLength)
-        {
-            sTransmitLength--;
-            LPUART_WriteByte(LPUART0, *sTransmitBuffer++);
-        }
-        else if (!sTransmitDone)
-        {
-            sTransmitDone = true;
-            LPUART_DisableInterrupts(LPUART0, kLPUART_TxDataRegEmptyInterruptEnable);
-        }
+        signal = true;
     }
 
     if (LPUART_GetStatusFlags(LPUART0) & kLPUART_RxOverrunFlag)
     {
         LPUART_ClearStatusFlags(LPUART0, kLPUART_RxOverrunFlag);
     }
+
+    if (signal)
+    {
+        PlatformEventSignalPending();
+    }
 }
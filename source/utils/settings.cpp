@@ -107,14 +107,322 @@ struct settingsBlock
 #define SETTINGS_CONFIG_PAGE_NUM 2
 #endif // SETTINGS_CONFIG_PAGE_NUM
 
+/**
+ * @def SETTINGS_CONFIG_AREA_PAGE_NUM
+ *
+ * The page number of one settings area. The settings region holds SETTINGS_CONFIG_PAGE_NUM /
+ * SETTINGS_CONFIG_AREA_PAGE_NUM areas which are used in turn, so erase cycles are spread over the whole region.
+ *
+ */
+#ifndef SETTINGS_CONFIG_AREA_PAGE_NUM
+#define SETTINGS_CONFIG_AREA_PAGE_NUM 1
+#endif // SETTINGS_CONFIG_AREA_PAGE_NUM
+
+/**
+ * @def SETTINGS_CONFIG_CHANGE_BUFFER_SIZE
+ *
+ * The size in bytes of the RAM buffer staging blocks between otPlatSettingsBeginChange() and
+ * otPlatSettingsCommitChange().
+ *
+ */
+#ifndef SETTINGS_CONFIG_CHANGE_BUFFER_SIZE
+#define SETTINGS_CONFIG_CHANGE_BUFFER_SIZE 256
+#endif // SETTINGS_CONFIG_CHANGE_BUFFER_SIZE
+
+#define SETTINGS_AREA_SIZE (SETTINGS_CONFIG_PAGE_SIZE * SETTINGS_CONFIG_AREA_PAGE_NUM)
+#define SETTINGS_AREA_NUM (SETTINGS_CONFIG_PAGE_NUM / SETTINGS_CONFIG_AREA_PAGE_NUM)
+
+#if (SETTINGS_AREA_NUM == 0) || (SETTINGS_CONFIG_PAGE_NUM % SETTINGS_CONFIG_AREA_PAGE_NUM) != 0
+#error "SETTINGS_CONFIG_PAGE_NUM must be a multiple of SETTINGS_CONFIG_AREA_PAGE_NUM"
+#endif
+
+#if SETTINGS_AREA_SIZE > 0x10000
+#error "SETTINGS_CONFIG_AREA_PAGE_NUM is too large for 16-bit block offsets"
+#endif
+
+/* Every block takes at least its 8-byte header, after the 4-byte area flag. */
+#define SETTINGS_INDEX_CAPACITY ((SETTINGS_AREA_SIZE - 4) / 8)
+
+/**
+ * @def SETTINGS_CONFIG_INDEX_SIZE
+ *
+ * The number of valid settings blocks tracked by the RAM index. It may not be smaller than the number of blocks one
+ * settings area can hold: a block left out of the index would be lost by the next compaction.
+ *
+ */
+#ifndef SETTINGS_CONFIG_INDEX_SIZE
+#define SETTINGS_CONFIG_INDEX_SIZE SETTINGS_INDEX_CAPACITY
+#endif // SETTINGS_CONFIG_INDEX_SIZE
+
+/**
+ * @def SETTINGS_CONFIG_INDEX_BUCKETS
+ *
+ * The number of hash buckets of the RAM index, keyed by settings key.
+ *
+ */
+#ifndef SETTINGS_CONFIG_INDEX_BUCKETS
+#define SETTINGS_CONFIG_INDEX_BUCKETS 16
+#endif // SETTINGS_CONFIG_INDEX_BUCKETS
+
+#if SETTINGS_CONFIG_INDEX_SIZE < SETTINGS_INDEX_CAPACITY
+#error "SETTINGS_CONFIG_INDEX_SIZE cannot hold every block of a settings area"
+#endif
+
+#if SETTINGS_CONFIG_INDEX_SIZE >= 0xffff
+#error "SETTINGS_CONFIG_INDEX_SIZE is too large for 16-bit index links"
+#endif
+
+#if (SETTINGS_CONFIG_CHANGE_BUFFER_SIZE % 4) != 0
+#error "SETTINGS_CONFIG_CHANGE_BUFFER_SIZE must be a multiple of 4"
+#endif
+
+enum
+{
+    kIndexNone = 0xffff,
+};
+
+struct settingsIndexEntry
+{
+    uint16_t key;
+    uint16_t offset;
+    uint16_t length : 15;
+    uint16_t superseded : 1; ///< Replaced by a staged index 0 block, kept until that block is in flash.
+    uint16_t next;           ///< Next entry of the same bucket (in flash order), or the next free entry.
+};
+
 static uint32_t sSettingsBaseAddress;
 static uint32_t sSettingsUsedSize;
 
+/* Valid blocks chained per key hash in flash order, so entries of one key appear in their index order. */
+static struct settingsIndexEntry sSettingsIndex[SETTINGS_CONFIG_INDEX_SIZE];
+static uint16_t                  sSettingsIndexHead[SETTINGS_CONFIG_INDEX_BUCKETS];
+static uint16_t                  sSettingsIndexTail[SETTINGS_CONFIG_INDEX_BUCKETS];
+static uint16_t                  sSettingsIndexFree;
+static uint16_t                  sSettingsIndexNum;
+
+/* Blocks staged by a change, logically placed right after sSettingsUsedSize. */
+static uint32_t sSettingsChangeBuffer[SETTINGS_CONFIG_CHANGE_BUFFER_SIZE / sizeof(uint32_t)];
+static uint16_t sSettingsChangeLength;
+static uint8_t  sSettingsChangeDepth;
+
 static uint16_t getAlignLength(uint16_t length)
 {
     return (length + 3) & 0xfffc;
 }
 
+static uint32_t getBlockSize(uint16_t aLength)
+{
+    return sizeof(struct settingsBlock) + getAlignLength(aLength);
+}
+
+static bool isBlockStaged(uint32_t aOffset)
+{
+    return aOffset >= sSettingsUsedSize;
+}
+
+static uint8_t *getStagedBlock(uint32_t aOffset)
+{
+    return reinterpret_cast<uint8_t *>(sSettingsChangeBuffer) + (aOffset - sSettingsUsedSize);
+}
+
+static void readSettings(uint32_t aOffset, uint8_t *aData, uint32_t aSize)
+{
+    if (isBlockStaged(aOffset))
+    {
+        memcpy(aData, getStagedBlock(aOffset), aSize);
+    }
+    else
+    {
+        utilsFlashRead(sSettingsBaseAddress + aOffset, aData, aSize);
+    }
+}
+
+static void writeBlockHeader(uint32_t aOffset, struct settingsBlock *aBlock)
+{
+    if (isBlockStaged(aOffset))
+    {
+        memcpy(getStagedBlock(aOffset), aBlock, sizeof(struct settingsBlock));
+    }
+    else
+    {
+        utilsFlashWrite(sSettingsBaseAddress + aOffset, reinterpret_cast<uint8_t *>(aBlock), sizeof(*aBlock));
+    }
+}
+
+static uint16_t getSettingBucket(uint16_t aKey)
+{
+    return aKey % SETTINGS_CONFIG_INDEX_BUCKETS;
+}
+
+static void resetSettingsIndex(void)
+{
+    for (uint16_t bucket = 0; bucket < SETTINGS_CONFIG_INDEX_BUCKETS; bucket++)
+    {
+        sSettingsIndexHead[bucket] = kIndexNone;
+        sSettingsIndexTail[bucket] = kIndexNone;
+    }
+
+    for (uint16_t pos = 0; pos < SETTINGS_CONFIG_INDEX_SIZE; pos++)
+    {
+        sSettingsIndex[pos].next = pos + 1;
+    }
+
+    sSettingsIndex[SETTINGS_CONFIG_INDEX_SIZE - 1].next = kIndexNone;
+
+    sSettingsIndexFree = 0;
+    sSettingsIndexNum  = 0;
+}
+
+static uint16_t findSettingIndex(uint16_t aKey, int aIndex)
+{
+    uint16_t pos;
+
+    for (pos = sSettingsIndexHead[getSettingBucket(aKey)]; pos != kIndexNone; pos = sSettingsIndex[pos].next)
+    {
+        if (sSettingsIndex[pos].key == aKey && !sSettingsIndex[pos].superseded)
+        {
+            if (aIndex == 0)
+            {
+                break;
+            }
+
+            aIndex--;
+        }
+    }
+
+    return pos;
+}
+
+/* aPrev is the entry before aPos in its bucket, kIndexNone for the bucket head. */
+static void unlinkSettingIndex(uint16_t aPos, uint16_t aPrev)
+{
+    uint16_t bucket = getSettingBucket(sSettingsIndex[aPos].key);
+
+    if (aPrev == kIndexNone)
+    {
+        sSettingsIndexHead[bucket] = sSettingsIndex[aPos].next;
+    }
+    else
+    {
+        sSettingsIndex[aPrev].next = sSettingsIndex[aPos].next;
+    }
+
+    if (sSettingsIndexTail[bucket] == aPos)
+    {
+        sSettingsIndexTail[bucket] = aPrev;
+    }
+
+    sSettingsIndex[aPos].next = sSettingsIndexFree;
+    sSettingsIndexFree        = aPos;
+    sSettingsIndexNum--;
+}
+
+static void removeSettingIndex(uint16_t aPos, uint16_t aPrev)
+{
+    uint32_t offset = sSettingsIndex[aPos].offset;
+
+    // a staged block is dropped from the change buffer as well, and later staged blocks move down
+    if (isBlockStaged(offset))
+    {
+        uint32_t size   = getBlockSize(sSettingsIndex[aPos].length);
+        uint8_t *staged = getStagedBlock(offset);
+
+        sSettingsChangeLength -= size;
+        memmove(staged, staged + size, sSettingsChangeLength - (offset - sSettingsUsedSize));
+
+        for (uint16_t b = 0; b < SETTINGS_CONFIG_INDEX_BUCKETS; b++)
+        {
+            for (uint16_t pos = sSettingsIndexHead[b]; pos != kIndexNone; pos = sSettingsIndex[pos].next)
+            {
+                if (sSettingsIndex[pos].offset > offset)
+                {
+                    sSettingsIndex[pos].offset -= size;
+                }
+            }
+        }
+    }
+
+    unlinkSettingIndex(aPos, aPrev);
+}
+
+static void removeSettingKeyIndex(uint16_t aKey)
+{
+    uint16_t prev = kIndexNone;
+    uint16_t pos  = sSettingsIndexHead[getSettingBucket(aKey)];
+
+    while (pos != kIndexNone)
+    {
+        uint16_t next = sSettingsIndex[pos].next;
+
+        if (sSettingsIndex[pos].key == aKey)
+        {
+            removeSettingIndex(pos, prev);
+        }
+        else
+        {
+            prev = pos;
+        }
+
+        pos = next;
+    }
+}
+
+/* Drops the staged blocks of aKey, while its blocks in flash stay indexed so a swap still copies them. */
+static void supersedeSettingKeyIndex(uint16_t aKey)
+{
+    uint16_t prev = kIndexNone;
+    uint16_t pos  = sSettingsIndexHead[getSettingBucket(aKey)];
+
+    while (pos != kIndexNone)
+    {
+        uint16_t next = sSettingsIndex[pos].next;
+
+        if (sSettingsIndex[pos].key == aKey && isBlockStaged(sSettingsIndex[pos].offset))
+        {
+            removeSettingIndex(pos, prev);
+        }
+        else
+        {
+            if (sSettingsIndex[pos].key == aKey)
+            {
+                sSettingsIndex[pos].superseded = true;
+            }
+
+            prev = pos;
+        }
+
+        pos = next;
+    }
+}
+
+static void appendSettingIndex(uint16_t aKey, uint32_t aOffset, uint16_t aLength)
+{
+    uint16_t bucket = getSettingBucket(aKey);
+    uint16_t pos    = sSettingsIndexFree;
+
+    assert(pos != kIndexNone);
+
+    sSettingsIndexFree       = sSettingsIndex[pos].next;
+    sSettingsIndex[pos].key    = aKey;
+    sSettingsIndex[pos].offset = static_cast<uint16_t>(aOffset);
+    sSettingsIndex[pos].length     = aLength;
+    sSettingsIndex[pos].superseded = false;
+    sSettingsIndex[pos].next       = kIndexNone;
+
+    // blocks are always appended in flash order, so the tail keeps each key's entries ordered
+    if (sSettingsIndexTail[bucket] == kIndexNone)
+    {
+        sSettingsIndexHead[bucket] = pos;
+    }
+    else
+    {
+        sSettingsIndex[sSettingsIndexTail[bucket]].next = pos;
+    }
+
+    sSettingsIndexTail[bucket] = pos;
+    sSettingsIndexNum++;
+}
+
 static void setSettingsFlag(uint32_t aBase, uint32_t aFlag)
 {
     utilsFlashWrite(aBase, reinterpret_cast<uint8_t *>(&aFlag), sizeof(aFlag));
@@ -122,11 +430,9 @@ static void setSettingsFlag(uint32_t aBase, uint32_t aFlag)
 
 static void initSettings(uint32_t aBase, uint32_t aFlag)
 {
-    uint32_t address      = aBase;
-    uint32_t settingsSize = SETTINGS_CONFIG_PAGE_NUM > 1 ? SETTINGS_CONFIG_PAGE_SIZE * SETTINGS_CONFIG_PAGE_NUM / 2
-                                                         : SETTINGS_CONFIG_PAGE_SIZE;
+    uint32_t address = aBase;
 
-    while (address < (aBase + settingsSize))
+    while (address < (aBase + SETTINGS_AREA_SIZE))
     {
         utilsFlashErasePage(address);
         utilsFlashStatusWait(1000);
@@ -136,79 +442,174 @@ static void initSettings(uint32_t aBase, uint32_t aFlag)
     setSettingsFlag(aBase, aFlag);
 }
 
+static void buildSettingsIndex(void)
+{
+    sSettingsUsedSize     = kSettingsFlagSize;
+    sSettingsChangeLength = 0;
+    resetSettingsIndex();
+
+    while (sSettingsUsedSize + sizeof(struct settingsBlock) <= SETTINGS_AREA_SIZE)
+    {
+        struct settingsBlock block;
+
+        utilsFlashRead(sSettingsBaseAddress + sSettingsUsedSize, reinterpret_cast<uint8_t *>(&block), sizeof(block));
+
+        if (block.flag & kBlockAddBeginFlag)
+        {
+            break;
+        }
+
+        if (!(block.flag & kBlockAddCompleteFlag))
+        {
+            // a new index 0 block supersedes all earlier blocks of the same key, even once it is deleted itself
+            if (!(block.flag & kBlockIndex0Flag))
+            {
+                removeSettingKeyIndex(block.key);
+            }
+
+            // the index holds as many entries as the area holds blocks, none can be left out
+            if (block.flag & kBlockDeleteFlag)
+            {
+                appendSettingIndex(block.key, sSettingsUsedSize, block.length);
+            }
+        }
+
+        sSettingsUsedSize += getBlockSize(block.length);
+    }
+}
+
 static uint32_t swapSettingsBlock(otInstance *aInstance)
 {
-    uint32_t oldBase      = sSettingsBaseAddress;
-    uint32_t swapAddress  = oldBase;
-    uint32_t usedSize     = sSettingsUsedSize;
-    uint8_t  pageNum      = SETTINGS_CONFIG_PAGE_NUM;
-    uint32_t settingsSize = pageNum > 1 ? SETTINGS_CONFIG_PAGE_SIZE * pageNum / 2 : SETTINGS_CONFIG_PAGE_SIZE;
+    uint32_t oldBase = sSettingsBaseAddress;
+    uint32_t oldUsed = sSettingsUsedSize;
 
     (void)aInstance;
 
-    otEXPECT(pageNum > 1);
+    otEXPECT(SETTINGS_AREA_NUM > 1);
 
-    sSettingsBaseAddress =
-        (swapAddress == SETTINGS_CONFIG_BASE_ADDRESS) ? (swapAddress + settingsSize) : SETTINGS_CONFIG_BASE_ADDRESS;
+    // areas are used round robin so each one is erased once per SETTINGS_AREA_NUM swaps
+    sSettingsBaseAddress = oldBase + SETTINGS_AREA_SIZE;
+
+    if (sSettingsBaseAddress >= SETTINGS_CONFIG_BASE_ADDRESS + SETTINGS_AREA_SIZE * SETTINGS_AREA_NUM)
+    {
+        sSettingsBaseAddress = SETTINGS_CONFIG_BASE_ADDRESS;
+    }
 
     initSettings(sSettingsBaseAddress, static_cast<uint32_t>(kSettingsInSwap));
     sSettingsUsedSize = kSettingsFlagSize;
-    swapAddress += kSettingsFlagSize;
 
-    while (swapAddress < (oldBase + usedSize))
+    // the index only holds valid blocks, so each one is copied exactly once; each bucket is copied in its own
+    // order, which keeps the entries of every key in their index order
+    for (uint16_t bucket = 0; bucket < SETTINGS_CONFIG_INDEX_BUCKETS; bucket++)
     {
-        OT_TOOL_PACKED_BEGIN
-        struct addSettingsBlock
+        for (uint16_t pos = sSettingsIndexHead[bucket]; pos != kIndexNone; pos = sSettingsIndex[pos].next)
         {
-            struct settingsBlock block;
-            uint8_t              data[kSettingsBlockDataSize];
-        } OT_TOOL_PACKED_END addBlock;
-        bool                 valid = true;
-
-        utilsFlashRead(swapAddress, reinterpret_cast<uint8_t *>(&addBlock.block), sizeof(struct settingsBlock));
-        swapAddress += sizeof(struct settingsBlock);
-
-        if (!(addBlock.block.flag & kBlockAddCompleteFlag) && (addBlock.block.flag & kBlockDeleteFlag))
-        {
-            uint32_t address = swapAddress + getAlignLength(addBlock.block.length);
-
-            while (address < (oldBase + usedSize))
+            OT_TOOL_PACKED_BEGIN
+            struct addSettingsBlock
             {
                 struct settingsBlock block;
+                uint8_t              data[kSettingsBlockDataSize];
+            } OT_TOOL_PACKED_END addBlock;
+            struct settingsIndexEntry *entry = &sSettingsIndex[pos];
+            uint32_t                   size  = getBlockSize(entry->length);
 
-                utilsFlashRead(address, reinterpret_cast<uint8_t *>(&block), sizeof(block));
+            if (entry->offset >= oldUsed)
+            {
+                continue;
+            }
 
-                if (!(block.flag & kBlockAddCompleteFlag) && (block.flag & kBlockDeleteFlag) &&
-                    !(block.flag & kBlockIndex0Flag) && (block.key == addBlock.block.key))
-                {
-                    valid = false;
-                    break;
-                }
+            utilsFlashRead(oldBase + entry->offset, reinterpret_cast<uint8_t *>(&addBlock), size);
+            utilsFlashWrite(sSettingsBaseAddress + sSettingsUsedSize, reinterpret_cast<uint8_t *>(&addBlock), size);
+            entry->offset = static_cast<uint16_t>(sSettingsUsedSize);
+            sSettingsUsedSize += size;
+        }
+    }
 
-                address += (getAlignLength(block.length) + sizeof(struct settingsBlock));
-            }
+    // staged blocks just follow the copied ones
+    for (uint16_t bucket = 0; bucket < SETTINGS_CONFIG_INDEX_BUCKETS; bucket++)
+    {
+        for (uint16_t pos = sSettingsIndexHead[bucket]; pos != kIndexNone; pos = sSettingsIndex[pos].next)
+        {
+            struct settingsIndexEntry *entry = &sSettingsIndex[pos];
 
-            if (valid)
+            if (entry->offset >= oldUsed)
             {
-                utilsFlashRead(swapAddress, addBlock.data, getAlignLength(addBlock.block.length));
-                utilsFlashWrite(sSettingsBaseAddress + sSettingsUsedSize, reinterpret_cast<uint8_t *>(&addBlock),
-                                getAlignLength(addBlock.block.length) + sizeof(struct settingsBlock));
-                sSettingsUsedSize += (sizeof(struct settingsBlock) + getAlignLength(addBlock.block.length));
+                entry->offset = static_cast<uint16_t>(sSettingsUsedSize + (entry->offset - oldUsed));
             }
         }
-        else if (addBlock.block.flag == 0xff)
-        {
-            break;
-        }
-
-        swapAddress += getAlignLength(addBlock.block.length);
     }
 
     setSettingsFlag(sSettingsBaseAddress, static_cast<uint32_t>(kSettingsInUse));
     setSettingsFlag(oldBase, static_cast<uint32_t>(kSettingsNotUse));
 
 exit:
-    return settingsSize - sSettingsUsedSize;
+    return SETTINGS_AREA_SIZE - sSettingsUsedSize;
+}
+
+static otError reserveSettings(otInstance *aInstance, uint32_t aSize)
+{
+    otError error = OT_ERROR_NONE;
+
+    if ((sSettingsUsedSize + aSize) >= SETTINGS_AREA_SIZE)
+    {
+        otEXPECT_ACTION(swapSettingsBlock(aInstance) >= aSize, error = OT_ERROR_NO_BUFS);
+    }
+
+exit:
+    return error;
+}
+
+static otError flushSettingsChange(otInstance *aInstance)
+{
+    otError  error  = OT_ERROR_NONE;
+    uint32_t offset = 0;
+
+    otEXPECT(sSettingsChangeLength > 0);
+    otEXPECT((error = reserveSettings(aInstance, sSettingsChangeLength)) == OT_ERROR_NONE);
+
+    // program all staged blocks at once, then mark each of them complete
+    utilsFlashWrite(sSettingsBaseAddress + sSettingsUsedSize, reinterpret_cast<uint8_t *>(sSettingsChangeBuffer),
+                    sSettingsChangeLength);
+
+    while (offset < sSettingsChangeLength)
+    {
+        struct settingsBlock *block =
+            reinterpret_cast<struct settingsBlock *>(reinterpret_cast<uint8_t *>(sSettingsChangeBuffer) + offset);
+
+        block->flag &= (~kBlockAddCompleteFlag);
+        utilsFlashWrite(sSettingsBaseAddress + sSettingsUsedSize + offset, reinterpret_cast<uint8_t *>(block),
+                        sizeof(struct settingsBlock));
+        offset += getBlockSize(block->length);
+    }
+
+    sSettingsUsedSize += sSettingsChangeLength;
+    sSettingsChangeLength = 0;
+
+    // the blocks replaced by staged ones are only dropped now that their replacements are in flash
+    for (uint16_t bucket = 0; bucket < SETTINGS_CONFIG_INDEX_BUCKETS; bucket++)
+    {
+        uint16_t prev = kIndexNone;
+        uint16_t pos  = sSettingsIndexHead[bucket];
+
+        while (pos != kIndexNone)
+        {
+            uint16_t next = sSettingsIndex[pos].next;
+
+            if (sSettingsIndex[pos].superseded)
+            {
+                unlinkSettingIndex(pos, prev);
+            }
+            else
+            {
+                prev = pos;
+            }
+
+            pos = next;
+        }
+    }
+
+exit:
+    return error;
 }
 
 static otError addSetting(otInstance *   aInstance,
@@ -224,8 +625,14 @@ static otError addSetting(otInstance *   aInstance,
         struct settingsBlock block;
         uint8_t              data[kSettingsBlockDataSize];
     } OT_TOOL_PACKED_END addBlock;
-    uint32_t settingsSize = SETTINGS_CONFIG_PAGE_NUM > 1 ? SETTINGS_CONFIG_PAGE_SIZE * SETTINGS_CONFIG_PAGE_NUM / 2
-                                                         : SETTINGS_CONFIG_PAGE_SIZE;
+    uint32_t size   = getBlockSize(aValueLength);
+    bool     staged = (sSettingsChangeDepth > 0 && size <= sizeof(sSettingsChangeBuffer));
+    uint16_t pos    = findSettingIndex(aKey, 0);
+
+    // a staged index 0 block only frees the staged entries of its key, the ones in flash stay until it is flushed
+    otEXPECT_ACTION(sSettingsIndexNum < SETTINGS_CONFIG_INDEX_SIZE ||
+                        (aIndex0 && pos != kIndexNone && (!staged || isBlockStaged(sSettingsIndex[pos].offset))),
+                    error = OT_ERROR_NO_BUFS);
 
     addBlock.block.flag = 0xff;
     addBlock.block.key  = aKey;
@@ -238,26 +645,52 @@ static otError addSetting(otInstance *   aInstance,
     addBlock.block.flag &= (~kBlockAddBeginFlag);
     addBlock.block.length = aValueLength;
 
-    if ((sSettingsUsedSize + getAlignLength(addBlock.block.length) + sizeof(struct settingsBlock)) >= settingsSize)
+    memset(addBlock.data, 0xff, kSettingsBlockDataSize);
+    memcpy(addBlock.data, aValue, addBlock.block.length);
+
+    if (staged)
     {
-        otEXPECT_ACTION(swapSettingsBlock(aInstance) >=
-                            (getAlignLength(addBlock.block.length) + sizeof(struct settingsBlock)),
-                        error = OT_ERROR_NO_BUFS);
+        // flush first: it drops the superseded blocks, which must survive until this block is in flash
+        if (sSettingsChangeLength + size > sizeof(sSettingsChangeBuffer))
+        {
+            otEXPECT((error = flushSettingsChange(aInstance)) == OT_ERROR_NONE);
+        }
+
+        // superseded staged blocks never reach flash
+        if (aIndex0)
+        {
+            supersedeSettingKeyIndex(aKey);
+        }
+
+        otEXPECT_ACTION(sSettingsIndexNum < SETTINGS_CONFIG_INDEX_SIZE, error = OT_ERROR_NO_BUFS);
+
+        memcpy(reinterpret_cast<uint8_t *>(sSettingsChangeBuffer) + sSettingsChangeLength, &addBlock, size);
+        appendSettingIndex(aKey, sSettingsUsedSize + sSettingsChangeLength, aValueLength);
+        sSettingsChangeLength += size;
     }
+    else
+    {
+        otEXPECT((error = flushSettingsChange(aInstance)) == OT_ERROR_NONE);
+        otEXPECT((error = reserveSettings(aInstance, size)) == OT_ERROR_NONE);
 
-    utilsFlashWrite(sSettingsBaseAddress + sSettingsUsedSize, reinterpret_cast<uint8_t *>(&addBlock.block),
-                    sizeof(struct settingsBlock));
+        utilsFlashWrite(sSettingsBaseAddress + sSettingsUsedSize, reinterpret_cast<uint8_t *>(&addBlock.block),
+                        sizeof(struct settingsBlock));
 
-    memset(addBlock.data, 0xff, kSettingsBlockDataSize);
-    memcpy(addBlock.data, aValue, addBlock.block.length);
+        utilsFlashWrite(sSettingsBaseAddress + sSettingsUsedSize + sizeof(struct settingsBlock),
+                        reinterpret_cast<uint8_t *>(addBlock.data), getAlignLength(addBlock.block.length));
 
-    utilsFlashWrite(sSettingsBaseAddress + sSettingsUsedSize + sizeof(struct settingsBlock),
-                    reinterpret_cast<uint8_t *>(addBlock.data), getAlignLength(addBlock.block.length));
+        addBlock.block.flag &= (~kBlockAddCompleteFlag);
+        utilsFlashWrite(sSettingsBaseAddress + sSettingsUsedSize, reinterpret_cast<uint8_t *>(&addBlock.block),
+                        sizeof(struct settingsBlock));
 
-    addBlock.block.flag &= (~kBlockAddCompleteFlag);
-    utilsFlashWrite(sSettingsBaseAddress + sSettingsUsedSize, reinterpret_cast<uint8_t *>(&addBlock.block),
-                    sizeof(struct settingsBlock));
-    sSettingsUsedSize += (sizeof(struct settingsBlock) + getAlignLength(addBlock.block.length));
+        if (aIndex0)
+        {
+            removeSettingKeyIndex(aKey);
+        }
+
+        appendSettingIndex(aKey, sSettingsUsedSize, aValueLength);
+        sSettingsUsedSize += size;
+    }
 
 exit:
     return error;
@@ -266,122 +699,124 @@ exit:
 // settings API
 void otPlatSettingsInit(otInstance *aInstance)
 {
-    uint8_t  index;
-    uint32_t settingsSize = SETTINGS_CONFIG_PAGE_NUM > 1 ? SETTINGS_CONFIG_PAGE_SIZE * SETTINGS_CONFIG_PAGE_NUM / 2
-                                                         : SETTINGS_CONFIG_PAGE_SIZE;
+    uint32_t inUseBase = 0;
+    bool     inUseFound = false;
 
     (void)aInstance;
 
-    sSettingsBaseAddress = SETTINGS_CONFIG_BASE_ADDRESS;
-
     utilsFlashInit();
 
-    for (index = 0; index < 2; index++)
+    for (uint8_t area = 0; area < SETTINGS_AREA_NUM; area++)
     {
+        uint32_t base = SETTINGS_CONFIG_BASE_ADDRESS + SETTINGS_AREA_SIZE * area;
         uint32_t blockFlag;
 
-        sSettingsBaseAddress += settingsSize * index;
-        utilsFlashRead(sSettingsBaseAddress, reinterpret_cast<uint8_t *>(&blockFlag), sizeof(blockFlag));
+        utilsFlashRead(base, reinterpret_cast<uint8_t *>(&blockFlag), sizeof(blockFlag));
 
-        if (blockFlag == kSettingsInUse)
+        if (blockFlag != kSettingsInUse)
         {
-            break;
+            continue;
         }
-    }
 
-    if (index == 2)
-    {
-        initSettings(sSettingsBaseAddress, static_cast<uint32_t>(kSettingsInUse));
-    }
-
-    sSettingsUsedSize = kSettingsFlagSize;
-
-    while (sSettingsUsedSize < settingsSize)
-    {
-        struct settingsBlock block;
-
-        utilsFlashRead(sSettingsBaseAddress + sSettingsUsedSize, reinterpret_cast<uint8_t *>(&block), sizeof(block));
-
-        if (!(block.flag & kBlockAddBeginFlag))
+        // a swap interrupted between its two flag writes leaves two identical areas in use
+        if (inUseFound)
         {
-            sSettingsUsedSize += (getAlignLength(block.length) + sizeof(struct settingsBlock));
+            setSettingsFlag(base, static_cast<uint32_t>(kSettingsNotUse));
         }
         else
         {
-            break;
+            inUseBase  = base;
+            inUseFound = true;
         }
     }
+
+    if (!inUseFound)
+    {
+        inUseBase = SETTINGS_CONFIG_BASE_ADDRESS;
+        initSettings(inUseBase, static_cast<uint32_t>(kSettingsInUse));
+    }
+
+    sSettingsBaseAddress = inUseBase;
+    sSettingsChangeDepth = 0;
+
+    buildSettingsIndex();
 }
 
 otError otPlatSettingsBeginChange(otInstance *aInstance)
 {
     (void)aInstance;
+
+    sSettingsChangeDepth++;
+
     return OT_ERROR_NONE;
 }
 
 otError otPlatSettingsCommitChange(otInstance *aInstance)
 {
-    (void)aInstance;
-    return OT_ERROR_NONE;
+    otError error = OT_ERROR_NONE;
+
+    otEXPECT_ACTION(sSettingsChangeDepth > 0, error = OT_ERROR_INVALID_STATE);
+
+    if (--sSettingsChangeDepth == 0)
+    {
+        error = flushSettingsChange(aInstance);
+
+        // the change is over either way, so a failed one is rolled back to what is in flash
+        if (error != OT_ERROR_NONE)
+        {
+            buildSettingsIndex();
+        }
+    }
+
+exit:
+    return error;
 }
 
 otError otPlatSettingsAbandonChange(otInstance *aInstance)
 {
+    otError error = OT_ERROR_NONE;
+
     (void)aInstance;
-    return OT_ERROR_NONE;
+
+    otEXPECT_ACTION(sSettingsChangeDepth > 0, error = OT_ERROR_INVALID_STATE);
+
+    // deletes of blocks already in flash are not staged and stay in effect
+    sSettingsChangeDepth = 0;
+    buildSettingsIndex();
+
+exit:
+    return error;
 }
 
 otError otPlatSettingsGet(otInstance *aInstance, uint16_t aKey, int aIndex, uint8_t *aValue, uint16_t *aValueLength)
 {
     otError  error       = OT_ERROR_NOT_FOUND;
-    uint32_t address     = sSettingsBaseAddress + kSettingsFlagSize;
     uint16_t valueLength = 0;
-    int      index       = 0;
+    uint16_t pos;
 
     (void)aInstance;
 
-    while (address < (sSettingsBaseAddress + sSettingsUsedSize))
-    {
-        struct settingsBlock block;
+    pos = findSettingIndex(aKey, aIndex);
+    otEXPECT(pos != kIndexNone);
 
-        utilsFlashRead(address, reinterpret_cast<uint8_t *>(&block), sizeof(block));
+    valueLength = sSettingsIndex[pos].length;
+    error       = OT_ERROR_NONE;
 
-        if (block.key == aKey)
-        {
-            if (!(block.flag & kBlockIndex0Flag))
-            {
-                index = 0;
-            }
-
-            if (!(block.flag & kBlockAddCompleteFlag) && (block.flag & kBlockDeleteFlag))
-            {
-                if (index == aIndex)
-                {
-                    uint16_t readLength = block.length;
-
-                    // only perform read if an input buffer was passed in
-                    if (aValue != NULL && aValueLength != NULL)
-                    {
-                        // adjust read length if input buffer length is smaller
-                        if (readLength > *aValueLength)
-                        {
-                            readLength = *aValueLength;
-                        }
-
-                        utilsFlashRead(address + sizeof(struct settingsBlock), aValue, readLength);
-                    }
-
-                    valueLength = block.length;
-                    error       = OT_ERROR_NONE;
-                }
+    // only perform read if an input buffer was passed in
+    if (aValue != NULL && aValueLength != NULL)
+    {
+        uint16_t readLength = valueLength;
 
-                index++;
-            }
+        // adjust read length if input buffer length is smaller
+        if (readLength > *aValueLength)
+        {
+            readLength = *aValueLength;
         }
 
-        address += (getAlignLength(block.length) + sizeof(struct settingsBlock));
+        readSettings(sSettingsIndex[pos].offset + sizeof(struct settingsBlock), aValue, readLength);
     }
 
+exit:
     if (aValueLength != NULL)
     {
         *aValueLength = valueLength;
@@ -397,54 +832,65 @@ otError otPlatSettingsSet(otInstance *aInstance, uint16_t aKey, const uint8_t *a
 
 otError otPlatSettingsAdd(otInstance *aInstance, uint16_t aKey, const uint8_t *aValue, uint16_t aValueLength)
 {
-    uint16_t length;
-    bool     index0;
+    bool index0 = (findSettingIndex(aKey, 0) == kIndexNone);
 
-    index0 = (otPlatSettingsGet(aInstance, aKey, 0, NULL, &length) == OT_ERROR_NOT_FOUND ? true : false);
     return addSetting(aInstance, aKey, index0, aValue, aValueLength);
 }
 
 otError otPlatSettingsDelete(otInstance *aInstance, uint16_t aKey, int aIndex)
 {
-    otError  error   = OT_ERROR_NOT_FOUND;
-    uint32_t address = sSettingsBaseAddress + kSettingsFlagSize;
-    int      index   = 0;
+    otError  error = OT_ERROR_NOT_FOUND;
+    uint16_t prev  = kIndexNone;
+    uint16_t pos   = sSettingsIndexHead[getSettingBucket(aKey)];
+    int      index = 0;
 
     (void)aInstance;
 
-    while (address < (sSettingsBaseAddress + sSettingsUsedSize))
+    while (pos != kIndexNone)
     {
+        uint16_t             next   = sSettingsIndex[pos].next;
+        uint32_t             offset = sSettingsIndex[pos].offset;
         struct settingsBlock block;
 
-        utilsFlashRead(address, reinterpret_cast<uint8_t *>(&block), sizeof(block));
+        if (sSettingsIndex[pos].key != aKey || sSettingsIndex[pos].superseded)
+        {
+            prev = pos;
+            pos  = next;
+            continue;
+        }
+
+        readSettings(offset, reinterpret_cast<uint8_t *>(&block), sizeof(block));
 
-        if (block.key == aKey)
+        if (aIndex == index || aIndex == -1)
         {
-            if (!(block.flag & kBlockIndex0Flag))
+            error = OT_ERROR_NONE;
+
+            if (isBlockStaged(offset) && (block.flag & kBlockIndex0Flag))
             {
-                index = 0;
+                removeSettingIndex(pos, prev);
             }
-
-            if (!(block.flag & kBlockAddCompleteFlag) && (block.flag & kBlockDeleteFlag))
+            else
             {
-                if (aIndex == index || aIndex == -1)
-                {
-                    error = OT_ERROR_NONE;
-                    block.flag &= (~kBlockDeleteFlag);
-                    utilsFlashWrite(address, reinterpret_cast<uint8_t *>(&block), sizeof(block));
-                }
-
-                if (index == 1 && aIndex == 0)
-                {
-                    block.flag &= (~kBlockIndex0Flag);
-                    utilsFlashWrite(address, reinterpret_cast<uint8_t *>(&block), sizeof(block));
-                }
-
-                index++;
+                // a staged index 0 block is kept, deleted, so it still supersedes the blocks it replaced in flash
+                block.flag &= (~kBlockDeleteFlag);
+                writeBlockHeader(offset, &block);
+                unlinkSettingIndex(pos, prev);
+            }
+        }
+        else
+        {
+            // the block following a deleted index 0 becomes the new index 0
+            if (index == 1 && aIndex == 0)
+            {
+                block.flag &= (~kBlockIndex0Flag);
+                writeBlockHeader(offset, &block);
             }
+
+            prev = pos;
         }
 
-        address += (getAlignLength(block.length) + sizeof(struct settingsBlock));
+        pos = next;
+        index++;
     }
 
     return error;